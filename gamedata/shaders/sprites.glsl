@@ -4,12 +4,18 @@
 
 // constants
 uniform mat4 view_projection_matrix;
+uniform int sprites_mode; // 0: per vertex data, 1: per instance data with y depth axis, 2: per instance data with z depth axis
 
 // attributes
-in vec3 in_pos0;
+in vec3 in_pos0; // vertex position or instance position on sprite plane and height
 in vec2 in_texcoord0;
 in int in_color0; // palette index
 
+// instance attributes
+in vec4 in_pos1; // corner offset and size
+in vec4 in_texcoord1; // texture region
+in vec2 in_normal0; // cos and sin of rotation angle
+
 // pass to fragment shader
 out vec2 Texcoord;
 out vec3 Position;
@@ -18,11 +24,28 @@ flat out int PaletteIndex;
 // entry point
 void main() 
 {
-	Texcoord = in_texcoord0;
-    Position = in_pos0;
+    if (sprites_mode == 0)
+    {
+        Texcoord = in_texcoord0;
+        Position = in_pos0;
+    }
+    else
+    {
+        // generate quad corner, vertices are drawn as triangle strip
+        vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+        vec2 cornerOffset = in_pos1.xy + corner * in_pos1.zw;
+        vec2 planePosition = in_pos0.xy + vec2(
+            cornerOffset.x * in_normal0.x - cornerOffset.y * in_normal0.y,
+            cornerOffset.x * in_normal0.y + cornerOffset.y * in_normal0.x);
+
+        Texcoord = mix(in_texcoord1.xy, in_texcoord1.zw, corner);
+        Position = (sprites_mode == 1) ? 
+            vec3(planePosition.x, in_pos0.z, planePosition.y) : 
+            vec3(planePosition.x, planePosition.y, in_pos0.z);
+    }
     PaletteIndex = in_color0;
 
-    vec4 vertexPosition = view_projection_matrix * vec4(in_pos0, 1.0f);
+    vec4 vertexPosition = view_projection_matrix * vec4(Position, 1.0f);
     gl_Position = vertexPosition;
 }
 
@@ -90,3 +90,7 @@ project "carnage3d"
 		defines { "NDEBUG" }
 		optimize "On"
 		libdirs { "third_party/Box2D/Build/bin/x86_64/Release" }
+
+	-- batched cars dynamics loop is vectorized by gcc only with full cost model and when sqrtf does not set errno
+	filter { "configurations:Release", "files:src/CarPhysicsBatch.cpp" }
+		buildoptions { "-ftree-vectorize", "-fvect-cost-model=dynamic", "-fno-math-errno" }
@@ -5,6 +5,7 @@
 #include "CarnageGame.h"
 #include "DebugRenderer.h"
 #include "BroadcastEventsManager.h"
+#include "AiManager.h"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -12,90 +13,6 @@
 
 //////////////////////////////////////////////////////////////////////////
 
-enum eMapDirection
-{
-    eMapDirection_N,
-    eMapDirection_E,
-    eMapDirection_S,
-    eMapDirection_W
-};
-
-inline eMapDirection GetMapDirectionFromHeading(float angleDegrees)
-{
-    static const std::pair<float, eMapDirection> Directions[] =
-    {
-        {360.0f, eMapDirection_E},
-        {  0.0f, eMapDirection_E},
-        { 90.0f, eMapDirection_S},
-        {180.0f, eMapDirection_W},
-        {270.0f, eMapDirection_N},
-    };
-
-    angleDegrees = cxx::normalize_angle_360(angleDegrees);
-
-    for (const auto& curr: Directions)
-    {
-        if (fabs(curr.first - angleDegrees) <= 45.0f)
-            return curr.second;
-    }
-    debug_assert(false);
-    return eMapDirection_E;
-}
-
-inline eMapDirection GetMapDirectionCW(eMapDirection dir)
-{
-    switch (dir)
-    {
-        case eMapDirection_N: return eMapDirection_E;
-        case eMapDirection_E: return eMapDirection_S;
-        case eMapDirection_S: return eMapDirection_W;
-        case eMapDirection_W: return eMapDirection_N;
-    }
-    debug_assert(false);
-    return eMapDirection_E;
-}
-
-inline eMapDirection GetMapDirectionCCW(eMapDirection dir)
-{
-    switch (dir)
-    {
-        case eMapDirection_N: return eMapDirection_W;
-        case eMapDirection_E: return eMapDirection_N;
-        case eMapDirection_S: return eMapDirection_E;
-        case eMapDirection_W: return eMapDirection_S;
-    }
-    debug_assert(false);
-    return eMapDirection_E;
-}
-
-inline eMapDirection GetMapDirectionOpposite(eMapDirection dir)
-{
-    switch (dir)
-    {
-        case eMapDirection_N: return eMapDirection_S;
-        case eMapDirection_E: return eMapDirection_W;
-        case eMapDirection_S: return eMapDirection_N;
-        case eMapDirection_W: return eMapDirection_E;
-    }
-    debug_assert(false);
-    return eMapDirection_E;
-}
-
-// Get straight point vector for direction
-inline const glm::ivec3& GetVectorFromMapDirection(eMapDirection direction)
-{
-    static const glm::ivec3 Vecs[] =
-    {
-        { 0, 0, -1}, // n
-        { 1, 0,  0}, // e
-        { 0, 0,  1}, // s
-        {-1, 0,  0}, // w
-    };
-    return Vecs[direction];
-}
-
-//////////////////////////////////////////////////////////////////////////
-
 AiCharacterController::AiCharacterController(Pedestrian* character)
 {
     mCharacter = character;
@@ -123,6 +40,8 @@ void AiCharacterController::DebugDraw(DebugRenderer& debugRender)
 
 bool AiCharacterController::ScanForThreats()
 {
+    mHasThreatPosition = false;
+
     if (mCharacter->HasFear_GunShots() && ScanForGunshots())
         return true;
 
@@ -134,32 +53,43 @@ bool AiCharacterController::ScanForThreats()
 
 bool AiCharacterController::ScanForExplosions()
 {
-    float reactionDistance2 = glm::pow(gGameParams.mAiReactOnExplosionsDistance, 2.0f);
+    if (gBroadcastEvents.GetEventsCount(eBroadcastEvent_Explosion) == 0)
+        return false;
 
     BroadcastEvent eventData;
-    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_Explosion, mCharacter->GetPosition2(), eventData))
+    if (!gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_Explosion, mCharacter->GetPosition2(),
+        gGameParams.mAiReactOnExplosionsDistance, eventData))
     {
-        if (glm::distance2(eventData.mPosition, mCharacter->GetPosition2()) > reactionDistance2) // too far away
-            return false;
-
-        return true;
+        return false;
     }
-    return false;
+
+    mThreatPosition = eventData.mPosition;
+    mHasThreatPosition = true;
+    return true;
 }
 
 bool AiCharacterController::ScanForGunshots()
 {
-    float reactionDistance2 = glm::pow(gGameParams.mAiReactOnGunshotsDistance, 2.0f);
+    if (gBroadcastEvents.GetEventsCount(eBroadcastEvent_GunShot) == 0)
+        return false;
 
-    BroadcastEvent eventData;
-    if (gBroadcastEvents.PeekClosestEvent(eBroadcastEvent_GunShot, mCharacter->GetPosition2(), eventData))
+    // shared between all controllers
+    static std::vector<BroadcastEvent> eventsList;
+    eventsList.clear();
+
+    if (gBroadcastEvents.QueryEventsInRadius(eBroadcastEvent_GunShot, mCharacter->GetPosition2(),
+        gGameParams.mAiReactOnGunshotsDistance, eventsList) == 0)
     {
-        if (eventData.mCharacter == mCharacter) // hear own gunshots
-            return false; 
+        return false;
+    }
 
-        if (glm::distance2(eventData.mPosition, mCharacter->GetPosition2()) > reactionDistance2) // too far away
-            return false;
+    for (const BroadcastEvent& eventData: eventsList)
+    {
+        if (eventData.mCharacter == mCharacter) // hear own gunshots
+            continue;
 
+        mThreatPosition = eventData.mPosition;
+        mHasThreatPosition = true;
         return true;
     }
     return false;
@@ -167,6 +97,9 @@ bool AiCharacterController::ScanForGunshots()
 
 void AiCharacterController::UpdateFrame()
 {
+    // character keeps moving between deferred updates, so it could pass its waypoint in meantime
+    mCatchupTime = mPendingUpdateTime;
+
     // choose current activity
     if (mAiMode == ePedestrianAiMode_None)
     {
@@ -210,6 +143,7 @@ void AiCharacterController::UpdateFrame()
     }
     else if (mCharacter->IsBurn())
     {
+        mHasThreatPosition = false;
         StartPanic();
         return;
     }
@@ -304,8 +238,24 @@ bool AiCharacterController::ChooseWalkWaypoint(bool isPanic)
 
     glm::ivec3 currentLogPos = Convert::MetersToMapUnits(mCharacter->GetPosition());
     glm::ivec3 newWayPoint (0, 0, 0);
+
+    // run away from known threat using shared field
+    if (isPanic && mHasThreatPosition)
+    {
+        const AiFlowField* fleeField = gAiManager.mFlowFields.GetFleeField(mThreatPosition, currentLogPos.y);
+
+        eMapDirection fleeDirection;
+        if (fleeField && fleeField->GetMoveDirection(currentLogPos.x, currentLogPos.z, fleeDirection))
+        {
+            newWayPoint = currentLogPos + GetVectorFromMapDirection(fleeDirection);
+        }
+    }
+
     for (eMapDirection curr: moveDirs)
     {
+        if (newWayPoint != glm::ivec3(0, 0, 0))
+            break;
+
         glm::ivec3 moveBlockPos = currentLogPos + GetVectorFromMapDirection(curr);
 
         const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(moveBlockPos.x, moveBlockPos.z, moveBlockPos.y);
@@ -350,12 +300,18 @@ bool AiCharacterController::ChooseWalkWaypoint(bool isPanic)
 
 bool AiCharacterController::ContinueWalkToWaypoint(float distance)
 {
-    float tolerance2 = pow(gGameParams.mPedestrianBoundsSphereRadius, 2.0f);
+    float tolerance = gGameParams.mPedestrianBoundsSphereRadius;
+    if (mCharacter->mCtlState.mWalkForward)
+    {
+        float walkSpeed = mCharacter->mCtlState.mRun ? gGameParams.mPedestrianRunSpeed : gGameParams.mPedestrianWalkSpeed;
+        tolerance += walkSpeed * mCatchupTime;
+    }
 
     glm::vec2 currentPosition = mCharacter->mPhysicsBody->GetPosition2();
-    if (glm::distance2(currentPosition, mDestinationPoint) <= tolerance2)
+    if (glm::distance2(currentPosition, mDestinationPoint) <= (tolerance * tolerance))
     {
         mCharacter->mCtlState.Clear();
+        mCatchupTime = 0.0f;
         return false;
     }
 
@@ -374,6 +330,7 @@ void AiCharacterController::StartDrivingCar()
 {
     mAiMode = ePedestrianAiMode_DrivingCar;
     mFollowPedestrian.reset();
+    mDriveTargetSegment = RoadLaneGraph::NullSegment;
 
     mCharacter->mCtlState.Clear();
     if (!ChooseDriveWaypoint() || !ContinueDriveToWaypoint())
@@ -388,6 +345,7 @@ void AiCharacterController::StopDriving()
         return;
 
     mCharacter->mCtlState.Clear();
+    mDriveTargetSegment = RoadLaneGraph::NullSegment;
 
     float currentSpeed = mCharacter->mCurrentCar->mPhysicsBody->GetCurrentSpeed();
     if (currentSpeed > gGameParams.mVehicleSpeedPassengerCanEnter)
@@ -427,14 +385,90 @@ void AiCharacterController::UpdateDrivingCar()
 
 bool AiCharacterController::ChooseDriveWaypoint()
 {
-    // todo: implement
-    return false;
+    const RoadLaneGraph& roadLanes = gGameMap.mRoadLanes;
+
+    CarPhysicsBody* carPhysics = mCharacter->mCurrentCar->mPhysicsBody;
+
+    // continue from reached segment or find out where car is located now
+    int currentSegment = mDriveTargetSegment;
+    eMapDirection currentDirection = mDriveDirection;
+    if (currentSegment == RoadLaneGraph::NullSegment)
+    {
+        currentSegment = roadLanes.GetSegmentIndexAtPosition(carPhysics->GetPosition());
+        currentDirection = GetMapDirectionFromHeading(carPhysics->GetRotationAngle().mDegrees);
+    }
+
+    mDriveTargetSegment = RoadLaneGraph::NullSegment;
+    if (currentSegment == RoadLaneGraph::NullSegment)
+        return false;
+
+    eMapDirection nextDirection;
+    if (!roadLanes.ChooseNextDirection(currentSegment, currentDirection, gCarnageGame.mGameRand, nextDirection))
+        return false;
+
+    mDriveTargetSegment = roadLanes.GetNextSegment(currentSegment, nextDirection);
+    mDriveDirection = nextDirection;
+    debug_assert(mDriveTargetSegment != RoadLaneGraph::NullSegment);
+
+    glm::vec3 segmentCenter = roadLanes.GetSegmentCenter(mDriveTargetSegment);
+    mDestinationPoint.x = segmentCenter.x;
+    mDestinationPoint.y = segmentCenter.z;
+    return true;
 }
 
 bool AiCharacterController::ContinueDriveToWaypoint()
 {
-    // todo: implement
-    return false;
+    if (mDriveTargetSegment == RoadLaneGraph::NullSegment)
+        return false;
+
+    const float ReachDistance = Convert::MapUnitsToMeters(0.5f);
+    const float LostDistance = Convert::MapUnitsToMeters(2.5f);
+    const float CruiseSpeed = Convert::MapUnitsToMeters(2.5f); // meters per second
+    const float TurnSpeed = Convert::MapUnitsToMeters(1.0f); // meters per second
+    const float SteerFullAngle = 30.0f; // degrees
+
+    CarPhysicsBody* carPhysics = mCharacter->mCurrentCar->mPhysicsBody;
+
+    // distance driven since last update is also counted as reached
+    float reachDistance = std::min(ReachDistance + fabsf(carPhysics->GetCurrentSpeed()) * mCatchupTime, LostDistance);
+
+    glm::vec2 toTarget = mDestinationPoint - carPhysics->GetPosition2();
+    float distanceToTarget2 = glm::length2(toTarget);
+    if (distanceToTarget2 <= (reachDistance * reachDistance))
+    {
+        mCatchupTime = 0.0f;
+        return false; // target segment reached
+    }
+
+    if (distanceToTarget2 > (LostDistance * LostDistance))
+    {
+        // car was pushed away from route, search for road again
+        mDriveTargetSegment = RoadLaneGraph::NullSegment;
+        return false;
+    }
+
+    float targetHeading = glm::degrees(atan2f(toTarget.y, toTarget.x));
+    float angleToTurn = cxx::normalize_angle_180(targetHeading - carPhysics->GetRotationAngle().mDegrees);
+
+    PedestrianCtlState& ctlState = mCharacter->mCtlState;
+    ctlState.mSteerDirection = glm::clamp(angleToTurn / SteerFullAngle, -1.0f, 1.0f);
+
+    // slow down on turns
+    float desiredSpeed = (fabs(angleToTurn) > 45.0f) ? TurnSpeed : CruiseSpeed;
+    float currentSpeed = carPhysics->GetCurrentSpeed();
+    if (currentSpeed < desiredSpeed)
+    {
+        ctlState.mAcceleration = 1.0f;
+    }
+    else if (currentSpeed > desiredSpeed * 1.5f)
+    {
+        ctlState.mAcceleration = -1.0f;
+    }
+    else
+    {
+        ctlState.mAcceleration = 0.0f;
+    }
+    return true;
 }
 
 void AiCharacterController::FollowPedestrian(Pedestrian* pedestrian)
@@ -492,6 +526,23 @@ void AiCharacterController::UpdateFollowTarget()
 
     mRunToTarget = mFollowPedestrian->IsRunning() || (distanceToTarget2 > glm::pow(mFollowFarDistance, 2.0f));
     mDestinationPoint = targetPosition2 + glm::normalize(targetPosition2 - characterPosition2) * mFollowNearDistance;
+
+    // target is far away, walk around obstacles using shared field
+    if (distanceToTarget2 > glm::pow(Convert::MapUnitsToMeters(1.0f), 2.0f))
+    {
+        glm::ivec3 currentLogPos = Convert::MetersToMapUnits(mCharacter->GetPosition());
+
+        const AiFlowField* followField = gAiManager.mFlowFields.GetFollowField(mFollowPedestrian);
+
+        eMapDirection followDirection;
+        if (followField && (followField->mMapLayer == currentLogPos.y) &&
+            followField->GetMoveDirection(currentLogPos.x, currentLogPos.z, followDirection))
+        {
+            glm::ivec3 nextBlock = currentLogPos + GetVectorFromMapDirection(followDirection);
+            mDestinationPoint.x = Convert::MapUnitsToMeters(nextBlock.x + 0.5f);
+            mDestinationPoint.y = Convert::MapUnitsToMeters(nextBlock.z + 0.5f);
+        }
+    }
     ContinueWalkToWaypoint(mFollowNearDistance);
 }
 
@@ -510,6 +561,13 @@ bool AiCharacterController::HasAiFlags(ePedestrianAiFlags aiFlags) const
     return (mAiFlags & aiFlags) == aiFlags;
 }
 
+bool AiCharacterController::RequiresFrequentUpdates() const
+{
+    // steering vehicle or running might overshoot waypoint if updated too rarely
+    return (mAiMode == ePedestrianAiMode_DrivingCar) || (mAiMode == ePedestrianAiMode_Panic) ||
+        (mAiMode == ePedestrianAiMode_FollowTarget);
+}
+
 bool AiCharacterController::TryFollowHumanCharacterNearby()
 {
     float maxSignDistance = Convert::MapUnitsToMeters(0.5f);
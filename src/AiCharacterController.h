@@ -2,6 +2,7 @@
 
 #include "CharacterController.h"
 #include "Pedestrian.h"
+#include "RoadLaneGraph.h"
 
 enum ePedestrianAiMode
 {
@@ -29,9 +30,25 @@ enum ePedestrianAiFlags
 };
 decl_enum_as_flags(ePedestrianAiFlags);
 
+// ai update frequency level, depends on distance to human players views
+enum eAiUpdateTier
+{
+    eAiUpdateTier_OnScreen, // every frame
+    eAiUpdateTier_Near,
+    eAiUpdateTier_Far,
+    eAiUpdateTier_COUNT
+};
+
 // defines ai character controller
 class AiCharacterController final: public CharacterController
 {
+    friend class GameStateSnapshot;
+
+public:
+    // readonly, managed by ai manager
+    eAiUpdateTier mUpdateTier = eAiUpdateTier_OnScreen;
+    float mPendingUpdateTime = 0.0f; // game time passed since last update, seconds
+
 public:
     AiCharacterController(Pedestrian* character);
 
@@ -46,6 +63,9 @@ public:
     // objectives
     void FollowPedestrian(Pedestrian* pedestrian);
 
+    // whether controller is currently sensitive to update delays
+    bool RequiresFrequentUpdates() const;
+
 private:
     void UpdatePanic();
     void UpdateWandering();
@@ -79,12 +99,21 @@ private:
 
     glm::vec2 mDestinationPoint;
     float mDefaultNearDistance;
+    float mCatchupTime = 0.0f; // game time skipped since last update, consumed when waypoint gets reached
     
     ePedestrianAiFlags mAiFlags = ePedestrianAiFlags_None;
 
+    // driving
+    int mDriveTargetSegment = RoadLaneGraph::NullSegment; // road lane segment index
+    eMapDirection mDriveDirection = eMapDirection_N;
+
     PedestrianHandle mFollowPedestrian;
     float mFollowNearDistance;
     float mFollowFarDistance;
 
     bool mRunToTarget = false;
+
+    // last known threat, used to choose flee direction
+    glm::vec2 mThreatPosition;
+    bool mHasThreatPosition = false;
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "stdafx.h"
+#include "AiFlowField.h"
+#include "GameMapManager.h"
+#include "TimeManager.h"
+#include "Pedestrian.h"
+
+AiFlowField::AiFlowField()
+    : mSourceBlock()
+    , mWindowOrigin()
+{
+}
+
+void AiFlowField::Setup(eAiFlowFieldType fieldType, const Point& sourceBlock, int mapLayer, float expireTime)
+{
+    mFieldType = fieldType;
+    mSourceBlock = sourceBlock;
+    mWindowOrigin = sourceBlock - Point(WindowSize / 2, WindowSize / 2);
+    mMapLayer = mapLayer;
+    mExpireTime = expireTime;
+    mFollowTarget.reset();
+
+    mDistances.assign(WindowSize * WindowSize, UnreachedDistance);
+    mCellsQueue.clear();
+    mCellsQueue.reserve(WindowSize * WindowSize);
+    mQueueHead = 0;
+
+    // seed
+    int sourceCell = GetCellIndex(sourceBlock.x, sourceBlock.y);
+    debug_assert(sourceCell != -1);
+    mDistances[sourceCell] = 0;
+    mCellsQueue.push_back((unsigned short) sourceCell);
+}
+
+int AiFlowField::ComputeCells(int maxCells)
+{
+    int cellsCounter = 0;
+    for (; (cellsCounter < maxCells) && !IsComplete(); ++cellsCounter)
+    {
+        int currCell = mCellsQueue[mQueueHead++];
+        int currx = mWindowOrigin.x + (currCell % WindowSize);
+        int curry = mWindowOrigin.y + (currCell / WindowSize);
+
+        unsigned short nextDistance = mDistances[currCell] + 1;
+        for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+        {
+            const glm::ivec3& moveVector = GetVectorFromMapDirection((eMapDirection) idirection);
+
+            int nextx = currx + moveVector.x;
+            int nexty = curry + moveVector.z;
+
+            int nextCell = GetCellIndex(nextx, nexty);
+            if ((nextCell == -1) || (mDistances[nextCell] != UnreachedDistance))
+                continue;
+
+            if (!IsWalkableCell(nextx, nexty))
+                continue;
+
+            mDistances[nextCell] = nextDistance;
+            mCellsQueue.push_back((unsigned short) nextCell);
+        }
+    }
+    return cellsCounter;
+}
+
+bool AiFlowField::GetMoveDirection(int mapx, int mapy, eMapDirection& outDirection) const
+{
+    int currCell = GetCellIndex(mapx, mapy);
+    if ((currCell == -1) || (mDistances[currCell] == UnreachedDistance))
+        return false;
+
+    unsigned short bestDistance = mDistances[currCell];
+    bool directionFound = false;
+    for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+    {
+        const glm::ivec3& moveVector = GetVectorFromMapDirection((eMapDirection) idirection);
+
+        int nextCell = GetCellIndex(mapx + moveVector.x, mapy + moveVector.z);
+        if ((nextCell == -1) || (mDistances[nextCell] == UnreachedDistance))
+            continue;
+
+        unsigned short nextDistance = mDistances[nextCell];
+        bool isBetter = (mFieldType == eAiFlowFieldType_Flee) ? (nextDistance > bestDistance) : (nextDistance < bestDistance);
+        if (!isBetter)
+            continue;
+
+        bestDistance = nextDistance;
+        outDirection = (eMapDirection) idirection;
+        directionFound = true;
+    }
+    return directionFound;
+}
+
+int AiFlowField::GetCellIndex(int mapx, int mapy) const
+{
+    int cellx = mapx - mWindowOrigin.x;
+    int celly = mapy - mWindowOrigin.y;
+    if ((cellx < 0) || (celly < 0) || (cellx >= WindowSize) || (celly >= WindowSize))
+        return -1;
+
+    return celly * WindowSize + cellx;
+}
+
+bool AiFlowField::IsWalkableCell(int mapx, int mapy) const
+{
+    if ((mapx < 0) || (mapy < 0) || (mapx >= MAP_DIMENSIONS) || (mapy >= MAP_DIMENSIONS))
+        return false;
+
+    const MapBlockInfo* blockInfo = gGameMap.GetBlockInfo(mapx, mapy, mMapLayer);
+
+    eGroundType groundType = blockInfo->mGroundType;
+    return (groundType == eGroundType_Pawement) || (groundType == eGroundType_Field) || (groundType == eGroundType_Road);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+AiFlowFieldsCache::AiFlowFieldsCache()
+{
+}
+
+void AiFlowFieldsCache::ClearFields()
+{
+    mFields.clear();
+    mFrameCellsBudget = FrameCellsBudget;
+}
+
+void AiFlowFieldsCache::UpdateFrame()
+{
+    mFrameCellsBudget = FrameCellsBudget;
+
+    float currentGameTime = gTimeManager.mGameTime;
+    // continue computing unfinished fields
+    for (AiFlowField& currField: mFields)
+    {
+        if (mFrameCellsBudget <= 0)
+            break;
+
+        if (currField.IsExpired(currentGameTime) || currField.IsComplete())
+            continue;
+
+        mFrameCellsBudget -= currField.ComputeCells(mFrameCellsBudget);
+    }
+}
+
+const AiFlowField* AiFlowFieldsCache::GetFleeField(const glm::vec2& position, int mapLayer)
+{
+    float currentGameTime = gTimeManager.mGameTime;
+
+    Point sourceBlock (Convert::MetersToMapUnits(position));
+    for (AiFlowField& currField: mFields)
+    {
+        if ((currField.mFieldType == eAiFlowFieldType_Flee) && !currField.IsExpired(currentGameTime) &&
+            (currField.mSourceBlock == sourceBlock) && (currField.mMapLayer == mapLayer))
+        {
+            ++mFieldsReusedCounter;
+            return &currField;
+        }
+    }
+
+    AiFlowField* flowField = AllocateField();
+    if (flowField == nullptr)
+        return nullptr;
+
+    flowField->Setup(eAiFlowFieldType_Flee, sourceBlock, mapLayer, currentGameTime + gGameParams.mAiFlowFieldLifetime);
+    ComputeField(flowField);
+    return flowField;
+}
+
+const AiFlowField* AiFlowFieldsCache::GetFollowField(Pedestrian* pedestrian)
+{
+    debug_assert(pedestrian);
+
+    float currentGameTime = gTimeManager.mGameTime;
+
+    glm::ivec3 targetBlock (Convert::MetersToMapUnits(pedestrian->GetPosition()));
+
+    AiFlowField* flowField = nullptr;
+    for (AiFlowField& currField: mFields)
+    {
+        if ((currField.mFieldType == eAiFlowFieldType_Follow) && (currField.mFollowTarget == pedestrian) &&
+            !currField.IsExpired(currentGameTime))
+        {
+            // target is still in same block
+            if ((currField.mSourceBlock == Point(targetBlock.x, targetBlock.z)) && (currField.mMapLayer == targetBlock.y))
+            {
+                ++mFieldsReusedCounter;
+                return &currField;
+            }
+            flowField = &currField;
+            break;
+        }
+    }
+
+    if (flowField == nullptr)
+    {
+        flowField = AllocateField();
+        if (flowField == nullptr)
+            return nullptr;
+    }
+
+    flowField->Setup(eAiFlowFieldType_Follow, Point(targetBlock.x, targetBlock.z), targetBlock.y,
+        currentGameTime + gGameParams.mAiFlowFieldLifetime);
+    flowField->mFollowTarget = pedestrian;
+    ComputeField(flowField);
+    return flowField;
+}
+
+AiFlowField* AiFlowFieldsCache::AllocateField()
+{
+    float currentGameTime = gTimeManager.mGameTime;
+
+    // reuse expired field
+    AiFlowField* oldestField = nullptr;
+    for (AiFlowField& currField: mFields)
+    {
+        if (currField.IsExpired(currentGameTime))
+            return &currField;
+
+        if ((oldestField == nullptr) || (currField.mExpireTime < oldestField->mExpireTime))
+        {
+            oldestField = &currField;
+        }
+    }
+
+    if ((int) mFields.size() < MaxFlowFields)
+    {
+        if (mFields.capacity() < MaxFlowFields)
+        {
+            mFields.reserve(MaxFlowFields); // pointers to fields must stay valid
+        }
+        mFields.emplace_back();
+        return &mFields.back();
+    }
+
+    // discard field that expires first
+    return oldestField;
+}
+
+void AiFlowFieldsCache::ComputeField(AiFlowField* flowField)
+{
+    ++mFieldsCreatedCounter;
+
+    if (mFrameCellsBudget > 0)
+    {
+        mFrameCellsBudget -= flowField->ComputeCells(mFrameCellsBudget);
+    }
+}
\ No newline at end of file
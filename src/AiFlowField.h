@@ -0,0 +1,95 @@
+#pragma once
+
+#include "GameDefs.h"
+#include "GameMapHelpers.h"
+
+enum eAiFlowFieldType
+{
+    eAiFlowFieldType_Flee, // move away from source point
+    eAiFlowFieldType_Follow, // move towards source point
+};
+
+// defines distance field over walkable map blocks within bounded window around source block
+// field is shared between all pedestrians that react on same threat or follow same target
+class AiFlowField final
+{
+public:
+    static const int WindowSize = 32; // blocks
+    static const unsigned short UnreachedDistance = 0xFFFF;
+
+    // readonly
+    eAiFlowFieldType mFieldType = eAiFlowFieldType_Flee;
+    Point mSourceBlock;
+    Point mWindowOrigin; // top left block of window
+    int mMapLayer = 0;
+    float mExpireTime = 0.0f;
+    PedestrianHandle mFollowTarget; // follow fields only
+
+public:
+    AiFlowField();
+
+    // Reset field and start new distance computation
+    // @param fieldType: Field type
+    // @param sourceBlock: Map block coordinate of source point
+    // @param mapLayer: Map layer
+    // @param expireTime: Game time when field gets invalidated, seconds
+    void Setup(eAiFlowFieldType fieldType, const Point& sourceBlock, int mapLayer, float expireTime);
+
+    // Continue distance computation
+    // @param maxCells: Max number of cells to process
+    // @returns number of processed cells
+    int ComputeCells(int maxCells);
+
+    // Sample field at specific block
+    // @param mapx, mapy: Map block coordinate
+    // @param outDirection: Direction to move
+    // @returns false if there is no suitable direction
+    bool GetMoveDirection(int mapx, int mapy, eMapDirection& outDirection) const;
+
+    inline bool IsComplete() const { return mQueueHead == (int) mCellsQueue.size(); }
+    inline bool IsExpired(float currentTime) const { return mExpireTime <= currentTime; }
+
+private:
+    int GetCellIndex(int mapx, int mapy) const;
+    bool IsWalkableCell(int mapx, int mapy) const;
+
+private:
+    std::vector<unsigned short> mDistances; // per cell, in blocks
+    std::vector<unsigned short> mCellsQueue; // bfs queue
+    int mQueueHead = 0;
+};
+
+// Flow fields cache, fields are computed incrementally within per-frame budget and invalidated by time
+class AiFlowFieldsCache final: public cxx::noncopyable
+{
+public:
+    AiFlowFieldsCache();
+
+    void ClearFields();
+    void UpdateFrame();
+
+    // Get or create field to flee from threat located at position
+    // @param position: Threat position, meters
+    // @param mapLayer: Map layer of pedestrian
+    const AiFlowField* GetFleeField(const glm::vec2& position, int mapLayer);
+
+    // Get or create field to reach target pedestrian
+    // @param pedestrian: Target pedestrian
+    const AiFlowField* GetFollowField(Pedestrian* pedestrian);
+
+public:
+    // stats
+    int mFieldsCreatedCounter = 0;
+    int mFieldsReusedCounter = 0;
+
+private:
+    AiFlowField* AllocateField();
+    void ComputeField(AiFlowField* flowField);
+
+private:
+    static const int MaxFlowFields = 32;
+    static const int FrameCellsBudget = 4096;
+
+    std::vector<AiFlowField> mFields;
+    int mFrameCellsBudget = FrameCellsBudget;
+};
\ No newline at end of file
@@ -2,33 +2,90 @@
 #include "AiManager.h"
 #include "AiCharacterController.h"
 #include "Pedestrian.h"
+#include "CarnageGame.h"
+#include "TimeManager.h"
 
 AiManager gAiManager;
 
+void AiUpdateStats::FrameBegin()
+{
+    mControllersCount = 0;
+    for (int& currCounter: mControllersUpdated)
+    {
+        currCounter = 0;
+    }
+    mControllersDeferred = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 AiManager::AiManager()
 {
 }
 
 void AiManager::UpdateFrame()
 {
-    // update all character controllers
-    bool hasInactiveControllers = false;
-    for (size_t iController = 0, Count = mCharacterControllers.size(); iController < Count; ++iController)
+    mFlowFields.UpdateFrame();
+    mUpdateStats.FrameBegin();
+
+    DeleteInactiveControllers();
+
+    float deltaTime = gTimeManager.mGameFrameDelta;
+
+    int controllersCount = (int) mCharacterControllers.size();
+    mUpdateStats.mControllersCount = controllersCount;
+
+    // onscreen controllers are updated immediately, others are waiting for their interval to pass
+    int pendingCount = 0;
+    for (AiCharacterController* currController: mCharacterControllers)
     {
-        AiCharacterController* currController = mCharacterControllers[iController];
-        if (currController->IsControllerActive())
+        currController->mPendingUpdateTime += deltaTime;
+        currController->mUpdateTier = ComputeUpdateTier(currController);
+        if (currController->mUpdateTier == eAiUpdateTier_OnScreen)
         {
-            currController->UpdateFrame();
+            UpdateController(currController);
+            continue;
         }
-        else
+
+        if (currController->mPendingUpdateTime >= GetUpdateInterval(currController->mUpdateTier))
         {
-            SafeDelete(mCharacterControllers[iController]);
-            hasInactiveControllers = true;
+            ++pendingCount;
         }
     }
-    if (hasInactiveControllers)
+
+    if ((pendingCount == 0) || (controllersCount == 0))
+        return;
+
+    // process pending controllers in round robin order within time budget,
+    // postponed controllers keep accumulating time and will be updated in next frames
+    if (mDeferredUpdatesCursor >= controllersCount)
     {
-        cxx::erase_elements(mCharacterControllers, nullptr);
+        mDeferredUpdatesCursor = 0;
+    }
+
+    double budgetEndTime = gSystem.GetSystemSeconds() + gGameParams.mAiFrameTimeBudget;
+    for (int icounter = 0; (icounter < controllersCount) && (pendingCount > 0); ++icounter)
+    {
+        AiCharacterController* currController = mCharacterControllers[mDeferredUpdatesCursor];
+        if (++mDeferredUpdatesCursor == controllersCount)
+        {
+            mDeferredUpdatesCursor = 0;
+        }
+
+        if ((currController->mUpdateTier == eAiUpdateTier_OnScreen) ||
+            (currController->mPendingUpdateTime < GetUpdateInterval(currController->mUpdateTier)))
+        {
+            continue;
+        }
+
+        if (gSystem.GetSystemSeconds() > budgetEndTime)
+        {
+            mUpdateStats.mControllersDeferred = pendingCount;
+            break;
+        }
+
+        UpdateController(currController);
+        --pendingCount;
     }
 }
 
@@ -48,6 +105,75 @@ void AiManager::ReleaseAiControllers()
     }
 
     mCharacterControllers.clear();
+    mFlowFields.ClearFields();
+}
+
+void AiManager::DeleteInactiveControllers()
+{
+    bool hasInactiveControllers = false;
+    for (AiCharacterController*& currController: mCharacterControllers)
+    {
+        if (currController->IsControllerActive())
+            continue;
+
+        SafeDelete(currController);
+        hasInactiveControllers = true;
+    }
+    if (hasInactiveControllers)
+    {
+        cxx::erase_elements(mCharacterControllers, nullptr);
+    }
+}
+
+eAiUpdateTier AiManager::ComputeUpdateTier(AiCharacterController* controller) const
+{
+    debug_assert(controller->mCharacter);
+
+    eAiUpdateTier bestTier = eAiUpdateTier_Far;
+
+    glm::vec2 characterPosition = controller->mCharacter->GetPosition2();
+    for (HumanPlayer* currentPlayer: gCarnageGame.mHumanPlayers)
+    {
+        if (currentPlayer == nullptr)
+            continue;
+
+        const cxx::aabbox2d_t& onScreenArea = currentPlayer->mPlayerView.mOnScreenArea;
+        if (onScreenArea.contains(characterPosition))
+            return eAiUpdateTier_OnScreen;
+
+        cxx::aabbox2d_t nearArea = onScreenArea;
+        nearArea.mMin -= glm::vec2(gGameParams.mAiNearUpdateDistance);
+        nearArea.mMax += glm::vec2(gGameParams.mAiNearUpdateDistance);
+        if (nearArea.contains(characterPosition))
+        {
+            bestTier = eAiUpdateTier_Near;
+        }
+    }
+
+    if ((bestTier == eAiUpdateTier_Far) && controller->RequiresFrequentUpdates())
+    {
+        bestTier = eAiUpdateTier_Near;
+    }
+    return bestTier;
+}
+
+float AiManager::GetUpdateInterval(eAiUpdateTier updateTier) const
+{
+    switch (updateTier)
+    {
+        case eAiUpdateTier_Near: return gGameParams.mAiNearUpdateInterval;
+        case eAiUpdateTier_Far: return gGameParams.mAiFarUpdateInterval;
+        default: break;
+    }
+    return 0.0f;
+}
+
+void AiManager::UpdateController(AiCharacterController* controller)
+{
+    ++mUpdateStats.mControllersUpdated[controller->mUpdateTier];
+
+    controller->UpdateFrame();
+    controller->mPendingUpdateTime = 0.0f;
 }
 
 AiCharacterController* AiManager::CreateAiController(Pedestrian* pedestrian)
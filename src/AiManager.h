@@ -1,8 +1,23 @@
 #pragma once
 
-class AiCharacterController;
+#include "AiFlowField.h"
+#include "AiCharacterController.h"
+
 class DebugRenderer;
 
+// ai update scheduler counters
+struct AiUpdateStats
+{
+public:
+    AiUpdateStats() = default;
+    void FrameBegin();
+
+public:
+    int mControllersCount = 0; // per frame
+    int mControllersUpdated[eAiUpdateTier_COUNT] = {}; // per frame, for each tier
+    int mControllersDeferred = 0; // per frame, postponed due to time budget
+};
+
 // Artificial Intelligence manager class
 class AiManager final: public cxx::noncopyable
 {
@@ -21,8 +36,21 @@ public:
     void ReleaseAiControllers();
     void ReleaseAiController(AiCharacterController* controller);
 
+public:
+    // shared flee and follow fields
+    AiFlowFieldsCache mFlowFields;
+
+    AiUpdateStats mUpdateStats;
+
+private:
+    void DeleteInactiveControllers();
+    eAiUpdateTier ComputeUpdateTier(AiCharacterController* controller) const;
+    float GetUpdateInterval(eAiUpdateTier updateTier) const;
+    void UpdateController(AiCharacterController* controller);
+
 private:
     std::vector<AiCharacterController*> mCharacterControllers;
+    int mDeferredUpdatesCursor = 0; // round robin position for offscreen controllers
 };
 
 extern AiManager gAiManager;
\ No newline at end of file
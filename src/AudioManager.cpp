@@ -30,21 +30,28 @@ void AudioManager::UpdateFrame()
 
 }
 
-bool AudioManager::LoadLevelSounds()
+bool AudioManager::PrepareLevelSounds(int audioFileNumber, SfxArchive& levelSounds, SfxArchive& voiceSounds)
 {
-    FreeLevelSounds();
-
     gConsole.LogMessage(eLogMessage_Debug, "Loading level sounds...");
-    if (!mVoiceSounds.LoadArchive("AUDIO/VOCALCOM"))
+    if (!voiceSounds.LoadArchive("AUDIO/VOCALCOM"))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load Voice sounds");
     }
 
-    std::string audioBankFileName = cxx::va("AUDIO/LEVEL%03d", gGameMap.mAudioFileNumber); 
-    if (!mLevelSounds.LoadArchive(audioBankFileName))
+    std::string audioBankFileName = cxx::va("AUDIO/LEVEL%03d", audioFileNumber); 
+    if (!levelSounds.LoadArchive(audioBankFileName))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot load Level sounds");
     }
+    return true;
+}
+
+bool AudioManager::LoadLevelSounds(SfxArchive& levelSounds, SfxArchive& voiceSounds)
+{
+    FreeLevelSounds();
+
+    mLevelSounds.Swap(levelSounds);
+    mVoiceSounds.Swap(voiceSounds);
 
     mLevelSoundsBuffers.resize(mLevelSounds.GetEntriesCount());
     mVoiceSoundsBuffers.resize(mVoiceSounds.GetEntriesCount());
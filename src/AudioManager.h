@@ -17,8 +17,14 @@ public:
 
     void UpdateFrame();
 
+    // Open sound archives and read entries information, does not access audio device so it could be called from worker thread
+    // @param audioFileNumber: Level audio bank number
+    // @param levelSounds, voiceSounds: Output archives
+    static bool PrepareLevelSounds(int audioFileNumber, SfxArchive& levelSounds, SfxArchive& voiceSounds);
+
     // Preload sound archives for current level
-    bool LoadLevelSounds();
+    // @param levelSounds, voiceSounds: Prepared archives, contents are taken
+    bool LoadLevelSounds(SfxArchive& levelSounds, SfxArchive& voiceSounds);
     void FreeLevelSounds();
 
     // @param sfxIndex: Sound index, one of SfxLevel_*
@@ -10,31 +10,54 @@ BroadcastEventsManager::BroadcastEventsManager()
 
 void BroadcastEventsManager::ClearEvents()
 {
-    mEventsList.clear();
+    for (EventsBucket& currBucket: mBuckets)
+    {
+        for (std::vector<int>& currCell: currBucket.mGridCells)
+        {
+            currCell.clear();
+        }
+        currBucket.mSubjectSlots.clear();
+        currBucket.mEventsCount = 0;
+    }
+    mEventSlots.clear();
+    mFreeSlots.clear();
+    mExpireQueue.clear();
 }
 
 void BroadcastEventsManager::UpdateFrame()
 {
     float currentGameTime = gTimeManager.mGameTime;
 
-    // remove obsolete events from list
-    for (auto curr_event_iterator = mEventsList.begin(); 
-        curr_event_iterator != mEventsList.end(); )
+    // remove obsolete events, queue is ordered by expiration time so only expired entries are visited
+    while (!mExpireQueue.empty())
     {
-        BroadcastEvent& eventData = *curr_event_iterator;
-        if ((eventData.mEventTimestamp + eventData.mEventDurationTime) > currentGameTime)
-        {
-            ++curr_event_iterator;
+        const ExpireQueueEntry& queueEntry = mExpireQueue.front();
+        if (queueEntry.mExpireTime > currentGameTime)
+            break;
+
+        int slotIndex = queueEntry.mSlotIndex;
+        unsigned int slotSerial = queueEntry.mSlotSerial;
+
+        std::pop_heap(mExpireQueue.begin(), mExpireQueue.end());
+        mExpireQueue.pop_back();
+
+        EventSlot& eventSlot = mEventSlots[slotIndex];
+        if (!eventSlot.mActive || eventSlot.mSerial != slotSerial)
+            continue; // slot was released or reused
+
+        // event was prolonged, there is another queue entry for it
+        if (eventSlot.mEventData.GetExpireTime() > currentGameTime)
             continue;
-        }
+
         // remove expired event
-        curr_event_iterator = mEventsList.erase(curr_event_iterator);
+        FreeSlot(slotIndex);
     }
 }
 
 void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, GameObject* subject, Pedestrian* character, float durationTime)
 {
     debug_assert(subject);
+    debug_assert(eventType < eBroadcastEvent_COUNT);
 
     if (subject == nullptr)
         return;
@@ -51,157 +74,383 @@ void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, GameObject
         subjectType = eBroadcastEventSubject_Pedestrian;
     }
 
+    glm::vec2 subjectPosition = subject->GetPosition2();
+
     // update time and location if same event is exists
-    for (BroadcastEvent& evData: mEventsList)
+    EventsBucket& bucket = mBuckets[eventType];
+    auto subject_iterator = bucket.mSubjectSlots.find(subject);
+    if (subject_iterator != bucket.mSubjectSlots.end())
     {
-        if ((evData.mEventType == eventType) &&
-            (evData.mEventSubject == subjectType) &&
-            (evData.mSubject == subject))
+        int slotIndex = subject_iterator->second;
+        EventSlot& eventSlot = mEventSlots[slotIndex];
+        BroadcastEvent& evData = eventSlot.mEventData;
+        if ((evData.mEventSubject == subjectType) && (evData.mSubject == subject))
         {
             evData.mEventTimestamp = currentGameTime;
             evData.mEventDurationTime = durationTime;
-            evData.mPosition = subject->GetPosition2();
+            evData.mPosition = subjectPosition;
+            MoveSlotToCell(slotIndex, GetGridCellIndex(subjectPosition));
+            ScheduleExpiration(slotIndex);
             return;
         }
     }
 
-    mEventsList.emplace_back();
-    BroadcastEvent& evData = mEventsList.back();
+    int slotIndex = AllocateSlot(eventType, subjectPosition);
+
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    eventSlot.mSubjectKey = subject;
+    bucket.mSubjectSlots[subject] = slotIndex;
+
+    BroadcastEvent& evData = eventSlot.mEventData;
     // fill event data
     evData.mEventType = eventType;
     evData.mEventSubject = subjectType;
     evData.mEventTimestamp = currentGameTime;
     evData.mEventDurationTime = durationTime;
-    evData.mPosition = subject->GetPosition2();
+    evData.mPosition = subjectPosition;
     evData.mSubject = subject;
     evData.mCharacter = character;
+
+    ScheduleExpiration(slotIndex);
 }
 
 void BroadcastEventsManager::RegisterEvent(eBroadcastEvent eventType, const glm::vec2& position, float durationTime)
 {
+    debug_assert(eventType < eBroadcastEvent_COUNT);
+
     float currentGameTime = gTimeManager.mGameTime;
 
-    // update time if same event is exists
-    for (BroadcastEvent& evData: mEventsList)
+    int gridCell = GetGridCellIndex(position);
+
+    // update time if same event is exists, it could only be found within same grid cell
+    EventsBucket& bucket = mBuckets[eventType];
+    for (int currSlotIndex: bucket.mGridCells[gridCell])
     {
-        if ((evData.mEventType == eventType) &&
-            (evData.mEventSubject == eBroadcastEventSubject_None) &&
+        BroadcastEvent& evData = mEventSlots[currSlotIndex].mEventData;
+        if ((evData.mEventSubject == eBroadcastEventSubject_None) &&
             (evData.mPosition == position))
         {
             evData.mEventTimestamp = currentGameTime;
             evData.mEventDurationTime = durationTime;
+            ScheduleExpiration(currSlotIndex);
             return;
         }
     }
 
-    mEventsList.emplace_back();
-    BroadcastEvent& evData = mEventsList.back();
+    int slotIndex = AllocateSlot(eventType, position);
+
+    BroadcastEvent& evData = mEventSlots[slotIndex].mEventData;
     // fill event data
     evData.mEventType = eventType;
     evData.mEventSubject = eBroadcastEventSubject_None;
     evData.mEventTimestamp = currentGameTime;
     evData.mEventDurationTime = durationTime;
     evData.mPosition = position;
+
+    ScheduleExpiration(slotIndex);
 }
 
 bool BroadcastEventsManager::PeekEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData) const
 {
-    for (const BroadcastEvent& currEvent: mEventsList)
+    int slotIndex = FindFirstSlot(eventType);
+    if (slotIndex == NullSlot)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+    return true;
+}
+
+bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData) const
+{
+    int slotIndex = FindClosestSlot(eventType, position, 0.0f);
+    if (slotIndex == NullSlot)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+    return true;
+}
+
+bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, BroadcastEvent& outputEventData) const
+{
+    debug_assert(maxDistance > 0.0f);
+
+    int slotIndex = FindClosestSlot(eventType, position, maxDistance);
+    if (slotIndex == NullSlot)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+    return true;
+}
+
+bool BroadcastEventsManager::GetEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData)
+{
+    int slotIndex = FindFirstSlot(eventType);
+    if (slotIndex == NullSlot)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+
+    // remove element
+    FreeSlot(slotIndex);
+    return true;
+}
+
+bool BroadcastEventsManager::GetClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData)
+{
+    int slotIndex = FindClosestSlot(eventType, position, 0.0f);
+    if (slotIndex == NullSlot)
+        return false;
+
+    outputEventData = mEventSlots[slotIndex].mEventData;
+
+    // remove element
+    FreeSlot(slotIndex);
+    return true;
+}
+
+int BroadcastEventsManager::QueryEventsInRadius(eBroadcastEvent eventType, const glm::vec2& position, float radius,
+    std::vector<BroadcastEvent>& outputEvents) const
+{
+    debug_assert(eventType < eBroadcastEvent_COUNT);
+
+    const EventsBucket& bucket = mBuckets[eventType];
+    if (bucket.mEventsCount == 0)
+        return 0;
+
+    glm::ivec2 cellMin;
+    glm::ivec2 cellMax;
+    GetGridCellsRange(position, radius, cellMin, cellMax);
+
+    float radius2 = radius * radius;
+    int counter = 0;
+    for (int cellY = cellMin.y; cellY <= cellMax.y; ++cellY)
     {
-        if (currEvent.mEventType == eventType)
+        for (int cellX = cellMin.x; cellX <= cellMax.x; ++cellX)
         {
-            outputEventData = currEvent;
-            return true;
+            for (int currSlotIndex: bucket.mGridCells[cellY * GridDimensions + cellX])
+            {
+                const BroadcastEvent& currEvent = mEventSlots[currSlotIndex].mEventData;
+                if (glm::distance2(position, currEvent.mPosition) > radius2)
+                    continue;
+
+                outputEvents.push_back(currEvent);
+                ++counter;
+            }
         }
     }
-    return false;
+    return counter;
 }
 
-bool BroadcastEventsManager::PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData) const
+int BroadcastEventsManager::GetEventsCount(eBroadcastEvent eventType) const
 {
-    float closestDistance2 = 0.0f;
-    size_t counter = 0;
-    size_t bestIndex = 0;
-    for (size_t i = 0, Count = mEventsList.size(); i < Count; ++i)
+    debug_assert(eventType < eBroadcastEvent_COUNT);
+
+    return mBuckets[eventType].mEventsCount;
+}
+
+void BroadcastEventsManager::CollectEvents(std::vector<BroadcastEvent>& outputEvents) const
+{
+    for (const EventSlot& eventSlot: mEventSlots)
     {
-        const BroadcastEvent& currEvent = mEventsList[i];
-        if (currEvent.mEventType == eventType)
+        if (eventSlot.mActive)
         {
-            ++counter;
+            outputEvents.push_back(eventSlot.mEventData);
+        }
+    }
+}
 
-            float currDistance2 = glm::distance2(position, currEvent.mPosition);
-            if (i == 0) // very first element if closest by default
-            {
-                closestDistance2 = currDistance2;
-                continue;
-            }
+void BroadcastEventsManager::RestoreEvent(const BroadcastEvent& eventData)
+{
+    debug_assert(eventData.mEventType < eBroadcastEvent_COUNT);
 
-            if (currDistance2 < closestDistance2)
-            {
-                closestDistance2 = currDistance2;
-                bestIndex = i;
-            }
-        }
+    GameObject* subject = eventData.mSubject;
+    // subject object does not exist anymore
+    if ((eventData.mEventSubject != eBroadcastEventSubject_None) && (subject == nullptr))
+        return;
+
+    int slotIndex = AllocateSlot(eventData.mEventType, eventData.mPosition);
+
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    eventSlot.mEventData = eventData;
+    if (subject)
+    {
+        eventSlot.mSubjectKey = subject;
+        mBuckets[eventData.mEventType].mSubjectSlots[subject] = slotIndex;
+    }
+
+    ScheduleExpiration(slotIndex);
+}
+
+int BroadcastEventsManager::GetGridCellIndex(const glm::vec2& position) const
+{
+    glm::ivec2 cell = glm::ivec2(Convert::MetersToMapUnits(position) / (GridCellSize * 1.0f));
+    cell = glm::clamp(cell, glm::ivec2(0), glm::ivec2(GridDimensions - 1));
+    return cell.y * GridDimensions + cell.x;
+}
+
+void BroadcastEventsManager::GetGridCellsRange(const glm::vec2& position, float radius, glm::ivec2& outMin, glm::ivec2& outMax) const
+{
+    glm::vec2 minPosition = Convert::MetersToMapUnits(position - glm::vec2(radius)) / (GridCellSize * 1.0f);
+    glm::vec2 maxPosition = Convert::MetersToMapUnits(position + glm::vec2(radius)) / (GridCellSize * 1.0f);
+
+    outMin = glm::clamp(glm::ivec2(glm::floor(minPosition)), glm::ivec2(0), glm::ivec2(GridDimensions - 1));
+    outMax = glm::clamp(glm::ivec2(glm::floor(maxPosition)), glm::ivec2(0), glm::ivec2(GridDimensions - 1));
+}
+
+int BroadcastEventsManager::AllocateSlot(eBroadcastEvent eventType, const glm::vec2& position)
+{
+    int slotIndex = NullSlot;
+    if (mFreeSlots.empty())
+    {
+        slotIndex = (int) mEventSlots.size();
+        mEventSlots.emplace_back();
     }
-    if (counter)
+    else
     {
-        outputEventData = mEventsList[bestIndex];
-        return true;
+        slotIndex = mFreeSlots.back();
+        mFreeSlots.pop_back();
     }
-    return false;
+
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    debug_assert(!eventSlot.mActive);
+    eventSlot.mActive = true;
+    eventSlot.mSubjectKey = nullptr;
+    eventSlot.mEventData.mEventType = eventType;
+    eventSlot.mGridCell = GetGridCellIndex(position);
+
+    EventsBucket& bucket = mBuckets[eventType];
+    bucket.mGridCells[eventSlot.mGridCell].push_back(slotIndex);
+    ++bucket.mEventsCount;
+    return slotIndex;
 }
 
-bool BroadcastEventsManager::GetEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData)
+void BroadcastEventsManager::FreeSlot(int slotIndex)
 {
-    for (auto curr_event_iterator = mEventsList.begin(); 
-        curr_event_iterator != mEventsList.end(); ++curr_event_iterator)
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    debug_assert(eventSlot.mActive);
+
+    EventsBucket& bucket = mBuckets[eventSlot.mEventData.mEventType];
+    cxx::erase_elements(bucket.mGridCells[eventSlot.mGridCell], slotIndex);
+    if (eventSlot.mSubjectKey)
     {
-        BroadcastEvent& eventData = *curr_event_iterator;
-        if (eventData.mEventType == eventType)
+        // subject key might be already taken by more recent event
+        auto subject_iterator = bucket.mSubjectSlots.find(eventSlot.mSubjectKey);
+        if (subject_iterator != bucket.mSubjectSlots.end() && subject_iterator->second == slotIndex)
         {
-            outputEventData = eventData;
-
-            // remove element
-            mEventsList.erase(curr_event_iterator);
-            return true;
+            bucket.mSubjectSlots.erase(subject_iterator);
         }
+        eventSlot.mSubjectKey = nullptr;
     }
-    return false;
+    --bucket.mEventsCount;
+
+    eventSlot.mEventData.mSubject.reset();
+    eventSlot.mEventData.mCharacter.reset();
+    eventSlot.mActive = false;
+    ++eventSlot.mSerial;
+    mFreeSlots.push_back(slotIndex);
 }
 
-bool BroadcastEventsManager::GetClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData)
+void BroadcastEventsManager::MoveSlotToCell(int slotIndex, int gridCell)
+{
+    EventSlot& eventSlot = mEventSlots[slotIndex];
+    if (eventSlot.mGridCell == gridCell)
+        return;
+
+    EventsBucket& bucket = mBuckets[eventSlot.mEventData.mEventType];
+    cxx::erase_elements(bucket.mGridCells[eventSlot.mGridCell], slotIndex);
+    bucket.mGridCells[gridCell].push_back(slotIndex);
+    eventSlot.mGridCell = gridCell;
+}
+
+void BroadcastEventsManager::ScheduleExpiration(int slotIndex)
 {
-    float closestDistance2 = 0.0f;
-    size_t counter = 0;
-    size_t bestIndex = 0;
-    for (size_t i = 0, Count = mEventsList.size(); i < Count; ++i)
+    const EventSlot& eventSlot = mEventSlots[slotIndex];
+
+    ExpireQueueEntry queueEntry;
+    queueEntry.mExpireTime = eventSlot.mEventData.GetExpireTime();
+    queueEntry.mSlotIndex = slotIndex;
+    queueEntry.mSlotSerial = eventSlot.mSerial;
+    mExpireQueue.push_back(queueEntry);
+    std::push_heap(mExpireQueue.begin(), mExpireQueue.end());
+}
+
+int BroadcastEventsManager::FindClosestSlot(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance) const
+{
+    debug_assert(eventType < eBroadcastEvent_COUNT);
+
+    const EventsBucket& bucket = mBuckets[eventType];
+    if (bucket.mEventsCount == 0)
+        return NullSlot;
+
+    const float cellSizeMeters = Convert::MapUnitsToMeters(GridCellSize * 1.0f);
+
+    int centerCell = GetGridCellIndex(position);
+    int centerX = centerCell % GridDimensions;
+    int centerY = centerCell / GridDimensions;
+
+    bool limitDistance = (maxDistance > 0.0f);
+
+    int bestSlotIndex = NullSlot;
+    float bestDistance2 = limitDistance ? (maxDistance * maxDistance) : 0.0f;
+
+    // walk grid cells in rings around center cell until there's no chance to find closer event
+    for (int currRing = 0; currRing < GridDimensions; ++currRing)
     {
-        const BroadcastEvent& currEvent = mEventsList[i];
-        if (currEvent.mEventType == eventType)
+        if (currRing > 0)
         {
-            ++counter;
+            float ringMinDistance = (currRing - 1) * cellSizeMeters;
+            if (limitDistance && (ringMinDistance > maxDistance))
+                break;
 
-            float currDistance2 = glm::distance2(position, currEvent.mPosition);
-            if (i == 0) // very first element if closest by default
-            {
-                closestDistance2 = currDistance2;
+            if ((bestSlotIndex != NullSlot) && (ringMinDistance * ringMinDistance > bestDistance2))
+                break;
+        }
+
+        for (int cellY = centerY - currRing; cellY <= centerY + currRing; ++cellY)
+        {
+            if (cellY < 0 || cellY >= GridDimensions)
                 continue;
-            }
 
-            if (currDistance2 < closestDistance2)
+            bool isEdgeRow = (cellY == centerY - currRing) || (cellY == centerY + currRing);
+            int stepX = (isEdgeRow || currRing == 0) ? 1 : (currRing * 2);
+            for (int cellX = centerX - currRing; cellX <= centerX + currRing; cellX += stepX)
             {
-                closestDistance2 = currDistance2;
-                bestIndex = i;
+                if (cellX < 0 || cellX >= GridDimensions)
+                    continue;
+
+                for (int currSlotIndex: bucket.mGridCells[cellY * GridDimensions + cellX])
+                {
+                    float currDistance2 = glm::distance2(position, mEventSlots[currSlotIndex].mEventData.mPosition);
+                    if (bestSlotIndex == NullSlot)
+                    {
+                        if (limitDistance && (currDistance2 > bestDistance2))
+                            continue;
+                    }
+                    else if (currDistance2 >= bestDistance2)
+                        continue;
+
+                    bestDistance2 = currDistance2;
+                    bestSlotIndex = currSlotIndex;
+                }
             }
         }
     }
-    if (counter)
-    {
-        outputEventData = mEventsList[bestIndex];
+    return bestSlotIndex;
+}
 
-        // remove element
-        mEventsList.erase(mEventsList.begin() + bestIndex);
-        return true;
+int BroadcastEventsManager::FindFirstSlot(eBroadcastEvent eventType) const
+{
+    debug_assert(eventType < eBroadcastEvent_COUNT);
+
+    if (mBuckets[eventType].mEventsCount == 0)
+        return NullSlot;
+
+    for (size_t islot = 0, Count = mEventSlots.size(); islot < Count; ++islot)
+    {
+        const EventSlot& eventSlot = mEventSlots[islot];
+        if (eventSlot.mActive && (eventSlot.mEventData.mEventType == eventType))
+            return (int) islot;
     }
-    return false;
+    debug_assert(false);
+    return NullSlot;
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ enum eBroadcastEvent
     eBroadcastEvent_StealCar,
     eBroadcastEvent_Explosion,
     eBroadcastEvent_CarBurns,
+    eBroadcastEvent_COUNT
 };
 
 decl_enum_strings(eBroadcastEvent);
@@ -33,8 +34,13 @@ struct BroadcastEvent
 public:
     BroadcastEvent() = default;
 
+    inline float GetExpireTime() const
+    {
+        return mEventTimestamp + mEventDurationTime;
+    }
+
 public:
-    eBroadcastEvent mEventType; 
+    eBroadcastEvent mEventType;
     eBroadcastEventSubject mEventSubject;
 
     float mEventTimestamp; // time when event was created
@@ -43,10 +49,12 @@ public:
     glm::vec2 mPosition; // position in the world where event did happen, meters
 
     GameObjectHandle mSubject; // object that was affected
-    PedestrianHandle mCharacter; // character which causes event 
+    PedestrianHandle mCharacter; // character which causes event
 };
 
 // Broadcast events manager
+// Events are kept in buckets by type, each bucket indexes its events with a coarse spatial grid,
+// so that proximity queries only visit events located near the point of interest
 class BroadcastEventsManager final: public cxx::noncopyable
 {
 public:
@@ -60,12 +68,83 @@ public:
     // Finds event with specific type but don't removes it from list
     bool PeekEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData) const;
     bool PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData) const;
+    bool PeekClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance, BroadcastEvent& outputEventData) const;
     // Finds event with specific type and removes it from list
     bool GetEvent(eBroadcastEvent eventType, BroadcastEvent& outputEventData);
     bool GetClosestEvent(eBroadcastEvent eventType, const glm::vec2& position, BroadcastEvent& outputEventData);
 
+    // Collect all events with specific type located within radius around point
+    // @param eventType: Event type
+    // @param position: Search center, meters
+    // @param radius: Search radius, meters
+    // @param outputEvents: Output list, found events will be appended
+    // @returns number of events found
+    int QueryEventsInRadius(eBroadcastEvent eventType, const glm::vec2& position, float radius, std::vector<BroadcastEvent>& outputEvents) const;
+
+    // Get number of active events with specific type
+    int GetEventsCount(eBroadcastEvent eventType) const;
+
+    // Collect all active events, used to save game state
+    // @param outputEvents: Output list, events will be appended
+    void CollectEvents(std::vector<BroadcastEvent>& outputEvents) const;
+
+    // Add event with original timestamp and duration, used to restore game state
+    // @param eventData: Event data
+    void RestoreEvent(const BroadcastEvent& eventData);
+
+private:
+    static const int GridCellSize = 8; // map blocks per grid cell side
+    static const int GridDimensions = (MAP_DIMENSIONS + GridCellSize - 1) / GridCellSize;
+    static const int NullSlot = -1;
+
+    // expiration queue element
+    struct ExpireQueueEntry
+    {
+        float mExpireTime;
+        int mSlotIndex;
+        unsigned int mSlotSerial; // to detect slot reuse
+
+        inline bool operator < (const ExpireQueueEntry& rhs) const
+        {
+            return mExpireTime > rhs.mExpireTime; // min-heap
+        }
+    };
+
+    // event storage slot
+    struct EventSlot
+    {
+        BroadcastEvent mEventData;
+        GameObject* mSubjectKey = nullptr; // key in subject slots map, pointer is never dereferenced
+        int mGridCell = 0;
+        unsigned int mSerial = 0;
+        bool mActive = false;
+    };
+
+    // events of specific type
+    struct EventsBucket
+    {
+        std::vector<int> mGridCells[GridDimensions * GridDimensions]; // slots per cell
+        std::map<GameObject*, int> mSubjectSlots; // slots of events bound to subject
+        int mEventsCount = 0;
+    };
+
+private:
+    int GetGridCellIndex(const glm::vec2& position) const;
+    void GetGridCellsRange(const glm::vec2& position, float radius, glm::ivec2& outMin, glm::ivec2& outMax) const;
+
+    int AllocateSlot(eBroadcastEvent eventType, const glm::vec2& position);
+    void FreeSlot(int slotIndex);
+    void MoveSlotToCell(int slotIndex, int gridCell);
+    void ScheduleExpiration(int slotIndex);
+
+    int FindClosestSlot(eBroadcastEvent eventType, const glm::vec2& position, float maxDistance) const;
+    int FindFirstSlot(eBroadcastEvent eventType) const;
+
 private:
-    std::vector<BroadcastEvent> mEventsList;
+    std::vector<EventSlot> mEventSlots;
+    std::vector<int> mFreeSlots;
+    std::vector<ExpireQueueEntry> mExpireQueue; // heap ordered by expiration time
+    EventsBucket mBuckets[eBroadcastEvent_COUNT];
 };
 
 extern BroadcastEventsManager gBroadcastEvents;
\ No newline at end of file
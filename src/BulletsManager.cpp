@@ -0,0 +1,288 @@
+#include "stdafx.h"
+#include "BulletsManager.h"
+#include "WeaponInfo.h"
+#include "GameMapManager.h"
+#include "PhysicsManager.h"
+#include "PhysicsComponents.h"
+#include "GameObjectsManager.h"
+#include "TimeManager.h"
+#include "SpriteManager.h"
+#include "AudioManager.h"
+#include "DebugRenderer.h"
+#include "Pedestrian.h"
+#include "Vehicle.h"
+#include "ParticleEffectsManager.h"
+
+BulletsManager gBulletsManager;
+
+void BulletsStats::FrameBegin()
+{
+    mBulletsCreated = 0;
+    mBulletsHits = 0;
+    mSegmentsTraced = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void BulletsManager::UpdateFrame()
+{
+    double updateStartTime = gSystem.GetSystemSeconds();
+
+    mStats.FrameBegin();
+
+    float deltaTime = gTimeManager.mGameFrameDelta;
+    if (deltaTime > 0.0f)
+    {
+        for (int ibullet = 0; ibullet < GetBulletsCount(); )
+        {
+            mLifeTimes[ibullet] += deltaTime;
+
+            float moveDistance = std::min(mWeaponInfos[ibullet]->mProjectileSpeed * deltaTime, mDistancesLeft[ibullet]);
+
+            glm::vec2 origin = mPositions[ibullet];
+            glm::vec2 destination = origin + mDirections[ibullet] * moveDistance;
+            if (TraceBullet(ibullet, origin, destination))
+            {
+                DestroyBullet(ibullet);
+                continue;
+            }
+
+            mPositions[ibullet] = destination;
+            mDistancesLeft[ibullet] -= moveDistance;
+            if (mDistancesLeft[ibullet] <= 0.0f)
+            {
+                DestroyBullet(ibullet);
+                continue;
+            }
+            ++ibullet;
+        }
+    }
+
+    mStats.mBulletsCount = GetBulletsCount();
+    mStats.mUpdateTime = (float) ((gSystem.GetSystemSeconds() - updateStartTime) * 1000.0);
+}
+
+void BulletsManager::PreDrawFrame()
+{
+    StyleData& cityStyle = gGameMap.mStyleData;
+
+    int bulletsCount = GetBulletsCount();
+    mDrawSprites.resize(bulletsCount);
+    for (int ibullet = 0; ibullet < bulletsCount; ++ibullet)
+    {
+        Sprite2D& drawSprite = mDrawSprites[ibullet];
+
+        // bullets animation is played once and then holds last frame
+        int spriteIndex = 0;
+        int objectindex = mWeaponInfos[ibullet]->mProjectileObject;
+        if (objectindex > 0 && objectindex < (int) cityStyle.mObjects.size())
+        {
+            const SpriteAnimData& animData = cityStyle.mObjects[objectindex].mAnimationData;
+
+            int framesCount = animData.GetFramesCount();
+            if (framesCount > 0)
+            {
+                int frameIndex = std::min((int) (mLifeTimes[ibullet] * 24.0f), framesCount - 1); // todo: move to config
+                spriteIndex = animData.mFrames[frameIndex].mSprite;
+            }
+        }
+
+        gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, spriteIndex, 0, drawSprite);
+
+        const glm::vec2& position = mPositions[ibullet];
+        drawSprite.mPosition = position;
+        drawSprite.mRotateAngle = mHeadings[ibullet] + cxx::angle_t::from_degrees(SPRITE_ZERO_ANGLE);
+        drawSprite.mDrawOrder = eSpriteDrawOrder_Projectiles;
+        drawSprite.mHeight = std::max(mHeights[ibullet], gGameMap.GetHeightAtPosition(glm::vec3(position.x, mHeights[ibullet], position.y)));
+    }
+}
+
+void BulletsManager::DebugDraw(DebugRenderer& debugRender)
+{
+    for (int ibullet = 0, Count = GetBulletsCount(); ibullet < Count; ++ibullet)
+    {
+        glm::vec3 position (mPositions[ibullet].x, mHeights[ibullet], mPositions[ibullet].y);
+
+        cxx::bounding_sphere_t bsphere (position, mWeaponInfos[ibullet]->mProjectileSize);
+        debugRender.DrawSphere(bsphere, Color32_Orange, false);
+    }
+}
+
+void BulletsManager::ClearBullets()
+{
+    mPositions.clear();
+    mDirections.clear();
+    mHeights.clear();
+    mDistancesLeft.clear();
+    mLifeTimes.clear();
+    mHeadings.clear();
+    mWeaponInfos.clear();
+    mShooters.clear();
+    mDrawSprites.clear();
+
+    mStats.mBulletsCount = 0;
+}
+
+void BulletsManager::CreateBullet(const glm::vec3& position, cxx::angle_t heading, WeaponInfo* weaponInfo, Pedestrian* shooter)
+{
+    if (weaponInfo == nullptr || !weaponInfo->IsBulletDamage())
+    {
+        debug_assert(false);
+        return;
+    }
+
+    glm::vec2 direction;
+    heading.get_sin_cos(direction.y, direction.x);
+
+    mPositions.emplace_back(position.x, position.z);
+    mDirections.push_back(direction);
+    mHeights.push_back(position.y);
+    mDistancesLeft.push_back(weaponInfo->mBaseHitRange);
+    mLifeTimes.push_back(0.0f);
+    mHeadings.push_back(heading);
+    mWeaponInfos.push_back(weaponInfo);
+    mShooters.emplace_back(shooter);
+
+    ++mStats.mBulletsCreated;
+}
+
+bool BulletsManager::TraceBullet(int bulletIndex, const glm::vec2& origin, const glm::vec2& destination)
+{
+    ++mStats.mSegmentsTraced;
+
+    float height = mHeights[bulletIndex];
+
+    // find closest solid block on the way
+    glm::vec2 hitPoint = destination;
+    bool hasMapHit = false;
+    {
+        int layer = (int) (Convert::MetersToMapUnits(height) + 0.5f);
+
+        glm::vec2 mapHitPoint;
+        if (gGameMap.TraceSegment2D(Convert::MetersToMapUnits(origin), Convert::MetersToMapUnits(destination), layer * 1.0f, mapHitPoint))
+        {
+            mapHitPoint = Convert::MapUnitsToMeters(mapHitPoint);
+            // trace might step beyond segment end
+            if (glm::distance2(origin, mapHitPoint) <= glm::distance2(origin, destination))
+            {
+                hitPoint = mapHitPoint;
+                hasMapHit = true;
+            }
+        }
+    }
+
+    // find objects on the way, up to closest solid block
+    PhysicsLinecastResult linecastResult;
+    gPhysics.QueryObjectsLinecast(origin, hitPoint, linecastResult);
+
+    struct HitCandidate
+    {
+        GameObject* mObject;
+        glm::vec2 mPoint;
+        float mDistance2;
+    };
+    HitCandidate candidates[MaxPhysicsQueryElements];
+    int candidatesCount = 0;
+
+    Pedestrian* shooter = mShooters[bulletIndex];
+    for (int ihit = 0; ihit < linecastResult.mHitsCount; ++ihit)
+    {
+        const PhysicsLinecastHit& currHit = linecastResult.mHits[ihit];
+
+        GameObject* hitObject = nullptr;
+        float objectHeight = 0.0f;
+        if (currHit.mPedComponent)
+        {
+            if (currHit.mPedComponent->mReferencePed == shooter) // ignore shooter ped
+                continue;
+
+            hitObject = currHit.mPedComponent->mReferencePed;
+            objectHeight = currHit.mPedComponent->mHeight;
+        }
+        else if (currHit.mCarComponent)
+        {
+            hitObject = currHit.mCarComponent->mReferenceCar;
+            objectHeight = currHit.mCarComponent->mHeight;
+        }
+
+        // check object bounds height
+        // todo: get object height!
+        if ((hitObject == nullptr) || (height < objectHeight) || (height > (objectHeight + 2.0f)))
+            continue;
+
+        HitCandidate& candidate = candidates[candidatesCount++];
+        candidate.mObject = hitObject;
+        candidate.mPoint = currHit.mIntersectionPoint;
+        candidate.mDistance2 = glm::distance2(origin, currHit.mIntersectionPoint);
+    }
+
+    std::sort(candidates, candidates + candidatesCount, [](const HitCandidate& lhs, const HitCandidate& rhs)
+        {
+            return lhs.mDistance2 < rhs.mDistance2;
+        });
+
+    WeaponInfo* weaponInfo = mWeaponInfos[bulletIndex];
+    for (int icandidate = 0; icandidate < candidatesCount; ++icandidate)
+    {
+        const HitCandidate& candidate = candidates[icandidate];
+
+        DamageInfo damageInfo;
+        damageInfo.SetDamageFromWeapon(*weaponInfo, shooter);
+        if (!candidate.mObject->ReceiveDamage(damageInfo) && candidate.mObject->IsPedestrianClass())
+            continue; // fly through
+
+        ProcessBulletHit(bulletIndex, glm::vec3(candidate.mPoint.x, height, candidate.mPoint.y), candidate.mObject);
+        return true;
+    }
+
+    if (hasMapHit)
+    {
+        ProcessBulletHit(bulletIndex, glm::vec3(hitPoint.x, height, hitPoint.y), nullptr);
+        return true;
+    }
+    return false;
+}
+
+void BulletsManager::ProcessBulletHit(int bulletIndex, const glm::vec3& hitPoint, GameObject* hitObject)
+{
+    ++mStats.mBulletsHits;
+
+    WeaponInfo* weaponInfo = mWeaponInfos[bulletIndex];
+    if (weaponInfo->mProjectileHitEffect > GameObjectType_Null)
+    {
+        gParticleEffects.EmitHitEffect(weaponInfo->mProjectileHitEffect, hitPoint);
+    }
+
+    if (weaponInfo->mProjectileHitObjectSound != -1)
+    {
+        gAudioManager.PlaySfxLevel(weaponInfo->mProjectileHitObjectSound, hitPoint, false);
+    }
+}
+
+void BulletsManager::DestroyBullet(int bulletIndex)
+{
+    debug_assert(bulletIndex > -1 && bulletIndex < GetBulletsCount());
+
+    // move last bullet in place of destroyed one
+    int lastIndex = GetBulletsCount() - 1;
+    if (bulletIndex != lastIndex)
+    {
+        mPositions[bulletIndex] = mPositions[lastIndex];
+        mDirections[bulletIndex] = mDirections[lastIndex];
+        mHeights[bulletIndex] = mHeights[lastIndex];
+        mDistancesLeft[bulletIndex] = mDistancesLeft[lastIndex];
+        mLifeTimes[bulletIndex] = mLifeTimes[lastIndex];
+        mHeadings[bulletIndex] = mHeadings[lastIndex];
+        mWeaponInfos[bulletIndex] = mWeaponInfos[lastIndex];
+        mShooters[bulletIndex] = mShooters[lastIndex];
+    }
+
+    mPositions.pop_back();
+    mDirections.pop_back();
+    mHeights.pop_back();
+    mDistancesLeft.pop_back();
+    mLifeTimes.pop_back();
+    mHeadings.pop_back();
+    mWeaponInfos.pop_back();
+    mShooters.pop_back();
+}
\ No newline at end of file
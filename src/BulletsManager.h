@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GameDefs.h"
+#include "Sprite2D.h"
+
+class WeaponInfo;
+class DebugRenderer;
+
+// bullets simulation counters
+struct BulletsStats
+{
+public:
+    BulletsStats() = default;
+    void FrameBegin();
+
+public:
+    int mBulletsCount = 0; // currently active
+    int mBulletsCreated = 0; // per frame
+    int mBulletsHits = 0; // per frame
+    int mSegmentsTraced = 0; // per frame
+    float mUpdateTime = 0.0f; // per frame, milliseconds
+};
+
+// Fast bullet-class projectiles manager
+// Bullets are simulated without physics bodies by tracing segment they pass each frame against map blocks
+// and physics objects, slow projectiles such as missiles or flame are still handled by Box2D
+class BulletsManager final: public cxx::noncopyable
+{
+public:
+    // readonly
+    std::vector<Sprite2D> mDrawSprites; // refreshed in PreDrawFrame, one per bullet
+
+    BulletsStats mStats;
+
+public:
+    void UpdateFrame();
+    void PreDrawFrame();
+    void DebugDraw(DebugRenderer& debugRender);
+
+    // Destroy all active bullets
+    void ClearBullets();
+
+    // Launch new bullet
+    // @param position: Start position, meters
+    // @param heading: Fly direction
+    // @param weaponInfo: Weapon which fires bullet, must be bullet damage weapon
+    // @param shooter: Pedestrian which fires bullet, optional
+    void CreateBullet(const glm::vec3& position, cxx::angle_t heading, WeaponInfo* weaponInfo, Pedestrian* shooter);
+
+    inline int GetBulletsCount() const { return (int) mPositions.size(); }
+
+private:
+    // Trace bullet path within current frame
+    // @returns true if bullet hit something
+    bool TraceBullet(int bulletIndex, const glm::vec2& origin, const glm::vec2& destination);
+    void ProcessBulletHit(int bulletIndex, const glm::vec3& hitPoint, GameObject* hitObject);
+    void DestroyBullet(int bulletIndex);
+
+private:
+    // bullets data, each property is stored in separate array
+    std::vector<glm::vec2> mPositions; // meters
+    std::vector<glm::vec2> mDirections; // normalized
+    std::vector<float> mHeights; // meters
+    std::vector<float> mDistancesLeft; // meters
+    std::vector<float> mLifeTimes; // seconds
+    std::vector<cxx::angle_t> mHeadings;
+    std::vector<WeaponInfo*> mWeaponInfos;
+    std::vector<PedestrianHandle> mShooters;
+};
+
+extern BulletsManager gBulletsManager;
\ No newline at end of file
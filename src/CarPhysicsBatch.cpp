@@ -0,0 +1,313 @@
+#include "stdafx.h"
+#include "CarPhysicsBatch.h"
+#include "PhysicsComponents.h"
+#include "Box2D_Helpers.h"
+#include "Vehicle.h"
+
+void CarPhysicsBatch::SimulationStep(const std::vector<PhysicsBody*>& carsBodies, float steerTimeDelta)
+{
+    GatherCars(carsBodies);
+    ComputeDynamics(steerTimeDelta);
+    ScatterCars(carsBodies);
+}
+
+int CarPhysicsBatch::ValidationStep(const std::vector<PhysicsBody*>& carsBodies, float steerTimeDelta, float& maxError)
+{
+    GatherCars(carsBodies);
+    ComputeDynamics(steerTimeDelta);
+
+    const float Tolerance = 0.001f;
+
+    int mismatchCount = 0;
+    maxError = 0.0f;
+    for (int icar = 0; icar < mCarsCount; ++icar)
+    {
+        CarPhysicsBody* carBody = static_cast<CarPhysicsBody*>(carsBodies[icar]);
+        const CarPhysicsBody::DynamicsForces forces = carBody->UpdateDynamics();
+
+        const b2Body* physicsBody = carBody->mPhysicsBody;
+        const float carErrors[] =
+        {
+            fabsf(physicsBody->GetLinearVelocity().x - mVelocityX[icar]) / std::max(1.0f, fabsf(mVelocityX[icar])),
+            fabsf(physicsBody->GetLinearVelocity().y - mVelocityY[icar]) / std::max(1.0f, fabsf(mVelocityY[icar])),
+            fabsf(physicsBody->GetAngularVelocity() - mAngularVelocity[icar]) / std::max(1.0f, fabsf(mAngularVelocity[icar])),
+            fabsf(carBody->mSteeringAngleRadians - mSteeringAngle[icar]),
+            fabsf(forces.mForce.x - mForceX[icar]) / std::max(1.0f, fabsf(mForceX[icar])),
+            fabsf(forces.mForce.y - mForceY[icar]) / std::max(1.0f, fabsf(mForceY[icar])),
+            fabsf(forces.mTorque - mTorque[icar]) / std::max(1.0f, fabsf(mTorque[icar])),
+        };
+        float carMaxError = *std::max_element(std::begin(carErrors), std::end(carErrors));
+        if (carMaxError > Tolerance)
+        {
+            ++mismatchCount;
+        }
+        maxError = std::max(maxError, carMaxError);
+    }
+    return mismatchCount;
+}
+
+void CarPhysicsBatch::GatherCars(const std::vector<PhysicsBody*>& carsBodies)
+{
+    mCarsCount = (int) carsBodies.size();
+
+    for (std::vector<float>* currArray:
+        {
+            &mOriginX, &mOriginY, &mCenterX, &mCenterY, &mRotationCos, &mRotationSin, &mSteeringCos, &mSteeringSin,
+            &mMass, &mInvMass, &mInvInertia, &mFrontTireOffset, &mRearTireOffset, &mBrakeFactor, &mDriveDirection, &mSteerDirection,
+            &mVelocityX, &mVelocityY, &mAngularVelocity, &mSteeringAngle, &mForceX, &mForceY, &mTorque
+        })
+    {
+        currArray->resize(mCarsCount);
+    }
+
+    for (int icar = 0; icar < mCarsCount; ++icar)
+    {
+        CarPhysicsBody* carBody = static_cast<CarPhysicsBody*>(carsBodies[icar]);
+        const b2Body* physicsBody = carBody->mPhysicsBody;
+
+        const b2Transform& transform = physicsBody->GetTransform();
+        mOriginX[icar] = transform.p.x;
+        mOriginY[icar] = transform.p.y;
+        mRotationCos[icar] = transform.q.c;
+        mRotationSin[icar] = transform.q.s;
+
+        const b2Vec2& center = physicsBody->GetWorldCenter();
+        mCenterX[icar] = center.x;
+        mCenterY[icar] = center.y;
+
+        b2Rot steeringRotation (carBody->mSteeringAngleRadians);
+        mSteeringCos[icar] = steeringRotation.c;
+        mSteeringSin[icar] = steeringRotation.s;
+        mSteeringAngle[icar] = carBody->mSteeringAngleRadians;
+
+        // physics body does not expose inverse mass and inertia
+        float mass = physicsBody->GetMass();
+        const b2Vec2& localCenter = physicsBody->GetLocalCenter();
+        float centerInertia = physicsBody->GetInertia() - mass * b2Dot(localCenter, localCenter);
+        mMass[icar] = mass;
+        mInvMass[icar] = (mass > 0.0f) ? (1.0f / mass) : 0.0f;
+        mInvInertia[icar] = (centerInertia > 0.0f && !physicsBody->IsFixedRotation()) ? (1.0f / centerInertia) : 0.0f;
+
+        mFrontTireOffset[icar] = carBody->mFrontTireOffset;
+        mRearTireOffset[icar] = carBody->mRearTireOffset;
+        mBrakeFactor[icar] = carBody->mCarDesc->mHandbrakeFriction;
+
+        CarPhysicsBody::DriveCtlState currCtlState;
+        carBody->GetDriveCtlState(currCtlState);
+        mDriveDirection[icar] = currCtlState.mDriveDirection;
+        mSteerDirection[icar] = currCtlState.mSteerDirection;
+
+        const b2Vec2& velocity = physicsBody->GetLinearVelocity();
+        mVelocityX[icar] = velocity.x;
+        mVelocityY[icar] = velocity.y;
+        mAngularVelocity[icar] = physicsBody->GetAngularVelocity();
+    }
+}
+
+// arrays never overlap, restrict qualified members of structure passed by value let compiler know that
+// stores do not alias loads, restrict qualified local variables are not enough for that
+struct CarsDynamicsArrays
+{
+public:
+    const float* __restrict mOriginX;
+    const float* __restrict mOriginY;
+    const float* __restrict mCenterX;
+    const float* __restrict mCenterY;
+    const float* __restrict mRotationCos;
+    const float* __restrict mRotationSin;
+    const float* __restrict mSteeringCos;
+    const float* __restrict mSteeringSin;
+    const float* __restrict mMass;
+    const float* __restrict mInvMass;
+    const float* __restrict mInvInertia;
+    const float* __restrict mFrontTireOffset;
+    const float* __restrict mRearTireOffset;
+    const float* __restrict mBrakeFactor;
+    const float* __restrict mDriveDirection;
+    const float* __restrict mSteerDirection;
+
+    float* __restrict mVelocityX;
+    float* __restrict mVelocityY;
+    float* __restrict mAngularVelocity;
+    float* __restrict mSteeringAngle;
+    float* __restrict mForceX;
+    float* __restrict mForceY;
+    float* __restrict mTorque;
+};
+
+static void ComputeCarsDynamics(int carsCount, CarsDynamicsArrays arrays, float steerTimeDelta)
+{
+    const float LateralImpulseFactor = CarPhysicsBody::TireLateralImpulseFactor;
+    const float RollingResistanceCoef = CarPhysicsBody::RollingResistanceCoef;
+    const float DragForceCoef = CarPhysicsBody::DragForceCoef;
+    const float DriveForce = CarPhysicsBody::DriveForce;
+    const float ReverseForce = CarPhysicsBody::DriveForce * CarPhysicsBody::ReverseForceFactor;
+    const float LockAngleRadians = glm::radians(CarPhysicsBody::SteerLockAngleDegrees);
+    const float TurnPerTimeStep = glm::radians(CarPhysicsBody::SteerTurnSpeedDegrees) * steerTimeDelta;
+
+    const float* originX = arrays.mOriginX;
+    const float* originY = arrays.mOriginY;
+    const float* centerX = arrays.mCenterX;
+    const float* centerY = arrays.mCenterY;
+    const float* rotationCos = arrays.mRotationCos;
+    const float* rotationSin = arrays.mRotationSin;
+    const float* steeringCos = arrays.mSteeringCos;
+    const float* steeringSin = arrays.mSteeringSin;
+    const float* mass = arrays.mMass;
+    const float* invMass = arrays.mInvMass;
+    const float* invInertia = arrays.mInvInertia;
+    const float* frontTireOffset = arrays.mFrontTireOffset;
+    const float* rearTireOffset = arrays.mRearTireOffset;
+    const float* brakeFactor = arrays.mBrakeFactor;
+    const float* driveDirection = arrays.mDriveDirection;
+    const float* steerDirection = arrays.mSteerDirection;
+
+    float* velocityX = arrays.mVelocityX;
+    float* velocityY = arrays.mVelocityY;
+    float* angularVelocity = arrays.mAngularVelocity;
+    float* steeringAngle = arrays.mSteeringAngle;
+    float* forceX = arrays.mForceX;
+    float* forceY = arrays.mForceY;
+    float* torque = arrays.mTorque;
+
+    // no branches inside so compiler is able to vectorize loop, conditions only select between constants,
+    // otherwise compiler moves computation of selected value into branch since floating point operations may trap
+    for (int icar = 0; icar < carsCount; ++icar)
+    {
+        float vx = velocityX[icar];
+        float vy = velocityY[icar];
+        float w = angularVelocity[icar];
+
+        // body forward direction
+        float forwardX = rotationCos[icar];
+        float forwardY = rotationSin[icar];
+
+        // front tire lateral direction
+        float frontForwardX = forwardX * steeringCos[icar] - forwardY * steeringSin[icar];
+        float frontForwardY = forwardY * steeringCos[icar] + forwardX * steeringSin[icar];
+        float frontLateralX = -frontForwardY;
+        float frontLateralY = frontForwardX;
+
+        // rear tire lateral direction
+        float rearLateralX = -forwardY;
+        float rearLateralY = forwardX;
+
+        // tires positions relative to center of mass
+        float frontArmX = originX[icar] + forwardX * frontTireOffset[icar] - centerX[icar];
+        float frontArmY = originY[icar] + forwardY * frontTireOffset[icar] - centerY[icar];
+        float rearArmX = originX[icar] + forwardX * rearTireOffset[icar] - centerX[icar];
+        float rearArmY = originY[icar] + forwardY * rearTireOffset[icar] - centerY[icar];
+
+        // rolling resistance and drag are computed from velocity before tires impulses
+        float linearSpeed = sqrtf(vx * vx + vy * vy);
+        float movingMask = (linearSpeed < b2_epsilon) ? 0.0f : 1.0f;
+        float invLinearSpeed = movingMask / (linearSpeed + (1.0f - movingMask)); // zero when not moving
+        float directionX = vx * invLinearSpeed;
+        float directionY = vy * invLinearSpeed;
+
+        // kill lateral velocity front tire, impulse changes velocity immediately
+        float frontLateralSpeed = frontLateralX * (vx - w * frontArmY) + frontLateralY * (vy + w * frontArmX);
+        float frontImpulse = -mass[icar] * LateralImpulseFactor * frontLateralSpeed;
+        float frontImpulseX = frontImpulse * frontLateralX;
+        float frontImpulseY = frontImpulse * frontLateralY;
+        vx += invMass[icar] * frontImpulseX;
+        vy += invMass[icar] * frontImpulseY;
+        w += invInertia[icar] * (frontArmX * frontImpulseY - frontArmY * frontImpulseX);
+
+        // kill lateral velocity rear tire
+        float rearLateralSpeed = rearLateralX * (vx - w * rearArmY) + rearLateralY * (vy + w * rearArmX);
+        float rearImpulse = -mass[icar] * LateralImpulseFactor * rearLateralSpeed;
+        float rearImpulseX = rearImpulse * rearLateralX;
+        float rearImpulseY = rearImpulse * rearLateralY;
+        vx += invMass[icar] * rearImpulseX;
+        vy += invMass[icar] * rearImpulseY;
+        w += invInertia[icar] * (rearArmX * rearImpulseY - rearArmY * rearImpulseX);
+
+        // rolling resistance on both tires and drag force at center
+        float rollingForceX = -RollingResistanceCoef * directionX;
+        float rollingForceY = -RollingResistanceCoef * directionY;
+        float dragForce = -DragForceCoef * linearSpeed;
+        float fx = rollingForceX * 2.0f + dragForce * directionX;
+        float fy = rollingForceY * 2.0f + dragForce * directionY;
+        float t = (frontArmX + rearArmX) * rollingForceY - (frontArmY + rearArmY) * rollingForceX;
+
+        // drive force on rear tire, current speed includes tires impulses
+        float currentSpeed = forwardX * vx + forwardY * vy;
+        float brakeMask = (currentSpeed > 0.0f) ? 1.0f : 0.0f;
+        float forwardMask = (driveDirection[icar] > 0.0f) ? 1.0f : 0.0f;
+        float brakeOrReverseForce = brakeMask * DriveForce * brakeFactor[icar] + (1.0f - brakeMask) * ReverseForce;
+        float engineForce = forwardMask * DriveForce + (1.0f - forwardMask) * brakeOrReverseForce;
+        float driveForceX = engineForce * driveDirection[icar] * forwardX;
+        float driveForceY = engineForce * driveDirection[icar] * forwardY;
+        fx += driveForceX;
+        fy += driveForceY;
+        t += rearArmX * driveForceY - rearArmY * driveForceX;
+
+        // steering, clamped by value selects instead of std::min and std::max which return references
+        float desiredAngle = LockAngleRadians * steerDirection[icar];
+        float angleToTurn = desiredAngle - steeringAngle[icar];
+        angleToTurn = (angleToTurn < TurnPerTimeStep) ? angleToTurn : TurnPerTimeStep;
+        angleToTurn = (angleToTurn > -TurnPerTimeStep) ? angleToTurn : -TurnPerTimeStep;
+        float newAngle = steeringAngle[icar] + angleToTurn;
+        newAngle = (newAngle < LockAngleRadians) ? newAngle : LockAngleRadians;
+        newAngle = (newAngle > -LockAngleRadians) ? newAngle : -LockAngleRadians;
+        steeringAngle[icar] = newAngle;
+
+        velocityX[icar] = vx;
+        velocityY[icar] = vy;
+        angularVelocity[icar] = w;
+        forceX[icar] = fx;
+        forceY[icar] = fy;
+        torque[icar] = t;
+    }
+}
+
+void CarPhysicsBatch::ComputeDynamics(float steerTimeDelta)
+{
+    CarsDynamicsArrays arrays;
+    arrays.mOriginX = mOriginX.data();
+    arrays.mOriginY = mOriginY.data();
+    arrays.mCenterX = mCenterX.data();
+    arrays.mCenterY = mCenterY.data();
+    arrays.mRotationCos = mRotationCos.data();
+    arrays.mRotationSin = mRotationSin.data();
+    arrays.mSteeringCos = mSteeringCos.data();
+    arrays.mSteeringSin = mSteeringSin.data();
+    arrays.mMass = mMass.data();
+    arrays.mInvMass = mInvMass.data();
+    arrays.mInvInertia = mInvInertia.data();
+    arrays.mFrontTireOffset = mFrontTireOffset.data();
+    arrays.mRearTireOffset = mRearTireOffset.data();
+    arrays.mBrakeFactor = mBrakeFactor.data();
+    arrays.mDriveDirection = mDriveDirection.data();
+    arrays.mSteerDirection = mSteerDirection.data();
+    arrays.mVelocityX = mVelocityX.data();
+    arrays.mVelocityY = mVelocityY.data();
+    arrays.mAngularVelocity = mAngularVelocity.data();
+    arrays.mSteeringAngle = mSteeringAngle.data();
+    arrays.mForceX = mForceX.data();
+    arrays.mForceY = mForceY.data();
+    arrays.mTorque = mTorque.data();
+    ComputeCarsDynamics(mCarsCount, arrays, steerTimeDelta);
+}
+
+void CarPhysicsBatch::ScatterCars(const std::vector<PhysicsBody*>& carsBodies)
+{
+    for (int icar = 0; icar < mCarsCount; ++icar)
+    {
+        CarPhysicsBody* carBody = static_cast<CarPhysicsBody*>(carsBodies[icar]);
+        b2Body* physicsBody = carBody->mPhysicsBody;
+
+        // tires impulses always wake up body
+        if (!physicsBody->IsAwake())
+        {
+            physicsBody->SetAwake(true);
+        }
+        physicsBody->SetLinearVelocity(b2Vec2(mVelocityX[icar], mVelocityY[icar]));
+        physicsBody->SetAngularVelocity(mAngularVelocity[icar]);
+        physicsBody->ApplyForceToCenter(b2Vec2(mForceX[icar], mForceY[icar]), true);
+        physicsBody->ApplyTorque(mTorque[icar], true);
+
+        carBody->mSteeringAngleRadians = mSteeringAngle[icar];
+    }
+}
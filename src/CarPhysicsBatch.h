@@ -0,0 +1,55 @@
+#pragma once
+
+class PhysicsBody;
+
+// Computes tire friction, drive forces and steering of all cars at once
+// Cars state is gathered into structure of arrays, dynamics is computed by single branchless loop,
+// gcc vectorizes it only with -fno-math-errno and full vectorizer cost model since its -O2 skips loops with remainder
+// and then resulting velocities and forces are applied back to physics bodies
+class CarPhysicsBatch final: public cxx::noncopyable
+{
+public:
+    // Process dynamics of all cars, same as CarPhysicsBody::SimulationStep for each car
+    // @param carsBodies: Cars physics bodies
+    // @param steerTimeDelta: Steering time step
+    void SimulationStep(const std::vector<PhysicsBody*>& carsBodies, float steerTimeDelta);
+
+    // Compute batched results, then process cars with scalar implementation and compare resulting
+    // velocities, steering angles and applied forces and torques
+    // @param carsBodies: Cars physics bodies
+    // @param steerTimeDelta: Steering time step
+    // @param maxError: Output largest relative error among all cars
+    // @returns number of cars which results does not match within tolerance
+    int ValidationStep(const std::vector<PhysicsBody*>& carsBodies, float steerTimeDelta, float& maxError);
+
+private:
+    void GatherCars(const std::vector<PhysicsBody*>& carsBodies);
+    void ComputeDynamics(float steerTimeDelta);
+    void ScatterCars(const std::vector<PhysicsBody*>& carsBodies);
+
+private:
+    int mCarsCount = 0;
+
+    // input state, world space
+    std::vector<float> mOriginX, mOriginY; // body position
+    std::vector<float> mCenterX, mCenterY; // center of mass
+    std::vector<float> mRotationCos, mRotationSin; // body rotation
+    std::vector<float> mSteeringCos, mSteeringSin; // front tire rotation relative to body
+    std::vector<float> mMass;
+    std::vector<float> mInvMass;
+    std::vector<float> mInvInertia; // about center of mass
+    std::vector<float> mFrontTireOffset;
+    std::vector<float> mRearTireOffset;
+    std::vector<float> mBrakeFactor; // handbrake friction
+    std::vector<float> mDriveDirection;
+    std::vector<float> mSteerDirection;
+
+    // input and output state
+    std::vector<float> mVelocityX, mVelocityY;
+    std::vector<float> mAngularVelocity;
+    std::vector<float> mSteeringAngle; // radians
+
+    // output state
+    std::vector<float> mForceX, mForceY;
+    std::vector<float> mTorque;
+};
@@ -13,6 +13,10 @@
 #include "GameTextsManager.h"
 #include "BroadcastEventsManager.h"
 #include "AudioManager.h"
+#include "BulletsManager.h"
+#include "ParticleEffectsManager.h"
+#include "GameStateSnapshot.h"
+#include "RenderBenchmark.h"
 
 static const char* InputsConfigPath = "config/inputs.json";
 
@@ -49,19 +53,37 @@ bool CarnageGame::Initialize()
     gGameTexts.Initialize();
     gGameTexts.LoadTexts("ENGLISH.FXT");
 
+    mMapLoader.mParallelStages = !gSystem.mStartupParams.mSerialMapLoading;
+
     // init scenario
-    if (!StartScenario(gSystem.mStartupParams.mDebugMapName))
+    bool scenarioStarted = false;
+    if (!gSystem.mStartupParams.mSnapshotFile.empty())
+    {
+        scenarioStarted = StartScenarioFromSnapshot(gSystem.mStartupParams.mSnapshotFile);
+        if (!scenarioStarted)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Fail to restore game state, starting new game");
+        }
+    }
+
+    if (!scenarioStarted && !StartScenario(gSystem.mStartupParams.mDebugMapName))
     {
         ShutdownCurrentScenario();
 
         gConsole.LogMessage(eLogMessage_Warning, "Fail to start game"); 
         return false;
     }
+
+    if (gSystem.mStartupParams.mRenderBenchmarkFrames > 0)
+    {
+        gRenderBenchmark.Start(gSystem.mStartupParams.mRenderBenchmarkFrames, true);
+    }
     return true;
 }
 
 void CarnageGame::Deinit()
 {
+    mMapLoader.Cleanup();
     ShutdownCurrentScenario();
 
     gGameTexts.Deinit();
@@ -71,12 +93,34 @@ void CarnageGame::UpdateFrame()
 {
     if (!mDebugChangeMapName.empty())
     {
-        gConsole.LogMessage(eLogMessage_Debug, "Changing to next map '%s'", mDebugChangeMapName.c_str());
-        if (!StartScenario(mDebugChangeMapName))
+        gConsole.LogMessage(eLogMessage_Debug, "Loading next map '%s'", mDebugChangeMapName.c_str());
+        mMapLoader.StartLoadingMap(mDebugChangeMapName);
+        mDebugChangeMapName.clear();
+    }
+
+    // current scenario keeps running until next map is loaded in background
+    if (mMapLoader.IsLoaded())
+    {
+        gConsole.LogMessage(eLogMessage_Debug, "Changing to next map '%s'", mMapLoader.mMapName.c_str());
+        if (!StartLoadedScenario(nullptr))
         {
             gConsole.LogMessage(eLogMessage_Warning, "Fail to change map");
         }
-        mDebugChangeMapName.clear();
+    }
+    else if (mMapLoader.IsFailed())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Fail to change map");
+        mMapLoader.Cleanup();
+    }
+
+    if (!mDebugLoadSnapshotPath.empty())
+    {
+        gConsole.LogMessage(eLogMessage_Debug, "Restoring game state from '%s'", mDebugLoadSnapshotPath.c_str());
+        if (!StartScenarioFromSnapshot(mDebugLoadSnapshotPath))
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Fail to restore game state");
+        }
+        mDebugLoadSnapshotPath.clear();
     }
 
     float deltaTime = gTimeManager.mGameFrameDelta;
@@ -84,6 +128,8 @@ void CarnageGame::UpdateFrame()
     gSpriteManager.UpdateBlocksAnimations(deltaTime);
     gPhysics.UpdateFrame();
     gGameObjectsManager.UpdateFrame();
+    gBulletsManager.UpdateFrame();
+    gParticleEffects.UpdateFrame();
 
     for (int ihuman = 0; ihuman < GAME_MAX_PLAYERS; ++ihuman)
     {
@@ -96,6 +142,11 @@ void CarnageGame::UpdateFrame()
     gTrafficManager.UpdateFrame();
     gAiManager.UpdateFrame();
     gBroadcastEvents.UpdateFrame();
+
+    if (gRenderBenchmark.IsRunning())
+    {
+        gRenderBenchmark.UpdateFrame();
+    }
 }
 
 void CarnageGame::InputEventLost()
@@ -320,22 +371,67 @@ void CarnageGame::DebugChangeMap(const std::string& mapName)
     mDebugChangeMapName = mapName;
 }
 
-bool CarnageGame::StartScenario(const std::string& mapName)
+void CarnageGame::DebugSaveSnapshot(const std::string& filePath)
 {
-    ShutdownCurrentScenario();
+    GameStateSnapshot snapshot;
+    snapshot.CaptureGameState();
+    if (snapshot.SaveToFile(filePath))
+    {
+        gConsole.LogMessage(eLogMessage_Info, "Game state saved to '%s'", filePath.c_str());
+    }
+}
+
+void CarnageGame::DebugLoadSnapshot(const std::string& filePath)
+{
+    mDebugLoadSnapshotPath = filePath;
+}
 
-    if (!gGameMap.LoadFromFile(mapName))
+bool CarnageGame::StartScenarioFromSnapshot(const std::string& filePath)
+{
+    double startTime = gSystem.GetSystemSeconds();
+
+    GameStateSnapshot snapshot;
+    if (!snapshot.LoadFromFile(filePath))
+        return false;
+
+    if (!StartScenario(snapshot.mMapName, &snapshot))
     {
-        gConsole.LogMessage(eLogMessage_Warning, "Cannot load map '%s'", mapName.c_str());
+        ShutdownCurrentScenario();
         return false;
     }
-    if (!gAudioManager.LoadLevelSounds())
+
+    gConsole.LogMessage(eLogMessage_Info, "Scenario restored in %.3f s", gSystem.GetSystemSeconds() - startTime);
+    return true;
+}
+
+bool CarnageGame::StartScenario(const std::string& mapName, const GameStateSnapshot* snapshot)
+{
+    if (!mMapLoader.LoadMap(mapName))
+    {
+        mMapLoader.Cleanup();
+        return false;
+    }
+    return StartLoadedScenario(snapshot);
+}
+
+bool CarnageGame::StartLoadedScenario(const GameStateSnapshot* snapshot)
+{
+    debug_assert(mMapLoader.IsLoaded());
+
+    ShutdownCurrentScenario();
+
+    double startTime = gSystem.GetSystemSeconds();
+
+    // take map data prepared by loader, only gpu and physics objects are created here
+    gGameMap.Swap(*mMapLoader.mGameMap);
+
+    if (!gAudioManager.LoadLevelSounds(mMapLoader.mLevelSounds, mMapLoader.mVoiceSounds))
     {
         // ignore
     }
     gSpriteManager.Cleanup();
-    gRenderManager.mMapRenderer.BuildMapMesh();
-    if (!gSpriteManager.InitLevelSprites())
+    gRenderManager.mMapRenderer.BuildMapMesh(mMapLoader.mMapMesh);
+    if (!gSpriteManager.InitLevelSprites(mMapLoader.mBlocksPixels, mMapLoader.mSpritesheetPixels, mMapLoader.mSpritesheetEntries))
     {
         debug_assert(false);
     }
@@ -344,13 +440,45 @@ bool CarnageGame::StartScenario(const std::string& mapName)
     //gSpriteManager.DumpSpriteTextures("D:/Temp/gta1_sprites");
     //gSpriteManager.DumpCarsTextures("D:/Temp/gta_cars");
 
-    if (!gPhysics.InitPhysicsWorld())
+    if (!gPhysics.InitPhysicsWorld(mMapLoader.mMapCollisionBlocks))
     {
         debug_assert(false);
     }
 
+    mMapLoader.Cleanup();
+    gConsole.LogMessage(eLogMessage_Info, "Map resources created in %.3f s", gSystem.GetSystemSeconds() - startTime);
+
     gGameObjectsManager.InitGameObjects();
 
+    if (snapshot)
+    {
+        if (!snapshot->RestoreGameState())
+            return false;
+
+        if (GetHumanPlayersCount() == 0)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Snapshot has no human players");
+            return false;
+        }
+    }
+    else
+    {
+        CreateHumanPlayers();
+    }
+
+    SetInputActionsFromConfig();
+    SetupScreenLayout();
+
+    // restored scenario is already populated
+    if (snapshot == nullptr)
+    {
+        gTrafficManager.StartupTraffic();
+    }
+    return true;
+}
+
+void CarnageGame::CreateHumanPlayers()
+{
     // temporary
     //glm::vec3 pos { 108.0f, 2.0f, 25.0f };
     //glm::vec3 pos { 14.0, 2.0f, 38.0f };
@@ -399,21 +527,19 @@ bool CarnageGame::StartScenario(const std::string& mapName)
         Pedestrian* pedestrian = gGameObjectsManager.CreatePedestrian(pos[icurr], pedestrianHeading, playerPedTypes[icurr]);
         SetupHumanPlayer(icurr, pedestrian);
     }
-
-    SetInputActionsFromConfig();
-    SetupScreenLayout();
-
-    gTrafficManager.StartupTraffic();
-    return true;
 }
 
 void CarnageGame::ShutdownCurrentScenario()
 {
+    gRenderBenchmark.Stop();
+
     for (int ihuman = 0; ihuman < GAME_MAX_PLAYERS; ++ihuman)
     {
         DeleteHumanPlayer(ihuman);
     }
     gAiManager.ReleaseAiControllers();
+    gBulletsManager.ClearBullets();
+    gParticleEffects.ClearParticles();
     gTrafficManager.CleanupTraffic();
     gGameObjectsManager.FreeGameObjects();
     gPhysics.FreePhysicsWorld();
@@ -3,6 +3,9 @@
 #include "GameMapManager.h"
 #include "GameObjectsManager.h"
 #include "HumanPlayer.h"
+#include "MapLoader.h"
+
+class GameStateSnapshot;
 
 // top level game application controller
 class CarnageGame final: public InputEventsHandler
@@ -46,14 +49,31 @@ public:
     // Debug stuff
     void DebugChangeMap(const std::string& mapName);
 
+    // Save current game state or restart scenario from saved game state
+    // @param filePath: Snapshot file path
+    void DebugSaveSnapshot(const std::string& filePath);
+    void DebugLoadSnapshot(const std::string& filePath);
+
 private:
     bool SetInputActionsFromConfig();
 
-    bool StartScenario(const std::string& mapName);
+    // Load map and populate it with objects
+    // @param mapName: Map file name
+    // @param snapshot: Optional game state to restore instead of spawning new players and traffic
+    bool StartScenario(const std::string& mapName, const GameStateSnapshot* snapshot = nullptr);
+
+    // Replace current scenario with map prepared by map loader
+    // @param snapshot: Optional game state to restore instead of spawning new players and traffic
+    bool StartLoadedScenario(const GameStateSnapshot* snapshot);
+    bool StartScenarioFromSnapshot(const std::string& filePath);
+    void CreateHumanPlayers();
     void ShutdownCurrentScenario();
 
 private:
     std::string mDebugChangeMapName;
+    std::string mDebugLoadSnapshotPath;
+
+    MapLoader mMapLoader;
 };
 
 extern CarnageGame gCarnageGame;
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "stdafx.h"
 #include "Console.h"
 
-static char ConsoleMessageBuffer[2048];
+static const char* LogFilePath = "carnage3d.log";
 
 #define VA_SCOPE_OPEN(firstArg, vaName) \
     { \
@@ -14,37 +14,236 @@ static char ConsoleMessageBuffer[2048];
 
 Console gConsole;
 
+Console::Console()
+    : mEnqueuePos(0)
+    , mDroppedMessages(0)
+    , mSinkThreadActive(false)
+    , mSinkThreadQuitRequest(false)
+    , mProcessingMessages(false)
+{
+    static_assert((MaxQueuedMessages & (MaxQueuedMessages - 1)) == 0, "MaxQueuedMessages must be power of two");
+
+    for (int irecord = 0; irecord < MaxQueuedMessages; ++irecord)
+    {
+        mQueue[irecord].mSequence.store(irecord, std::memory_order_relaxed);
+    }
+
+    for (RateLimit& currLimit: mRateLimits)
+    {
+        currLimit.mMaxMessagesPerSecond.store(0, std::memory_order_relaxed);
+        currLimit.mWindowStart.store(0, std::memory_order_relaxed);
+        currLimit.mWindowMessages.store(0, std::memory_order_relaxed);
+    }
+    // debug messages are mostly spammed from update loops
+    mRateLimits[eLogMessage_Debug].mMaxMessagesPerSecond.store(200, std::memory_order_relaxed);
+}
+
 bool Console::Initialize()
 {
+    mLogFile = ::fopen(LogFilePath, "wt");
+    if (mLogFile == nullptr)
+    {
+        LogMessage(eLogMessage_Warning, "Cannot create log file '%s'", LogFilePath);
+    }
+
+    mSinkThreadQuitRequest = false;
+    mSinkThread = std::thread(&Console::SinkThreadProc, this);
+    mSinkThreadActive = true;
     return true;
 }
 
 void Console::Deinit()
 {
+    if (mSinkThreadActive)
+    {
+        mSinkThreadQuitRequest = true;
+        mSinkThread.join();
+        mSinkThreadActive = false;
+    }
+
+    // write leftovers
+    ProcessQueuedMessages();
+
+    if (mLogFile)
+    {
+        ::fclose(mLogFile);
+        mLogFile = nullptr;
+    }
 }
 
 void Console::LogMessage(eLogMessage messageCat, const char* format, ...)
 {
+    if (!CheckRateLimit(messageCat))
+    {
+        mDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // claim queue record
+    LogRecord* logRecord = nullptr;
+    unsigned int enqueuePos = mEnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        logRecord = &mQueue[enqueuePos & (MaxQueuedMessages - 1)];
+
+        unsigned int sequence = logRecord->mSequence.load(std::memory_order_acquire);
+        int difference = (int) (sequence - enqueuePos);
+        if (difference == 0)
+        {
+            if (mEnqueuePos.compare_exchange_weak(enqueuePos, enqueuePos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0) // queue is full
+        {
+            mDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            enqueuePos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // format text directly into record, so there is no shared buffer
     VA_SCOPE_OPEN(format, vaList)
-    vsnprintf(ConsoleMessageBuffer, sizeof(ConsoleMessageBuffer), format, vaList);
+    vsnprintf(logRecord->mText, sizeof(logRecord->mText), format, vaList);
     VA_SCOPE_CLOSE(vaList)
 
+    logRecord->mMessageCategory = messageCat;
+    // publish
+    logRecord->mSequence.store(enqueuePos + 1, std::memory_order_release);
+
+    // there is no sink thread before initialization or after shutdown
+    if (!mSinkThreadActive)
+    {
+        ProcessQueuedMessages();
+    }
+}
+
+void Console::SetRateLimit(eLogMessage messageCat, int maxMessagesPerSecond)
+{
+    debug_assert(messageCat < eLogMessage_COUNT);
+    debug_assert(maxMessagesPerSecond >= 0);
+
+    mRateLimits[messageCat].mMaxMessagesPerSecond.store(std::max(maxMessagesPerSecond, 0), std::memory_order_relaxed);
+}
+
+bool Console::CheckRateLimit(eLogMessage messageCat)
+{
+    RateLimit& rateLimit = mRateLimits[messageCat];
+
+    int maxMessages = rateLimit.mMaxMessagesPerSecond.load(std::memory_order_relaxed);
+    if (maxMessages == 0)
+        return true;
+
+    long long currentSecond = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // start new window
+    long long windowStart = rateLimit.mWindowStart.load(std::memory_order_relaxed);
+    if ((windowStart != currentSecond) &&
+        rateLimit.mWindowStart.compare_exchange_strong(windowStart, currentSecond, std::memory_order_relaxed))
+    {
+        rateLimit.mWindowMessages.store(0, std::memory_order_relaxed);
+    }
+
+    return rateLimit.mWindowMessages.fetch_add(1, std::memory_order_relaxed) < maxMessages;
+}
+
+int Console::ProcessQueuedMessages()
+{
+    if (mProcessingMessages.exchange(true, std::memory_order_acquire))
+        return 0; // already processing on other thread
+
+    int messagesCounter = 0;
+    for (;;)
+    {
+        LogRecord& logRecord = mQueue[mDequeuePos & (MaxQueuedMessages - 1)];
+
+        unsigned int sequence = logRecord.mSequence.load(std::memory_order_acquire);
+        if ((int) (sequence - (mDequeuePos + 1)) < 0)
+            break; // queue is empty
+
+        OutputMessage(logRecord.mMessageCategory, logRecord.mText);
+
+        // release record for producers
+        logRecord.mSequence.store(mDequeuePos + MaxQueuedMessages, std::memory_order_release);
+        ++mDequeuePos;
+        ++messagesCounter;
+    }
+
+    int droppedMessages = mDroppedMessages.load(std::memory_order_relaxed);
+    if (droppedMessages != mReportedDroppedMessages)
+    {
+        char messageText[128];
+        snprintf(messageText, sizeof(messageText), "%d log messages dropped", droppedMessages - mReportedDroppedMessages);
+        OutputMessage(eLogMessage_Warning, messageText);
+        mReportedDroppedMessages = droppedMessages;
+    }
+
+    mProcessingMessages.store(false, std::memory_order_release);
+    return messagesCounter;
+}
+
+void Console::OutputMessage(eLogMessage messageCat, const char* messageText)
+{
     if (messageCat > eLogMessage_Debug)
     {
-        printf("%s\n", ConsoleMessageBuffer);
+        printf("%s\n", messageText);
     }
+
+    if (mLogFile)
+    {
+        fprintf(mLogFile, "[%s] %s\n", cxx::enum_to_string(messageCat), messageText);
+    }
+
     ConsoleLine consoleLine;
     consoleLine.mLineType = eConsoleLineType_Message;
     consoleLine.mMessageCategory = messageCat;
-    consoleLine.mString = ConsoleMessageBuffer;
+    consoleLine.mString = messageText;
+
+    std::lock_guard<std::mutex> linesLock (mLinesMutex);
+    if ((int) mLines.size() >= MaxLines)
+    {
+        mLines.pop_front();
+    }
     mLines.push_back(std::move(consoleLine));
 }
 
+void Console::SinkThreadProc()
+{
+    const std::chrono::milliseconds IdleSleepTime (5);
+
+    while (!mSinkThreadQuitRequest)
+    {
+        if (ProcessQueuedMessages() > 0)
+            continue;
+
+        if (mLogFile)
+        {
+            ::fflush(mLogFile);
+        }
+        std::this_thread::sleep_for(IdleSleepTime);
+    }
+}
+
 void Console::Flush()
 {
+    std::lock_guard<std::mutex> linesLock (mLinesMutex);
     mLines.clear();
 }
 
+const std::deque<ConsoleLine>& Console::AcquireLines()
+{
+    mLinesMutex.lock();
+    return mLines;
+}
+
+void Console::ReleaseLines()
+{
+    mLinesMutex.unlock();
+}
+
 void Console::ExecuteCommands(const char* commands)
 {
     cxx::string_tokenizer tokenizer(commands);
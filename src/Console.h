@@ -1,11 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include "CommonTypes.h"
 
 // represents console system that handles debug commands
+// Messages are queued into lock-free ring buffer so they could be logged from any thread,
+// writing to stdout, log file and console lines is done by background sink thread
 class Console final: public cxx::noncopyable
 {
 public:
+    static const int MaxMessageLength = 512; // including terminating zero, longer messages are truncated
+    static const int MaxQueuedMessages = 1024; // must be power of two
+    static const int MaxLines = 1000; // console lines kept for display
+
+public:
+    Console();
+
     // Setup internal resources, returns false on error
     bool Initialize();
 
@@ -18,6 +29,11 @@ public:
     // @args: Arguments
     void LogMessage(eLogMessage messageCat, const char* format, ...);
 
+    // Limit number of messages of specific category, extra messages will be dropped
+    // @param messageCat: Message category
+    // @param maxMessagesPerSecond: Messages limit, 0 means no limit
+    void SetRateLimit(eLogMessage messageCat, int maxMessagesPerSecond);
+
     // Clear all console text messages
     void Flush();
 
@@ -25,8 +41,56 @@ public:
     // @param commands: Commands string
     void ExecuteCommands(const char* commands);
 
-public:
-    std::deque<ConsoleLine> mLines;
+    // Access console text messages for display, sink thread is blocked until lines get released
+    const std::deque<ConsoleLine>& AcquireLines();
+    void ReleaseLines();
+
+    // Get number of messages dropped due to queue overflow or rate limits
+    inline int GetDroppedMessagesCount() const { return mDroppedMessages.load(std::memory_order_relaxed); }
+
+private:
+    // queued message
+    struct LogRecord
+    {
+        std::atomic<unsigned int> mSequence;
+        eLogMessage mMessageCategory;
+        char mText[MaxMessageLength];
+    };
+
+    // messages counter within one second window
+    struct RateLimit
+    {
+        std::atomic<int> mMaxMessagesPerSecond;
+        std::atomic<long long> mWindowStart; // seconds
+        std::atomic<int> mWindowMessages;
+    };
+
+private:
+    bool CheckRateLimit(eLogMessage messageCat);
+
+    // Write queued messages to outputs, can only be called from one thread at once
+    // @returns number of processed messages
+    int ProcessQueuedMessages();
+    void OutputMessage(eLogMessage messageCat, const char* messageText);
+    void SinkThreadProc();
+
+private:
+    LogRecord mQueue[MaxQueuedMessages];
+    std::atomic<unsigned int> mEnqueuePos;
+    unsigned int mDequeuePos = 0; // accessed by sink only
+
+    RateLimit mRateLimits[eLogMessage_COUNT];
+    std::atomic<int> mDroppedMessages;
+    int mReportedDroppedMessages = 0; // accessed by sink only
+
+    std::thread mSinkThread;
+    std::atomic<bool> mSinkThreadActive;
+    std::atomic<bool> mSinkThreadQuitRequest;
+    std::atomic<bool> mProcessingMessages; // guards against concurrent consumers
+    FILE* mLogFile = nullptr;
+
+    std::mutex mLinesMutex;
+    std::deque<ConsoleLine> mLines; // bounded by MaxLines
 };
 
 extern Console gConsole;
\ No newline at end of file
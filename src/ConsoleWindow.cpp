@@ -39,32 +39,40 @@ void ConsoleWindow::DoUI(ImGuiIO& imguiContext)
         ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoBackground);
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4,1));
 
-    for (const ConsoleLine& currentLine: gConsole.mLines)
+    // draw only visible lines
+    const std::deque<ConsoleLine>& consoleLines = gConsole.AcquireLines();
+    ImGuiListClipper linesClipper ((int) consoleLines.size());
+    while (linesClipper.Step())
     {
-        const char* item = currentLine.mString.c_str();
-
-        bool pop_color = false;
-        if (currentLine.mMessageCategory == eLogMessage_Error) 
-        { 
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f)); 
-            pop_color = true; 
-        }
-        if (currentLine.mMessageCategory == eLogMessage_Warning) 
-        { 
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.0f, 1.0f)); 
-            pop_color = true; 
-        }
-        else if (currentLine.mMessageCategory == eLogMessage_Debug)
-        { 
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.7f, 0.7f, 1.0f)); 
-            pop_color = true; 
-        }
-        ImGui::TextUnformatted(item);
-        if (pop_color)
+        for (int iline = linesClipper.DisplayStart; iline < linesClipper.DisplayEnd; ++iline)
         {
-            ImGui::PopStyleColor();
+            const ConsoleLine& currentLine = consoleLines[iline];
+            const char* item = currentLine.mString.c_str();
+
+            bool pop_color = false;
+            if (currentLine.mMessageCategory == eLogMessage_Error) 
+            { 
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f)); 
+                pop_color = true; 
+            }
+            if (currentLine.mMessageCategory == eLogMessage_Warning) 
+            { 
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.0f, 1.0f)); 
+                pop_color = true; 
+            }
+            else if (currentLine.mMessageCategory == eLogMessage_Debug)
+            { 
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.7f, 0.7f, 1.0f)); 
+                pop_color = true; 
+            }
+            ImGui::TextUnformatted(item);
+            if (pop_color)
+            {
+                ImGui::PopStyleColor();
+            }
         }
     }
+    gConsole.ReleaseLines();
 
     if (mScrollToBottom || (mAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()))
     {
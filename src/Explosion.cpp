@@ -9,6 +9,7 @@
 #include "BroadcastEventsManager.h"
 #include "GameObjectsManager.h"
 #include "AudioManager.h"
+#include "ParticleEffectsManager.h"
 
 Explosion::Explosion() 
     : GameObject(eGameObjectClass_Explosion, GAMEOBJECT_ID_NULL)
@@ -30,8 +31,7 @@ void Explosion::UpdateFrame()
         {
             glm::vec3 currentPosition = GetPosition();
             // create smoke effect
-            Decoration* bigSmoke = gGameObjectsManager.CreateBigSmoke(currentPosition);
-            debug_assert(bigSmoke);
+            gParticleEffects.EmitBigSmoke(currentPosition);
         }
     }
 
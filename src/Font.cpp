@@ -88,6 +88,7 @@ void Font::Unload()
 {
     mLineHeight = 0;
     mBaseCharCode = 0;
+    mMeasuredStrings.clear();
 
     if (mFontTexture)
     {
@@ -151,6 +152,27 @@ void Font::MeasureString(const std::string& text, Point& outputSize) const
 }
 
 void Font::MeasureString(const std::string& text, const Point& maxSize, Point& outputSize) const
+{
+    // max size is not taken into account
+    auto find_iterator = mMeasuredStrings.find(text);
+    if (find_iterator != mMeasuredStrings.end())
+    {
+        outputSize = find_iterator->second;
+        return;
+    }
+
+    ComputeStringSize(text, outputSize);
+
+    // texts are mostly short numbers and names, so simply start over when cache grows too large
+    const int MaxMeasuredStrings = 256;
+    if ((int) mMeasuredStrings.size() >= MaxMeasuredStrings)
+    {
+        mMeasuredStrings.clear();
+    }
+    mMeasuredStrings[text] = outputSize;
+}
+
+void Font::ComputeStringSize(const std::string& text, Point& outputSize) const
 {
     outputSize.x = 0;
     outputSize.y = 0;
@@ -223,7 +245,11 @@ void Font::MeasureString(const std::string& text, const Point& maxSize, Point& o
 void Font::SetFontBaseCharCode(int charCode)
 {
     debug_assert(charCode >= 0);
-    mBaseCharCode = charCode;
+    if (mBaseCharCode != charCode)
+    {
+        mBaseCharCode = charCode;
+        mMeasuredStrings.clear();
+    }
 }
 
 void Font::DrawString(GuiContext& guiContext, const std::string& text, const Point& position, int paletteIndex)
@@ -233,6 +259,17 @@ void Font::DrawString(GuiContext& guiContext, const std::string& text, const Poi
 }
 
 void Font::DrawString(GuiContext& guiContext, const std::string& text, const Point& position, const Point& maxSize, int paletteIndex)
+{
+    mDrawStringSprites.clear();
+    LayoutString(text, position, paletteIndex, mDrawStringSprites);
+
+    for (const Sprite2D& currSprite: mDrawStringSprites)
+    {
+        guiContext.mSpriteBatch.DrawSprite(currSprite);
+    }
+}
+
+void Font::LayoutString(const std::string& text, const Point& position, int paletteIndex, std::vector<Sprite2D>& outputSprites) const
 {
     int maxCharCodes = (int) mCharacters.size();
     if (maxCharCodes < 1)
@@ -288,7 +325,7 @@ void Font::DrawString(GuiContext& guiContext, const std::string& text, const Poi
         spriteData.mPosition.y = currentOffsetY * 1.0f;
         currentOffsetX += spriteData.mTextureRegion.mRectangle.w;
 
-        guiContext.mSpriteBatch.DrawSprite(spriteData);
+        outputSprites.push_back(spriteData);
     }
 }
 
@@ -30,10 +30,18 @@ public:
     void DrawString(GuiContext& guiContext, const std::string& text, const Point& position, int paletteIndex);
     void DrawString(GuiContext& guiContext, const std::string& text, const Point& position, const Point& maxSize, int paletteIndex);
 
+    // Generate characters sprites without drawing them, so they could be cached and drawn many times
+    // @param text: Source string
+    // @param position: Screen position in pixels
+    // @param paletteIndex: Font palette
+    // @param outputSprites: Characters sprites get appended here
+    void LayoutString(const std::string& text, const Point& position, int paletteIndex, std::vector<Sprite2D>& outputSprites) const;
+
     // Get font line height in pixels
     int GetLineHeight() const;
 
     // Calculcate string dimensions, will process newlines and tabulations
+    // Results are memoized per string
     // @param text: Source string
     // @param maxSize: Text max size in pixels
     // @param outputSize: Text dimensions in pixels
@@ -45,6 +53,7 @@ public:
 
 private:
     bool CreateFontAtlas();
+    void ComputeStringSize(const std::string& text, Point& outputSize) const;
 
 private:
 
@@ -66,4 +75,7 @@ private:
 
     int mBaseCharCode = 0;
     int mLineHeight = 0;
+
+    mutable std::map<std::string, Point> mMeasuredStrings;
+    std::vector<Sprite2D> mDrawStringSprites; // temporary
 };
\ No newline at end of file
@@ -148,6 +148,13 @@ void GameCamera::SetTopDownOrientation()
     mViewMatrixDirty = true;
 }
 
+bool GameCamera::IsTopDownOrientation() const
+{
+    const float Tolerance = 0.001f;
+    return (glm::dot(mFrontDirection, -SceneAxisY) > (1.0f - Tolerance)) &&
+        (fabsf(glm::dot(mRightDirection, SceneAxisX)) > (1.0f - Tolerance));
+}
+
 void GameCamera::SetOrientation(const glm::vec3& dirForward, const glm::vec3& dirRight, const glm::vec3& dirUp)
 {
     mFrontDirection = dirForward;
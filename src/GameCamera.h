@@ -92,7 +92,10 @@ public:
     // Will swap Z and Y direction vectors
     void SetTopDownOrientation();
 
-    // Compute on screen view area
+    // Test whether camera looks straight down with screen axes aligned to map axes
+    bool IsTopDownOrientation() const;
+
+    // Compute on screen view area, only valid for camera with top down orientation
     cxx::aabbox2d_t ComputeViewBounds2() const;
 
 private:
@@ -9,6 +9,11 @@
 #include "AiManager.h"
 #include "TrafficManager.h"
 #include "AiCharacterController.h"
+#include "BulletsManager.h"
+#include "ParticleEffectsManager.h"
+#include "RenderBenchmark.h"
+#include "RenderStatsWindow.h"
+#include "SpriteManager.h"
 
 namespace ImGui
 {
@@ -22,6 +27,8 @@ namespace ImGui
     }
 }
 
+static const char* GameStateSnapshotPath = "gamestate.snapshot";
+
 GameCheatsWindow gGameCheatsWindow;
 
 GameCheatsWindow::GameCheatsWindow()
@@ -109,6 +116,18 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
                 ImGui::PopID();
             }
             ImGui::EndMenu();
+        }
+        if (ImGui::BeginMenu("[ Game state ]"))
+        {
+            if (ImGui::MenuItem("Save snapshot"))
+            {
+                gCarnageGame.DebugSaveSnapshot(GameStateSnapshotPath);
+            }
+            if (ImGui::MenuItem("Load snapshot"))
+            {
+                gCarnageGame.DebugLoadSnapshot(GameStateSnapshotPath);
+            }
+            ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
     }
@@ -222,12 +241,25 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
     {
         //ImGui::Checkbox("Enable map collisions", &mEnableMapCollisions);
         ImGui::Checkbox("Enable gravity", &mEnableGravity);
+        ImGui::Checkbox("Batched cars dynamics", &gPhysics.mBatchedCarsDynamics);
+        if (ImGui::Button("Validate batched cars dynamics"))
+        {
+            gPhysics.mValidateCarsDynamics = true;
+        }
+        ImGui::Checkbox("Pedestrians crowd solver", &gPhysics.mPedsCrowdSolver);
+        if (gPhysics.mPedsCrowdSolver)
+        {
+            ImGui::Text("Crowd peds: %d (%d overlaps)", gPhysics.mCrowdSolver.mPedsCount, gPhysics.mCrowdSolver.mPairsCount);
+        }
+        ImGui::Text("World step: %.3f ms, crowd solver: %.3f ms", gPhysics.mWorldStepTime, gPhysics.mCrowdSolverTime);
     }
 
     if (ImGui::CollapsingHeader("Draw"))
     {
-        ImGui::Text("Map chunks drawn: %d", gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawnCount);
+        ImGui::Text("Map chunks drawn: %d (%d draws)", gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawnCount, 
+            gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawCalls);
         ImGui::Text("Sprites drawn: %d", gRenderManager.mMapRenderer.mRenderStats.mSpritesDrawnCount);
+        ImGui::Text("Particles: %d", gParticleEffects.GetParticlesCount());
         ImGui::HorzSpacing();
         ImGui::Checkbox("Debug draw", &mEnableDebugDraw);
         ImGui::Checkbox("Decorations", &mEnableDrawDecorations);
@@ -243,7 +275,7 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
         ImGui::TextColored(ImVec4(1.0f,1.0f,0.0f,1.0f), "Pedestrians");
         ImGui::HorzSpacing();
         ImGui::Text("Current count: %d", gTrafficManager.CountTrafficPedestrians());
-        ImGui::SliderInt("Max count##ped", &gGameParams.mTrafficGenMaxPeds, 0, 100);
+        ImGui::SliderInt("Max count##ped", &gGameParams.mTrafficGenMaxPeds, 0, 500);
         ImGui::SliderInt("Generation distance max##ped", &gGameParams.mTrafficGenPedsMaxDistance, 1, 10);
         ImGui::SliderInt("Generation chance##ped", &gGameParams.mTrafficGenPedsChance, 0, 100);
         ImGui::SliderFloat("Generation cooldown##ped", &gGameParams.mTrafficGenPedsCooldownTime, 0.5f, 5.0f, "%.1f");
@@ -259,6 +291,51 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
         ImGui::Checkbox("Generation enabled##car", &mEnableTrafficCarsGeneration);
     }
 
+    if (ImGui::CollapsingHeader("Objects"))
+    {
+        const GameObjectsStats& objectsStats = gGameObjectsManager.mStats;
+        ImGui::Text("Objects count: %d", (int) gGameObjectsManager.mAllObjects.size());
+        ImGui::Text("Updated: %d", objectsStats.mObjectsUpdated);
+        ImGui::Text("Update time: %.3f ms (average %.3f ms)", objectsStats.mUpdateTime, objectsStats.mAverageUpdateTime);
+        ImGui::Checkbox("Per-class update loops", &gGameObjectsManager.mPerClassUpdateLoops);
+        ImGui::HorzSpacing();
+        if (ImGui::Button("Create 5000 mixed objects"))
+        {
+            CreateMixedObjectsNearby(playerCharacter, 5000);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Bullets"))
+    {
+        const BulletsStats& bulletsStats = gBulletsManager.mStats;
+        ImGui::Text("Active bullets: %d", bulletsStats.mBulletsCount);
+        ImGui::Text("Created: %d, hits: %d", bulletsStats.mBulletsCreated, bulletsStats.mBulletsHits);
+        ImGui::Text("Segments traced: %d", bulletsStats.mSegmentsTraced);
+        ImGui::Text("Update time: %.3f ms", bulletsStats.mUpdateTime);
+        ImGui::HorzSpacing();
+        ImGui::Checkbox("Stress test", &mEnableBulletsStressTest);
+        ImGui::SliderInt("Shots per frame", &mBulletsStressTestShotsPerFrame, 1, 64);
+    }
+
+    if (mEnableBulletsStressTest)
+    {
+        FireBulletsAround(playerCharacter, mBulletsStressTestShotsPerFrame);
+    }
+
+    if (ImGui::CollapsingHeader("Ai"))
+    {
+        const AiUpdateStats& updateStats = gAiManager.mUpdateStats;
+        ImGui::Text("Controllers: %d", updateStats.mControllersCount);
+        ImGui::Text("Updated onscreen: %d", updateStats.mControllersUpdated[eAiUpdateTier_OnScreen]);
+        ImGui::Text("Updated near: %d", updateStats.mControllersUpdated[eAiUpdateTier_Near]);
+        ImGui::Text("Updated far: %d", updateStats.mControllersUpdated[eAiUpdateTier_Far]);
+        ImGui::Text("Deferred: %d", updateStats.mControllersDeferred);
+        ImGui::Text("Flow fields created: %d, reused: %d", gAiManager.mFlowFields.mFieldsCreatedCounter, gAiManager.mFlowFields.mFieldsReusedCounter);
+        ImGui::HorzSpacing();
+        ImGui::SliderFloat("Near update interval", &gGameParams.mAiNearUpdateInterval, 0.0f, 1.0f, "%.2f");
+        ImGui::SliderFloat("Far update interval", &gGameParams.mAiFarUpdateInterval, 0.0f, 2.0f, "%.2f");
+    }
+
     if (ImGui::CollapsingHeader("Graphics"))
     {
         if (ImGui::Checkbox("Enable vsync", &gSystem.mConfig.mEnableVSync))
@@ -295,11 +372,102 @@ void GameCheatsWindow::DoUI(ImGuiIO& imguiContext)
                 ImGui::EndCombo();
             }
         }
+
+        ImGui::HorzSpacing();
+
+        ImGui::Text("Draw calls: %d", gGraphicsDevice.mLastFrameCounters.mDrawCalls);
+        ImGui::Text("Delta sprites: %d (atlas pages: %d, occupancy: %.0f%%)", 
+            gSpriteManager.mDeltaSpritesAtlas.GetAllocationsCount(),
+            gSpriteManager.mDeltaSpritesAtlas.GetPagesCount(),
+            gSpriteManager.mDeltaSpritesAtlas.GetOccupancy() * 100.0f);
+        ImGui::Checkbox("Show render stats", &gRenderStatsWindow.mWindowShown);
+        if (gRenderManager.mSpritesProgram.IsInstancingSupported())
+        {
+            ImGui::Checkbox("Instanced sprites", &gRenderManager.mEnableSpritesInstancing);
+        }
+        ImGui::Checkbox("Prepare sprites on worker thread", &gRenderManager.mMapRenderer.mWorkerThreadPrepare);
+        if (gRenderBenchmark.IsRunning())
+        {
+            if (ImGui::Button("Stop render benchmark"))
+            {
+                gRenderBenchmark.Stop();
+            }
+        }
+        else if (ImGui::Button("Run render benchmark"))
+        {
+            gRenderBenchmark.Start(600, false);
+        }
+        if (ImGui::Button("Run style decoding benchmark"))
+        {
+            RunStyleDecodingBenchmark(10);
+        }
     }
 
     ImGui::End();
 }
 
+void GameCheatsWindow::RunStyleDecodingBenchmark(int iterationsCount)
+{
+    StyleData& styleData = gGameMap.mStyleData;
+    if (!styleData.IsLoaded() || iterationsCount < 1)
+        return;
+
+    // single bitmap that fits any sprite
+    Point maxSpriteSize (0, 0);
+    for (const SpriteInfo& currSprite: styleData.mSprites)
+    {
+        maxSpriteSize.x = std::max(maxSpriteSize.x, currSprite.mWidth);
+        maxSpriteSize.y = std::max(maxSpriteSize.y, currSprite.mHeight);
+    }
+    maxSpriteSize.x = std::max(maxSpriteSize.x, MAP_BLOCK_TEXTURE_DIMS);
+    maxSpriteSize.y = std::max(maxSpriteSize.y, MAP_BLOCK_TEXTURE_DIMS);
+
+    PixelsArray rgbaPixels;
+    if (!rgbaPixels.Create(eTextureFormat_RGBA8, maxSpriteSize.x, maxSpriteSize.y))
+    {
+        debug_assert(false);
+        return;
+    }
+
+    double blocksTextureTime = 0.0;
+    double spritesheetTime = 0.0;
+    double rgbaDecodingTime = 0.0;
+    for (int iteration = 0; iteration < iterationsCount; ++iteration)
+    {
+        PixelsArray blocksPixels;
+        double startTime = gSystem.GetSystemSeconds();
+        SpriteManager::PrepareBlocksTexture(styleData, blocksPixels);
+        blocksTextureTime += gSystem.GetSystemSeconds() - startTime;
+
+        PixelsArray spritesheetPixels;
+        std::vector<TextureRegion> spritesheetEntries;
+        startTime = gSystem.GetSystemSeconds();
+        SpriteManager::PrepareObjectsSpritesheet(styleData, spritesheetPixels, spritesheetEntries);
+        spritesheetTime += gSystem.GetSystemSeconds() - startTime;
+
+        // all blocks and sprites with palette colors on single thread
+        startTime = gSystem.GetSystemSeconds();
+        for (int iblockType = 0; iblockType < eBlockType_COUNT; ++iblockType)
+        {
+            for (int itexture = 0, NumTextures = styleData.GetBlockTexturesCount((eBlockType) iblockType); itexture < NumTextures; ++itexture)
+            {
+                styleData.GetBlockTexture((eBlockType) iblockType, itexture, &rgbaPixels, 0, 0, 0);
+            }
+        }
+        for (int isprite = 0, NumSprites = (int) styleData.mSprites.size(); isprite < NumSprites; ++isprite)
+        {
+            styleData.GetSpriteTexture(isprite, &rgbaPixels, 0, 0);
+        }
+        rgbaDecodingTime += gSystem.GetSystemSeconds() - startTime;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Style decoding benchmark (%d iterations, %d blocks, %d sprites):", iterationsCount, 
+        styleData.GetBlockTexturesCount(), (int) styleData.mSprites.size());
+    gConsole.LogMessage(eLogMessage_Info, "    blocks texture: %.3f ms", blocksTextureTime * 1000.0 / iterationsCount);
+    gConsole.LogMessage(eLogMessage_Info, "    objects spritesheet: %.3f ms", spritesheetTime * 1000.0 / iterationsCount);
+    gConsole.LogMessage(eLogMessage_Info, "    rgba decoding: %.3f ms", rgbaDecodingTime * 1000.0 / iterationsCount);
+}
+
 void GameCheatsWindow::CreateCarNearby(VehicleInfo* carStyle, Pedestrian* pedestrian)
 {
     if (carStyle == nullptr || pedestrian == nullptr)
@@ -316,4 +484,64 @@ void GameCheatsWindow::CreateCarNearby(VehicleInfo* carStyle, Pedestrian* pedest
     {
         vehicle->mFlags = (vehicle->mFlags | eGameObjectFlags_Traffic);
     }
+}
+
+void GameCheatsWindow::CreateMixedObjectsNearby(Pedestrian* pedestrian, int objectsCount)
+{
+    if (pedestrian == nullptr)
+        return;
+
+    cxx::randomizer& random = gCarnageGame.mGameRand;
+
+    GameObjectInfo& decorationInfo = gGameMap.mStyleData.mObjects[GameObjectType_LFire];
+
+    const float SpreadDistance = Convert::MapUnitsToMeters(8.0f);
+
+    glm::vec3 currPosition = pedestrian->mPhysicsBody->GetPosition();
+    for (int iobject = 0; iobject < objectsCount; ++iobject)
+    {
+        glm::vec3 position = currPosition;
+        position.x += random.generate_float(-SpreadDistance, SpreadDistance);
+        position.z += random.generate_float(-SpreadDistance, SpreadDistance);
+
+        cxx::angle_t heading = cxx::angle_t::from_degrees(random.generate_float(0.0f, 360.0f));
+
+        // 1 car, 3 pedestrians, 6 decorations
+        int objectKind = iobject % 10;
+        if (objectKind == 0)
+        {
+            int carIndex = random.generate_int(0, (int) gGameMap.mStyleData.mVehicles.size() - 1);
+            gGameObjectsManager.CreateVehicle(position, heading, &gGameMap.mStyleData.mVehicles[carIndex]);
+        }
+        else if (objectKind < 4)
+        {
+            gGameObjectsManager.CreatePedestrian(position, heading, ePedestrianType_Civilian);
+        }
+        else
+        {
+            gGameObjectsManager.CreateDecoration(position, heading, &decorationInfo);
+        }
+    }
+}
+
+void GameCheatsWindow::FireBulletsAround(Pedestrian* pedestrian, int shotsCount)
+{
+    if (pedestrian == nullptr)
+        return;
+
+    WeaponInfo* weaponInfo = &gGameMap.mStyleData.mWeaponTypes[eWeapon_Machinegun];
+
+    glm::vec3 currPosition = pedestrian->mPhysicsBody->GetPosition();
+    for (int ishot = 0; ishot < shotsCount; ++ishot)
+    {
+        cxx::angle_t heading = cxx::angle_t::from_degrees(gCarnageGame.mGameRand.generate_float(0.0f, 360.0f));
+
+        glm::vec2 direction;
+        heading.get_sin_cos(direction.y, direction.x);
+
+        glm::vec3 bulletPosition = currPosition;
+        bulletPosition.x += direction.x * gGameParams.mPedestrianBoundsSphereRadius;
+        bulletPosition.z += direction.y * gGameParams.mPedestrianBoundsSphereRadius;
+        gBulletsManager.CreateBullet(bulletPosition, heading, weaponInfo, pedestrian);
+    }
 }
\ No newline at end of file
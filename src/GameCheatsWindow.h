@@ -16,6 +16,8 @@ public:
     bool mEnableDrawCityMesh = true;
     bool mEnableTrafficPedsGeneration = true;
     bool mEnableTrafficCarsGeneration = false;
+    bool mEnableBulletsStressTest = false;
+    int mBulletsStressTestShotsPerFrame = 8;
 
 public:
     GameCheatsWindow();
@@ -26,6 +28,15 @@ private:
     void DoUI(ImGuiIO& imguiContext) override;
 
     void CreateCarNearby(VehicleInfo* carStyle, Pedestrian* pedestrian);
+
+    // sustained automatic fire around pedestrian, used to measure bullets simulation cost
+    void FireBulletsAround(Pedestrian* pedestrian, int shotsCount);
+
+    // spawn lots of pedestrians, cars and decorations, used to measure objects update cost
+    void CreateMixedObjectsNearby(Pedestrian* pedestrian, int objectsCount);
+
+    // measure time spent on decoding block textures and sprites of current style
+    void RunStyleDecodingBenchmark(int iterationsCount);
 };
 
 extern GameCheatsWindow gGameCheatsWindow;
\ No newline at end of file
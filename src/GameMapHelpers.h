@@ -21,6 +21,16 @@ public:
 
 using CityMeshData = MeshData<CityVertex3D>;
 
+// map cardinal directions, north is top of the map
+enum eMapDirection
+{
+    eMapDirection_N,
+    eMapDirection_E,
+    eMapDirection_S,
+    eMapDirection_W,
+    eMapDirection_COUNT
+};
+
 class GameMapManager;
 class GameMapHelpers final
 {
@@ -42,4 +52,91 @@ public:
 private:
     // internals
     static void PutBlockFace(GameMapManager& city, CityMeshData& meshData, int x, int y, int z, eBlockFace face, const MapBlockInfo* blockInfo);
-};
\ No newline at end of file
+};
+
+inline eMapDirection GetMapDirectionFromHeading(float angleDegrees)
+{
+    static const std::pair<float, eMapDirection> Directions[] =
+    {
+        {360.0f, eMapDirection_E},
+        {  0.0f, eMapDirection_E},
+        { 90.0f, eMapDirection_S},
+        {180.0f, eMapDirection_W},
+        {270.0f, eMapDirection_N},
+    };
+
+    angleDegrees = cxx::normalize_angle_360(angleDegrees);
+
+    for (const auto& curr: Directions)
+    {
+        if (fabs(curr.first - angleDegrees) <= 45.0f)
+            return curr.second;
+    }
+    debug_assert(false);
+    return eMapDirection_E;
+}
+
+inline eMapDirection GetMapDirectionCW(eMapDirection dir)
+{
+    switch (dir)
+    {
+        case eMapDirection_N: return eMapDirection_E;
+        case eMapDirection_E: return eMapDirection_S;
+        case eMapDirection_S: return eMapDirection_W;
+        case eMapDirection_W: return eMapDirection_N;
+    }
+    debug_assert(false);
+    return eMapDirection_E;
+}
+
+inline eMapDirection GetMapDirectionCCW(eMapDirection dir)
+{
+    switch (dir)
+    {
+        case eMapDirection_N: return eMapDirection_W;
+        case eMapDirection_E: return eMapDirection_N;
+        case eMapDirection_S: return eMapDirection_E;
+        case eMapDirection_W: return eMapDirection_S;
+    }
+    debug_assert(false);
+    return eMapDirection_E;
+}
+
+inline eMapDirection GetMapDirectionOpposite(eMapDirection dir)
+{
+    switch (dir)
+    {
+        case eMapDirection_N: return eMapDirection_S;
+        case eMapDirection_E: return eMapDirection_W;
+        case eMapDirection_S: return eMapDirection_N;
+        case eMapDirection_W: return eMapDirection_E;
+    }
+    debug_assert(false);
+    return eMapDirection_E;
+}
+
+// Get straight point vector for direction
+inline const glm::ivec3& GetVectorFromMapDirection(eMapDirection direction)
+{
+    static const glm::ivec3 Vecs[] =
+    {
+        { 0, 0, -1}, // n
+        { 1, 0,  0}, // e
+        { 0, 0,  1}, // s
+        {-1, 0,  0}, // w
+    };
+    return Vecs[direction];
+}
+
+// Get heading angle for direction
+inline float GetHeadingFromMapDirection(eMapDirection direction)
+{
+    static const float Headings[] =
+    {
+        270.0f, // n
+          0.0f, // e
+         90.0f, // s
+        180.0f, // w
+    };
+    return Headings[direction];
+}
\ No newline at end of file
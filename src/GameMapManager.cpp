@@ -77,6 +77,8 @@ bool GameMapManager::LoadFromFile(const std::string& filename)
         return false;
     }
 
+    mRoadLanes.BuildGraph(*this);
+
     // load corresponding style data
     std::string styleName = cxx::va("STYLE%03d.G24", header.style_number);
 
@@ -88,12 +90,14 @@ bool GameMapManager::LoadFromFile(const std::string& filename)
     }
     mStyleFileNumber = header.style_number;
     mAudioFileNumber = header.style_number; // sample_number is always 0 for some reason
+    mMapName = filename;
     return true;
 }
 
 void GameMapManager::Cleanup()
 {
     mStyleData.Cleanup();
+    mRoadLanes.Cleanup();
     for (int tiley = 0; tiley < MAP_DIMENSIONS; ++tiley)
     for (int tilex = 0; tilex < MAP_DIMENSIONS; ++tilex)
     {
@@ -109,6 +113,21 @@ void GameMapManager::Cleanup()
     }
     mStyleFileNumber = 0;
     mAudioFileNumber = 0;
+    mMapName.clear();
+}
+
+void GameMapManager::Swap(GameMapManager& otherMap)
+{
+    std::swap(mStyleData, otherMap.mStyleData);
+    mRoadLanes.Swap(otherMap.mRoadLanes);
+    mStartupObjects.swap(otherMap.mStartupObjects);
+    mMapName.swap(otherMap.mMapName);
+    std::swap(mStyleFileNumber, otherMap.mStyleFileNumber);
+    std::swap(mAudioFileNumber, otherMap.mAudioFileNumber);
+    std::swap(mMapTiles, otherMap.mMapTiles);
+    std::swap(mBaseTilesData, otherMap.mBaseTilesData);
+    std::swap(mAccidentServicesBases, otherMap.mAccidentServicesBases);
+    mDistricts.swap(otherMap.mDistricts);
 }
 
 bool GameMapManager::IsLoaded() const
@@ -2,6 +2,7 @@
 
 #include "GameDefs.h"
 #include "StyleData.h"
+#include "RoadLaneGraph.h"
 
 // this class manages GTA map and style data which get loaded from CMP/G24-files
 class GameMapManager final: public cxx::noncopyable
@@ -9,9 +10,12 @@ class GameMapManager final: public cxx::noncopyable
 public:
     // readonly
     StyleData mStyleData;
+    RoadLaneGraph mRoadLanes; // traffic lanes, generated from map blocks
 
     std::vector<StartupObjectPosStruct> mStartupObjects;
 
+    std::string mMapName; // currently loaded map file name
+
     // audio bank and style numbers
     int mStyleFileNumber = 0;
     int mAudioFileNumber = 0;
@@ -24,6 +28,10 @@ public:
     // free currently loaded map data
     void Cleanup();
 
+    // exchange all map data with other instance, used to apply map that was loaded in background
+    // @param otherMap: Map to exchange with
+    void Swap(GameMapManager& otherMap);
+
     // test whether city scape data was loaded, including style data
     bool IsLoaded() const;
 
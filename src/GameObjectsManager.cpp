@@ -20,6 +20,10 @@ GameObjectsManager::~GameObjectsManager()
 
     debug_assert(mPedestriansList.empty());
     debug_assert(mVehiclesList.empty());
+    debug_assert(mProjectilesList.empty());
+    debug_assert(mDecorationsList.empty());
+    debug_assert(mObstaclesList.empty());
+    debug_assert(mExplosionsList.empty());
     debug_assert(mAllObjects.empty());
 }
 
@@ -45,13 +49,44 @@ void GameObjectsManager::UpdateFrame()
 {
     DestroyMarkedForDeletionObjects();
 
-    // if is safe to add new objects during loop by adding them to the end of the list
+    double updateStartTime = gSystem.GetSystemSeconds();
 
-    for (size_t i = 0, NumElements = mAllObjects.size(); i < NumElements; ++i)
+    // objects created during update are added to the end of lists and will be updated starting next frame,
+    // destroyed objects are only marked for deletion, so iteration is stable
+    size_t vehiclesCount = mVehiclesList.size();
+    size_t pedestriansCount = mPedestriansList.size();
+    size_t obstaclesCount = mObstaclesList.size();
+    size_t projectilesCount = mProjectilesList.size();
+    size_t explosionsCount = mExplosionsList.size();
+    size_t decorationsCount = mDecorationsList.size();
+
+    mUpdatingObjects = true;
+
+    if (mPerClassUpdateLoops)
+    {
+        UpdateObjectsList(mVehiclesList, vehiclesCount);
+        UpdateObjectsList(mPedestriansList, pedestriansCount);
+        UpdateObjectsList(mObstaclesList, obstaclesCount);
+        UpdateObjectsList(mProjectilesList, projectilesCount);
+        UpdateObjectsList(mExplosionsList, explosionsCount);
+        // decorations might be attached to other objects, so update them last
+        UpdateObjectsList(mDecorationsList, decorationsCount);
+    }
+    else
     {
-        GameObject* currentObject = mAllObjects[i];
-        currentObject->UpdateFrame();
+        // previous single loop with virtual calls in creation order, kept for comparison
+        for (size_t i = 0, NumElements = mAllObjects.size(); i < NumElements; ++i)
+        {
+            GameObject* currentObject = mAllObjects[i];
+            currentObject->UpdateFrame();
+        }
     }
+
+    mUpdatingObjects = false;
+
+    mStats.mObjectsUpdated = (int) (vehiclesCount + pedestriansCount + obstaclesCount + projectilesCount + explosionsCount + decorationsCount);
+    mStats.mUpdateTime = (float) ((gSystem.GetSystemSeconds() - updateStartTime) * 1000.0);
+    mStats.mAverageUpdateTime = glm::mix(mStats.mAverageUpdateTime, mStats.mUpdateTime, 0.05f);
 }
 
 void GameObjectsManager::DebugDraw(DebugRenderer& debugRender)
@@ -120,6 +155,7 @@ Projectile* GameObjectsManager::CreateProjectile(const glm::vec3& position, cxx:
     debug_assert(instance);
 
     mAllObjects.push_back(instance);
+    mProjectilesList.push_back(instance);
     // init
     instance->Spawn(position, heading);
     return instance;
@@ -139,6 +175,7 @@ Obstacle* GameObjectsManager::CreateObstacle(const glm::vec3& position, cxx::ang
         debug_assert(instance);
 
         mAllObjects.push_back(instance);
+        mObstaclesList.push_back(instance);
         // init
         instance->Spawn(position, heading);
     }
@@ -151,6 +188,7 @@ Explosion* GameObjectsManager::CreateExplosion(const glm::vec3& position)
     debug_assert(instance);
 
     mAllObjects.push_back(instance);
+    mExplosionsList.push_back(instance);
     // init
     cxx::angle_t zeroAngle;
     instance->Spawn(position, zeroAngle);
@@ -170,48 +208,13 @@ Decoration* GameObjectsManager::CreateDecoration(const glm::vec3& position, cxx:
     debug_assert(instance);
 
     mAllObjects.push_back(instance);
+    mDecorationsList.push_back(instance);
     // init
     instance->Spawn(position, heading);
     instance->SetLifeDuration(desc->mLifeDuration);
     return instance;
 }
 
-Decoration* GameObjectsManager::CreateFirstBlood(const glm::vec3& position)
-{
-    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_FirstBlood];
-
-    cxx::angle_t rotation;
-    Decoration* decoration = CreateDecoration(position, rotation, &objectInfo);
-
-    return decoration;
-}
-
-Decoration* GameObjectsManager::CreateWaterSplash(const glm::vec3& position)
-{
-    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_Splash];
-
-    cxx::angle_t rotation;
-    Decoration* decoration = CreateDecoration(position, rotation, &objectInfo);
-
-    return decoration;
-}
-
-Decoration* GameObjectsManager::CreateBigSmoke(const glm::vec3& position)
-{
-    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_BigSmoke];
-
-    cxx::angle_t rotation;
-    Decoration* decoration = CreateDecoration(position, rotation, &objectInfo);
-    
-    if (decoration) // add some wind effect
-    {
-        const glm::vec3 velocity (1.0f, 0.0f, 0.0f); // todo: magic values
-        decoration->SetMoveVelocity(velocity);
-    }
-
-    return decoration;
-}
-
 Obstacle* GameObjectsManager::GetObstacleByID(GameObjectID objectID) const
 {
     for (GameObject* currentObject: mAllObjects)
@@ -304,6 +307,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         return;
     }
 
+    debug_assert(!mUpdatingObjects);
+
     cxx::erase_elements(mDeleteObjectsList, object);
     cxx::erase_elements(mAllObjects, object);
 
@@ -331,6 +336,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         {
             Projectile* projectile = static_cast<Projectile*>(object);
             mProjectilesPool.destroy(projectile);
+
+            cxx::erase_elements(mProjectilesList, object);
         }
         break;
 
@@ -338,6 +345,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         {
             Decoration* decoration = static_cast<Decoration*>(object);
             mDecorationsPool.destroy(decoration);
+
+            cxx::erase_elements(mDecorationsList, object);
         }
         break;
 
@@ -345,6 +354,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         {
             Obstacle* obstacle = static_cast<Obstacle*>(object);
             mObstaclesPool.destroy(obstacle);
+
+            cxx::erase_elements(mObstaclesList, object);
         }
         break;
 
@@ -352,6 +363,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         {
             Explosion* explosion = static_cast<Explosion*>(object);
             mExplosionsPool.destroy(explosion);
+
+            cxx::erase_elements(mExplosionsList, object);
         }
         break;
 
@@ -372,6 +385,10 @@ void GameObjectsManager::DestroyAllObjects()
 
     debug_assert(mVehiclesList.empty());
     debug_assert(mPedestriansList.empty());
+    debug_assert(mProjectilesList.empty());
+    debug_assert(mDecorationsList.empty());
+    debug_assert(mObstaclesList.empty());
+    debug_assert(mExplosionsList.empty());
 }
 
 void GameObjectsManager::DestroyMarkedForDeletionObjects()
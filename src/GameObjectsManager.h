@@ -7,6 +7,18 @@
 #include "Obstacle.h"
 #include "Explosion.h"
 
+// game objects update counters
+struct GameObjectsStats
+{
+public:
+    GameObjectsStats() = default;
+
+public:
+    int mObjectsUpdated = 0; // per frame
+    float mUpdateTime = 0.0f; // per frame, milliseconds
+    float mAverageUpdateTime = 0.0f; // smoothed over recent frames, milliseconds
+};
+
 // define game objects manager class
 class GameObjectsManager final: public cxx::noncopyable
 {
@@ -14,8 +26,18 @@ public:
     // readonly
     std::vector<GameObject*> mAllObjects;
     std::vector<GameObject*> mDeleteObjectsList;
+
+    // objects of specific class, updated in separate loops
     std::vector<Pedestrian*> mPedestriansList;
     std::vector<Vehicle*> mVehiclesList;
+    std::vector<Projectile*> mProjectilesList;
+    std::vector<Decoration*> mDecorationsList;
+    std::vector<Obstacle*> mObstaclesList;
+    std::vector<Explosion*> mExplosionsList;
+
+    GameObjectsStats mStats;
+
+    bool mPerClassUpdateLoops = true; // update objects in per-class loops or in single loop through all objects
 
 public:
     ~GameObjectsManager();
@@ -47,9 +69,6 @@ public:
 
     // Add new decoration instance to map at specific location
     Decoration* CreateDecoration(const glm::vec3& position, cxx::angle_t heading, GameObjectInfo* desc);
-    Decoration* CreateFirstBlood(const glm::vec3& position);
-    Decoration* CreateWaterSplash(const glm::vec3& position);
-    Decoration* CreateBigSmoke(const glm::vec3& position);
 
     // Add explosion instance to map at specific location 
     Explosion* CreateExplosion(const glm::vec3& position);
@@ -79,8 +98,21 @@ private:
     void DestroyMarkedForDeletionObjects();
     GameObjectID GenerateUniqueID();
 
+    // Update objects that were registered before current frame
+    // @param objectsList: Objects of specific class
+    // @param objectsCount: Number of objects to update
+    template<typename TObjectsList>
+    inline void UpdateObjectsList(TObjectsList& objectsList, size_t objectsCount)
+    {
+        for (size_t iobject = 0; iobject < objectsCount; ++iobject)
+        {
+            objectsList[iobject]->UpdateFrame(); // class is final, so there is no virtual dispatch
+        }
+    }
+
 private:
     GameObjectID mIDsCounter = 0;
+    bool mUpdatingObjects = false;
 
     // objects pools
     cxx::object_pool<Pedestrian> mPedestriansPool;
@@ -54,6 +54,11 @@ void GameParams::SetToDefaults()
     // ai
     mAiReactOnGunshotsDistance = Convert::MapUnitsToMeters(4.0f);
     mAiReactOnExplosionsDistance = Convert::MapUnitsToMeters(5.0f);
+    mAiFlowFieldLifetime = 2.0f;
+    mAiNearUpdateDistance = Convert::MapUnitsToMeters(8.0f);
+    mAiNearUpdateInterval = 0.1f;
+    mAiFarUpdateInterval = 0.5f;
+    mAiFrameTimeBudget = 0.002f;
     // hud
     mHudBigFontMessageShowDuration = 3.0f;
     mHudCarNameShowDuration = 3.0f;
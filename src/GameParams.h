@@ -61,6 +61,11 @@ public:
     // ai
     float mAiReactOnGunshotsDistance; // how far pedestrians can hear gunshots
     float mAiReactOnExplosionsDistance; // how far pedestrians can hear explosions
+    float mAiFlowFieldLifetime; // how long shared flee or follow field stays valid, seconds
+    float mAiNearUpdateDistance; // max distance from player view where ai gets updated with near frequency
+    float mAiNearUpdateInterval; // seconds
+    float mAiFarUpdateInterval; // seconds
+    float mAiFrameTimeBudget; // max time spent on updating offscreen ai each frame, seconds
 
     // hud
     float mHudBigFontMessageShowDuration; // how long show 'wasted' on screen, seconds
@@ -0,0 +1,498 @@
+#include "stdafx.h"
+#include "GameStateSnapshot.h"
+#include "GameMapManager.h"
+#include "GameObjectsManager.h"
+#include "PhysicsComponents.h"
+#include "AiManager.h"
+#include "TimeManager.h"
+#include "CarnageGame.h"
+
+static const unsigned int SnapshotFileSignature = 0x50414E53; // 'SNAP'
+static const int SnapshotFileVersion = 1;
+
+// limits for sizes read from file, protect from allocating huge arrays when data is corrupted
+static const int MaxSnapshotRecords = 65536; // per records array
+static const int MaxSnapshotStringLength = 65536;
+
+//////////////////////////////////////////////////////////////////////////
+
+void GameStateSnapshot::Clear()
+{
+    mMapName.clear();
+    mGameTime = 0.0f;
+    mRandomizerState.clear();
+    mVehicles.clear();
+    mPedestrians.clear();
+    mBroadcastEvents.clear();
+}
+
+void GameStateSnapshot::CaptureGameState()
+{
+    Clear();
+
+    mMapName = gGameMap.mMapName;
+    mGameTime = gTimeManager.mGameTime;
+
+    std::ostringstream randomizerState;
+    gCarnageGame.mGameRand.save_state(randomizerState);
+    mRandomizerState = randomizerState.str();
+
+    for (Vehicle* currVehicle: gGameObjectsManager.mVehiclesList)
+    {
+        CaptureVehicle(currVehicle);
+    }
+
+    for (Pedestrian* currPedestrian: gGameObjectsManager.mPedestriansList)
+    {
+        CapturePedestrian(currPedestrian);
+    }
+
+    std::vector<BroadcastEvent> broadcastEvents;
+    gBroadcastEvents.CollectEvents(broadcastEvents);
+    for (const BroadcastEvent& currEvent: broadcastEvents)
+    {
+        BroadcastEventRecord& record = mBroadcastEvents.emplace_back();
+        record.mEventType = currEvent.mEventType;
+        record.mEventSubject = currEvent.mEventSubject;
+        record.mEventTimestamp = currEvent.mEventTimestamp;
+        record.mEventDurationTime = currEvent.mEventDurationTime;
+        record.mPosition = currEvent.mPosition;
+        record.mSubjectID = currEvent.mSubject ? currEvent.mSubject->mObjectID : GAMEOBJECT_ID_NULL;
+        record.mCharacterID = currEvent.mCharacter ? currEvent.mCharacter->mObjectID : GAMEOBJECT_ID_NULL;
+    }
+}
+
+void GameStateSnapshot::CaptureVehicle(Vehicle* vehicle)
+{
+    if (vehicle->IsMarkedForDeletion())
+        return;
+
+    VehicleRecord& record = mVehicles.emplace_back();
+    record.mObjectID = vehicle->mObjectID;
+    record.mFlags = vehicle->mFlags;
+    record.mModelID = vehicle->mCarInfo->mModelID;
+    record.mRemapIndex = vehicle->mRemapIndex;
+    record.mCurrentDamage = vehicle->mCurrentDamage;
+    record.mCarWrecked = vehicle->mCarWrecked;
+    record.mPosition = vehicle->mPhysicsBody->GetPosition();
+    record.mHeading = vehicle->mPhysicsBody->GetRotationAngle().mDegrees;
+    record.mLinearVelocity = vehicle->mPhysicsBody->GetLinearVelocity();
+    record.mAngularVelocity = vehicle->mPhysicsBody->GetAngularVelocity().mDegrees;
+}
+
+void GameStateSnapshot::CapturePedestrian(Pedestrian* pedestrian)
+{
+    if (pedestrian->IsMarkedForDeletion() || pedestrian->IsDead() || pedestrian->IsDies())
+        return;
+
+    PedestrianRecord& record = mPedestrians.emplace_back();
+    record.mObjectID = pedestrian->mObjectID;
+    record.mFlags = pedestrian->mFlags;
+    record.mPedestrianType = pedestrian->mPedestrianTypeID;
+    record.mRemapIndex = pedestrian->mRemapIndex;
+    record.mArmorHitPoints = pedestrian->mArmorHitPoints;
+    record.mPosition = pedestrian->mPhysicsBody->GetPosition();
+    record.mHeading = pedestrian->mPhysicsBody->GetRotationAngle().mDegrees;
+    record.mLinearVelocity = pedestrian->mPhysicsBody->GetLinearVelocity();
+    record.mCurrentCarID = GAMEOBJECT_ID_NULL;
+    record.mCurrentSeat = eCarSeat_Driver;
+    // character which is entering or exiting car is stored on foot
+    if (pedestrian->mCurrentCar && !pedestrian->IsEnteringOrExitingCar())
+    {
+        record.mCurrentCarID = pedestrian->mCurrentCar->mObjectID;
+        record.mCurrentSeat = pedestrian->mCurrentSeat;
+    }
+    record.mCurrentWeapon = pedestrian->mCurrentWeapon;
+    for (int iweapon = 0; iweapon < eWeapon_COUNT; ++iweapon)
+    {
+        record.mAmmunition[iweapon] = pedestrian->mWeapons[iweapon].mAmmunition;
+        record.mLastFireTime[iweapon] = pedestrian->mWeapons[iweapon].mLastFireTime;
+    }
+
+    record.mHumanPlayerIndex = -1;
+    record.mHasAiController = false;
+    record.mAiController = {};
+
+    CharacterController* controller = pedestrian->mController;
+    if (controller == nullptr)
+        return;
+
+    if (controller->IsHumanPlayer())
+    {
+        record.mHumanPlayerIndex = gCarnageGame.GetHumanPlayerIndex(static_cast<HumanPlayer*>(controller));
+        return;
+    }
+
+    AiCharacterController* aiController = static_cast<AiCharacterController*>(controller);
+    record.mHasAiController = true;
+
+    AiControllerRecord& aiRecord = record.mAiController;
+    aiRecord.mAiMode = aiController->mAiMode;
+    aiRecord.mAiState = aiController->mAiState;
+    aiRecord.mAiFlags = aiController->mAiFlags;
+    aiRecord.mDestinationPoint = aiController->mDestinationPoint;
+    aiRecord.mDriveTargetSegment = aiController->mDriveTargetSegment;
+    aiRecord.mDriveDirection = aiController->mDriveDirection;
+    aiRecord.mFollowPedestrianID = aiController->mFollowPedestrian ? aiController->mFollowPedestrian->mObjectID : GAMEOBJECT_ID_NULL;
+    aiRecord.mRunToTarget = aiController->mRunToTarget;
+    aiRecord.mHasThreatPosition = aiController->mHasThreatPosition;
+    aiRecord.mThreatPosition = aiController->mThreatPosition;
+}
+
+bool GameStateSnapshot::RestoreGameState() const
+{
+    if (IsEmpty())
+        return false;
+
+    if (mMapName != gGameMap.mMapName)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Snapshot was taken on different map '%s'", mMapName.c_str());
+        return false;
+    }
+
+    if (!ValidateMapReferences())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Snapshot does not match style data of map '%s'", mMapName.c_str());
+        return false;
+    }
+
+    gTimeManager.SetGameTime(mGameTime);
+
+    // objects get new identifiers, so references are resolved through original ids
+    std::map<GameObjectID, Vehicle*> restoredVehicles;
+    std::map<GameObjectID, Pedestrian*> restoredPedestrians;
+
+    for (const VehicleRecord& record: mVehicles)
+    {
+        Vehicle* vehicle = gGameObjectsManager.CreateVehicle(record.mPosition, cxx::angle_t::from_degrees(record.mHeading), record.mModelID);
+        if (vehicle == nullptr)
+            continue;
+
+        vehicle->mFlags = record.mFlags;
+        vehicle->mRemapIndex = record.mRemapIndex;
+        vehicle->mCurrentDamage = record.mCurrentDamage;
+        if (record.mCarWrecked)
+        {
+            vehicle->mSpriteIndex = gGameMap.mStyleData.GetWreckedVehicleSpriteIndex(vehicle->mCarInfo->mClassID);
+            vehicle->mRemapIndex = NO_REMAP;
+            vehicle->SetWrecked();
+        }
+        vehicle->mPhysicsBody->SetLinearVelocity(record.mLinearVelocity);
+        vehicle->mPhysicsBody->SetAngularVelocity(cxx::angle_t::from_degrees(record.mAngularVelocity));
+        restoredVehicles[record.mObjectID] = vehicle;
+    }
+
+    std::vector<AiCharacterController*> aiControllers(mPedestrians.size(), nullptr);
+    for (size_t irecord = 0; irecord < mPedestrians.size(); ++irecord)
+    {
+        const PedestrianRecord& record = mPedestrians[irecord];
+
+        Pedestrian* pedestrian = gGameObjectsManager.CreatePedestrian(record.mPosition, cxx::angle_t::from_degrees(record.mHeading),
+            record.mPedestrianType, record.mRemapIndex);
+        if (pedestrian == nullptr)
+            continue;
+
+        pedestrian->mFlags = record.mFlags;
+        pedestrian->mArmorHitPoints = record.mArmorHitPoints;
+        for (int iweapon = 0; iweapon < eWeapon_COUNT; ++iweapon)
+        {
+            Weapon& weapon = pedestrian->mWeapons[iweapon];
+            weapon.SetAmmunition(record.mAmmunition[iweapon]);
+            weapon.mLastFireTime = record.mLastFireTime[iweapon];
+        }
+        pedestrian->mCurrentWeapon = record.mCurrentWeapon;
+        pedestrian->mChangeWeapon = record.mCurrentWeapon;
+
+        auto car_iterator = restoredVehicles.find(record.mCurrentCarID);
+        if (car_iterator != restoredVehicles.end())
+        {
+            pedestrian->PutInsideCar(car_iterator->second, record.mCurrentSeat);
+        }
+        else
+        {
+            pedestrian->mPhysicsBody->SetLinearVelocity(record.mLinearVelocity);
+        }
+        restoredPedestrians[record.mObjectID] = pedestrian;
+
+        if (record.mHumanPlayerIndex > -1 && record.mHumanPlayerIndex < GAME_MAX_PLAYERS)
+        {
+            gCarnageGame.SetupHumanPlayer(record.mHumanPlayerIndex, pedestrian);
+            continue;
+        }
+
+        if (record.mHasAiController)
+        {
+            aiControllers[irecord] = gAiManager.CreateAiController(pedestrian);
+        }
+    }
+
+    // setup ai controllers when all characters are present
+    for (size_t irecord = 0; irecord < mPedestrians.size(); ++irecord)
+    {
+        AiCharacterController* aiController = aiControllers[irecord];
+        if (aiController == nullptr)
+            continue;
+
+        const AiControllerRecord& aiRecord = mPedestrians[irecord].mAiController;
+        aiController->mAiMode = aiRecord.mAiMode;
+        aiController->mAiState = aiRecord.mAiState;
+        aiController->mAiFlags = aiRecord.mAiFlags;
+        aiController->mDestinationPoint = aiRecord.mDestinationPoint;
+        aiController->mDriveTargetSegment = aiRecord.mDriveTargetSegment;
+        aiController->mDriveDirection = aiRecord.mDriveDirection;
+        aiController->mRunToTarget = aiRecord.mRunToTarget;
+        aiController->mHasThreatPosition = aiRecord.mHasThreatPosition;
+        aiController->mThreatPosition = aiRecord.mThreatPosition;
+
+        auto ped_iterator = restoredPedestrians.find(aiRecord.mFollowPedestrianID);
+        if (ped_iterator != restoredPedestrians.end())
+        {
+            aiController->mFollowPedestrian = ped_iterator->second;
+        }
+        else if (aiController->mAiMode == ePedestrianAiMode_FollowTarget)
+        {
+            aiController->StartWandering(); // target was not stored
+        }
+    }
+
+    for (const BroadcastEventRecord& record: mBroadcastEvents)
+    {
+        BroadcastEvent eventData;
+        eventData.mEventType = record.mEventType;
+        eventData.mEventSubject = record.mEventSubject;
+        eventData.mEventTimestamp = record.mEventTimestamp;
+        eventData.mEventDurationTime = record.mEventDurationTime;
+        eventData.mPosition = record.mPosition;
+        if (record.mSubjectID != GAMEOBJECT_ID_NULL)
+        {
+            if (record.mEventSubject == eBroadcastEventSubject_Vehicle)
+            {
+                auto car_iterator = restoredVehicles.find(record.mSubjectID);
+                if (car_iterator != restoredVehicles.end())
+                {
+                    eventData.mSubject = car_iterator->second;
+                }
+            }
+            else if (record.mEventSubject == eBroadcastEventSubject_Pedestrian)
+            {
+                auto ped_iterator = restoredPedestrians.find(record.mSubjectID);
+                if (ped_iterator != restoredPedestrians.end())
+                {
+                    eventData.mSubject = ped_iterator->second;
+                }
+            }
+        }
+        auto character_iterator = restoredPedestrians.find(record.mCharacterID);
+        if (character_iterator != restoredPedestrians.end())
+        {
+            eventData.mCharacter = character_iterator->second;
+        }
+        gBroadcastEvents.RestoreEvent(eventData);
+    }
+
+    // randomizer state goes last, so that objects creation won't affect generated sequence
+    std::istringstream randomizerState(mRandomizerState);
+    if (!gCarnageGame.mGameRand.load_state(randomizerState))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot restore randomizer state");
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Game state restored: %d vehicles, %d pedestrians, %d events",
+        (int) mVehicles.size(), (int) mPedestrians.size(), (int) mBroadcastEvents.size());
+    return true;
+}
+
+bool GameStateSnapshot::ValidateRecords() const
+{
+    for (const VehicleRecord& record: mVehicles)
+    {
+        if ((record.mModelID < 0) || (record.mModelID >= eVehicle_COUNT) ||
+            (record.mRemapIndex < NO_REMAP) || (record.mRemapIndex >= MAX_CAR_REMAPS))
+        {
+            return false;
+        }
+    }
+
+    for (const PedestrianRecord& record: mPedestrians)
+    {
+        if ((record.mPedestrianType < 0) || (record.mPedestrianType >= ePedestrianType_COUNT) ||
+            (record.mRemapIndex < NO_REMAP) || (record.mRemapIndex >= MAX_PED_REMAPS) ||
+            (record.mCurrentSeat < eCarSeat_Driver) || (record.mCurrentSeat > eCarSeat_PassengerExtra) ||
+            (record.mCurrentWeapon < 0) || (record.mCurrentWeapon >= eWeapon_COUNT))
+        {
+            return false;
+        }
+
+        if (!record.mHasAiController)
+            continue;
+
+        const AiControllerRecord& aiRecord = record.mAiController;
+        if ((aiRecord.mAiMode < ePedestrianAiMode_None) || (aiRecord.mAiMode > ePedestrianAiMode_FollowTarget) ||
+            (aiRecord.mAiState < ePedestrianAiState_Idle) || (aiRecord.mAiState > ePedestrianAiState_WalkToLocation) ||
+            (aiRecord.mDriveDirection < 0) || (aiRecord.mDriveDirection >= eMapDirection_COUNT) ||
+            (aiRecord.mDriveTargetSegment < RoadLaneGraph::NullSegment))
+        {
+            return false;
+        }
+    }
+
+    for (const BroadcastEventRecord& record: mBroadcastEvents)
+    {
+        if ((record.mEventType < 0) || (record.mEventType >= eBroadcastEvent_COUNT) ||
+            (record.mEventSubject < eBroadcastEventSubject_None) || (record.mEventSubject > eBroadcastEventSubject_Object))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GameStateSnapshot::ValidateMapReferences() const
+{
+    const StyleData& cityStyle = gGameMap.mStyleData;
+    for (const VehicleRecord& record: mVehicles)
+    {
+        bool hasModel = false;
+        for (const VehicleInfo& currModel: cityStyle.mVehicles)
+        {
+            if (currModel.mModelID == record.mModelID)
+            {
+                hasModel = true;
+                break;
+            }
+        }
+        if (!hasModel)
+            return false;
+    }
+
+    int segmentsCount = (int) gGameMap.mRoadLanes.mSegments.size();
+    for (const PedestrianRecord& record: mPedestrians)
+    {
+        if (record.mHasAiController && (record.mAiController.mDriveTargetSegment >= segmentsCount))
+            return false;
+    }
+    return true;
+}
+
+bool GameStateSnapshot::SaveToFile(const std::string& filePath) const
+{
+    std::ofstream outstream (filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outstream.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot create snapshot file '%s'", filePath.c_str());
+        return false;
+    }
+
+    cxx::write_to_stream(outstream, SnapshotFileSignature);
+    cxx::write_to_stream(outstream, SnapshotFileVersion);
+
+    int mapNameLength = (int) mMapName.length();
+    cxx::write_to_stream(outstream, mapNameLength);
+    outstream.write(mMapName.data(), mapNameLength);
+
+    cxx::write_to_stream(outstream, mGameTime);
+
+    int randomizerStateLength = (int) mRandomizerState.length();
+    cxx::write_to_stream(outstream, randomizerStateLength);
+    outstream.write(mRandomizerState.data(), randomizerStateLength);
+
+    WriteRecords(outstream, mVehicles);
+    WriteRecords(outstream, mPedestrians);
+    WriteRecords(outstream, mBroadcastEvents);
+
+    if (!outstream)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot write snapshot file '%s'", filePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool GameStateSnapshot::LoadFromFile(const std::string& filePath)
+{
+    Clear();
+
+    std::ifstream instream (filePath, std::ios::in | std::ios::binary);
+    if (!instream.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot open snapshot file '%s'", filePath.c_str());
+        return false;
+    }
+
+    unsigned int signature = 0;
+    int version = 0;
+    if (!cxx::read_from_stream(instream, signature) || !cxx::read_from_stream(instream, version) ||
+        (signature != SnapshotFileSignature) || (version != SnapshotFileVersion))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Invalid snapshot file header");
+        return false;
+    }
+
+    bool isSuccess = false;
+    for (;;)
+    {
+        int mapNameLength = 0;
+        if (!cxx::read_from_stream(instream, mapNameLength) || (mapNameLength <= 0) || (mapNameLength > MaxSnapshotStringLength))
+            break;
+
+        mMapName.resize(mapNameLength);
+        if (!instream.read(&mMapName[0], mapNameLength))
+            break;
+
+        if (!cxx::read_from_stream(instream, mGameTime))
+            break;
+
+        int randomizerStateLength = 0;
+        if (!cxx::read_from_stream(instream, randomizerStateLength) || (randomizerStateLength < 0) ||
+            (randomizerStateLength > MaxSnapshotStringLength))
+        {
+            break;
+        }
+
+        mRandomizerState.resize(randomizerStateLength);
+        if (randomizerStateLength > 0 && !instream.read(&mRandomizerState[0], randomizerStateLength))
+            break;
+
+        isSuccess = ReadRecords(instream, mVehicles) && ReadRecords(instream, mPedestrians) &&
+            ReadRecords(instream, mBroadcastEvents) && ValidateRecords();
+        break;
+    }
+
+    if (!isSuccess)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot read snapshot file '%s'", filePath.c_str());
+        Clear();
+    }
+    return isSuccess;
+}
+
+template<typename TRecord>
+void GameStateSnapshot::WriteRecords(std::ostream& outstream, const std::vector<TRecord>& records)
+{
+    static_assert(std::is_trivially_copyable<TRecord>::value, "Snapshot record must be trivially copyable");
+
+    int recordsCount = (int) records.size();
+    cxx::write_to_stream(outstream, recordsCount);
+    if (recordsCount > 0)
+    {
+        outstream.write(reinterpret_cast<const char*>(records.data()), recordsCount * sizeof(TRecord));
+    }
+}
+
+template<typename TRecord>
+bool GameStateSnapshot::ReadRecords(std::istream& instream, std::vector<TRecord>& records)
+{
+    static_assert(std::is_trivially_copyable<TRecord>::value, "Snapshot record must be trivially copyable");
+
+    int recordsCount = 0;
+    if (!cxx::read_from_stream(instream, recordsCount) || (recordsCount < 0) || (recordsCount > MaxSnapshotRecords))
+        return false;
+
+    records.resize(recordsCount);
+    if (recordsCount > 0)
+    {
+        if (!instream.read(reinterpret_cast<char*>(records.data()), recordsCount * sizeof(TRecord)))
+            return false;
+    }
+    return true;
+}
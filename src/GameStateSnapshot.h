@@ -0,0 +1,119 @@
+#pragma once
+
+#include "GameDefs.h"
+#include "AiCharacterController.h"
+#include "BroadcastEventsManager.h"
+
+// Binary snapshot of simulation state
+// Captures dynamic vehicles and pedestrians with their physics state, weapons and ai controllers, broadcast events,
+// randomizer state and game time; static map objects are not stored because they are created on map load,
+// short-living objects such as projectiles, explosions, bullets and effects are not stored as well
+class GameStateSnapshot final: public cxx::noncopyable
+{
+public:
+    // readonly
+    std::string mMapName;
+    float mGameTime = 0.0f;
+
+public:
+    // Store current game state
+    void CaptureGameState();
+
+    // Recreate stored objects within current scenario, map with same name must be loaded
+    // @returns false if snapshot is empty, map does not match or records refer to missing style data
+    bool RestoreGameState() const;
+
+    // Write or read snapshot binary data
+    // @param filePath: Snapshot file path
+    bool SaveToFile(const std::string& filePath) const;
+    bool LoadFromFile(const std::string& filePath);
+
+    void Clear();
+
+    inline bool IsEmpty() const { return mMapName.empty(); }
+
+private:
+    // stored vehicle data, must be trivially copyable
+    struct VehicleRecord
+    {
+        GameObjectID mObjectID;
+        eGameObjectFlags mFlags;
+        eVehicleModel mModelID;
+        int mRemapIndex;
+        int mCurrentDamage;
+        bool mCarWrecked;
+        glm::vec3 mPosition;
+        float mHeading; // degrees
+        glm::vec2 mLinearVelocity;
+        float mAngularVelocity; // degrees per second
+    };
+
+    // stored ai controller data, must be trivially copyable
+    struct AiControllerRecord
+    {
+        ePedestrianAiMode mAiMode;
+        ePedestrianAiState mAiState;
+        ePedestrianAiFlags mAiFlags;
+        glm::vec2 mDestinationPoint;
+        int mDriveTargetSegment;
+        eMapDirection mDriveDirection;
+        GameObjectID mFollowPedestrianID;
+        bool mRunToTarget;
+        bool mHasThreatPosition;
+        glm::vec2 mThreatPosition;
+    };
+
+    // stored pedestrian data, must be trivially copyable
+    struct PedestrianRecord
+    {
+        GameObjectID mObjectID;
+        eGameObjectFlags mFlags;
+        ePedestrianType mPedestrianType;
+        int mRemapIndex;
+        int mArmorHitPoints;
+        glm::vec3 mPosition;
+        float mHeading; // degrees
+        glm::vec2 mLinearVelocity;
+        GameObjectID mCurrentCarID;
+        eCarSeat mCurrentSeat;
+        eWeaponID mCurrentWeapon;
+        int mAmmunition[eWeapon_COUNT];
+        float mLastFireTime[eWeapon_COUNT];
+        int mHumanPlayerIndex; // -1 if not human player character
+        bool mHasAiController;
+        AiControllerRecord mAiController;
+    };
+
+    // stored broadcast event data, must be trivially copyable
+    struct BroadcastEventRecord
+    {
+        eBroadcastEvent mEventType;
+        eBroadcastEventSubject mEventSubject;
+        float mEventTimestamp;
+        float mEventDurationTime;
+        glm::vec2 mPosition;
+        GameObjectID mSubjectID;
+        GameObjectID mCharacterID;
+    };
+
+private:
+    void CaptureVehicle(Vehicle* vehicle);
+    void CapturePedestrian(Pedestrian* pedestrian);
+
+    // Check that enums and indices in records are within valid ranges
+    bool ValidateRecords() const;
+    // Check that records refer to existing vehicle models and road lanes of current map
+    bool ValidateMapReferences() const;
+
+    template<typename TRecord>
+    static void WriteRecords(std::ostream& outstream, const std::vector<TRecord>& records);
+
+    template<typename TRecord>
+    static bool ReadRecords(std::istream& instream, std::vector<TRecord>& records);
+
+private:
+    std::string mRandomizerState;
+    std::vector<VehicleRecord> mVehicles;
+    std::vector<PedestrianRecord> mPedestrians;
+    std::vector<BroadcastEventRecord> mBroadcastEvents;
+};
@@ -130,16 +130,56 @@ bool GameTextsManager::Initialize()
 
 void GameTextsManager::Deinit()
 {
-    mStrings.clear();
+    mTextSlots.clear();
+    mStringsArena.clear();
+    mTextsCount = 0;
 }
 
-const std::string& GameTextsManager::GetText(const std::string& textID) const
+const char* GameTextsManager::GetText(GameTextID textID) const
 {
-    auto find_iterator = mStrings.find(textID);
-    if (find_iterator == mStrings.end())
-        return mErrorString;
+    if (mTextSlots.empty())
+        return mErrorString.c_str();
 
-    return find_iterator->second;
+    // table is never full so empty slot terminates search
+    const unsigned int slotsMask = mTextSlots.size() - 1;
+    for (unsigned int islot = (textID & slotsMask);; islot = (islot + 1) & slotsMask)
+    {
+        const TextSlot& currSlot = mTextSlots[islot];
+        if (currSlot.mStringOffset < 0)
+            break;
+
+        if (currSlot.mTextID == textID)
+            return &mStringsArena[currSlot.mStringOffset];
+    }
+    return mErrorString.c_str();
+}
+
+const char* GameTextsManager::GetText(const char* textKey) const
+{
+    debug_assert(textKey);
+    return GetText(MakeGameTextID(textKey));
+}
+
+void GameTextsManager::InsertText(GameTextID textID, int stringOffset)
+{
+    const unsigned int slotsMask = mTextSlots.size() - 1;
+    for (unsigned int islot = (textID & slotsMask);; islot = (islot + 1) & slotsMask)
+    {
+        TextSlot& currSlot = mTextSlots[islot];
+        if (currSlot.mStringOffset < 0)
+        {
+            currSlot.mTextID = textID;
+            currSlot.mStringOffset = stringOffset;
+            ++mTextsCount;
+            break;
+        }
+
+        if (currSlot.mTextID == textID)
+        {
+            currSlot.mStringOffset = stringOffset;
+            break;
+        }
+    }
 }
 
 bool GameTextsManager::LoadTexts(const std::string& fileName)
@@ -151,20 +191,52 @@ bool GameTextsManager::LoadTexts(const std::string& fileName)
         return false;
     }
 
-    mStrings.clear();
+    Deinit();
 
     FXTReader fxtreader(fileStream);
     
     std::string key;
     std::string value;
 
+    std::vector<TextSlot> loadedTexts;
+    // keys are only kept while loading to detect identifiers collisions
+    std::map<GameTextID, std::string> loadedKeys;
     for (;;)
     {
         if (!fxtreader.get_next_key_value(key, value))
             break;
 
-        mStrings[key] = value;
+        GameTextID textID = MakeGameTextID(key.c_str());
+        auto insert_result = loadedKeys.emplace(textID, key);
+        if (!insert_result.second && insert_result.first->second != key)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Text key '%s' collides with '%s', ignored", key.c_str(), 
+                insert_result.first->second.c_str());
+            continue;
+        }
+
+        TextSlot& loadedText = loadedTexts.emplace_back();
+        loadedText.mTextID = textID;
+        loadedText.mStringOffset = (int) mStringsArena.size();
+        mStringsArena.insert(mStringsArena.end(), value.begin(), value.end());
+        mStringsArena.push_back(0);
     }
-    
+    mStringsArena.shrink_to_fit();
+
+    // keep load factor below half
+    unsigned int slotsCount = 16;
+    while (slotsCount < loadedTexts.size() * 2)
+    {
+        slotsCount *= 2;
+    }
+    mTextSlots.resize(slotsCount);
+
+    for (const TextSlot& currText: loadedTexts)
+    {
+        InsertText(currText.mTextID, currText.mStringOffset);
+    }
+
+    gConsole.LogMessage(eLogMessage_Debug, "Loaded %d game texts (%d bytes)", mTextsCount, 
+        (int) (mStringsArena.size() + mTextSlots.size() * sizeof(TextSlot)));
     return true;
 }
@@ -1,5 +1,21 @@
 #pragma once
 
+// Hashed game text key
+using GameTextID = unsigned int;
+
+// Compute game text identifier, could be evaluated at compile time for fixed keys
+// @param textKey: Text key as specified in texts file, case sensitive
+constexpr GameTextID MakeGameTextID(const char* textKey)
+{
+    // 32 bit fnv-1a
+    GameTextID hashValue = 2166136261u;
+    for (; *textKey; ++textKey)
+    {
+        hashValue = (hashValue ^ (unsigned char) *textKey) * 16777619u;
+    }
+    return hashValue;
+}
+
 // Class is responsible for reading and storing game messages
 class GameTextsManager final: public cxx::noncopyable
 {
@@ -10,12 +26,29 @@ public:
     // Loads game texts from source file
     bool LoadTexts(const std::string& fileName);
 
-    // Find game text by text identifier
+    // Find game text by text identifier, does not allocate memory
+    // @param textID: Text identifier
+    // @param textKey: Text key as specified in texts file
     // @returns default error message on nothing found
-    const std::string& GetText(const std::string& textID) const;
+    const char* GetText(GameTextID textID) const;
+    const char* GetText(const char* textKey) const;
+
+private:
+    // hash table slot
+    struct TextSlot
+    {
+    public:
+        GameTextID mTextID = 0;
+        int mStringOffset = -1; // within strings arena, negative for empty slot
+    };
+
+    // Insert text into hash table, text with same identifier gets replaced
+    void InsertText(GameTextID textID, int stringOffset);
 
 private:
-    std::map<std::string, std::string> mStrings;
+    std::vector<TextSlot> mTextSlots; // open addressing with linear probing, size is power of two
+    std::vector<char> mStringsArena; // null terminated strings stored one after another
+    int mTextsCount = 0;
     std::string mErrorString;
 };
 
@@ -66,6 +66,11 @@ void GpuBuffer::SetUnbound()
     {
         mGraphicsContext.mCurrentBuffers[mContent] = nullptr;
     }
+
+    if (mGraphicsContext.mAttributesSourceBuffer == this)
+    {
+        mGraphicsContext.InvalidateVertexAttributes();
+    }
 }
 
 bool GpuBuffer::Setup(eBufferUsage bufferUsage, unsigned int bufferLength, const void* dataBuffer)
@@ -95,6 +100,8 @@ bool GpuBuffer::Setup(eBufferUsage bufferUsage, unsigned int bufferLength, const
         {
             ::memcpy(pMappedData, dataBuffer, bufferLength);
         }
+        gGraphicsDevice.mFrameCounters.mBufferUploadBytes += bufferLength;
+        ++gGraphicsDevice.mFrameCounters.mBufferUploadCalls;
 
         GLboolean unmapResult = ::glUnmapBuffer(bufferTargetGL);
         glCheckError();
@@ -153,6 +160,12 @@ bool GpuBuffer::Resize(unsigned int newLength)
     mBufferLength = newLength;
     mResourceHandle = newVBO;
 
+    // attribute pointers refer to old buffer object
+    if (mGraphicsContext.mAttributesSourceBuffer == this)
+    {
+        mGraphicsContext.InvalidateVertexAttributes();
+    }
+
     // restore state
     if (!wasBound)
     {
@@ -179,6 +192,9 @@ bool GpuBuffer::SubData(unsigned int dataOffset, unsigned int dataLength, const
     ::glBufferSubData(bufferTargetGL, dataOffset, dataLength, dataSource);
     glCheckError();
 
+    gGraphicsDevice.mFrameCounters.mBufferUploadBytes += dataLength;
+    ++gGraphicsDevice.mFrameCounters.mBufferUploadCalls;
+
     return true;
 }
 
@@ -215,6 +231,13 @@ void* GpuBuffer::Lock(BufferAccessBits accessBits, unsigned int bufferOffset, un
     GLenum bufferTargetGL = EnumToGL(mContent);
     void* pMappedData = ::glMapBufferRange(bufferTargetGL, bufferOffset, dataLength, accessBitsGL);
     glCheckError();
+
+    // assume that whole mapped range gets written
+    if (pMappedData && (accessBits & BufferAccess_Write))
+    {
+        gGraphicsDevice.mFrameCounters.mBufferUploadBytes += dataLength;
+        ++gGraphicsDevice.mFrameCounters.mBufferUploadCalls;
+    }
     return pMappedData;
 }
 
@@ -89,6 +89,11 @@ bool GpuBufferTexture::Setup(eTextureFormat textureFormat, int dataLength, const
 	::glBufferData(GL_TEXTURE_BUFFER, dataLength, sourceData, GL_DYNAMIC_DRAW);
     glCheckError();
 
+    if (sourceData)
+    {
+        gGraphicsDevice.mFrameCounters.mBufferUploadBytes += dataLength;
+    }
+
     ::glBindBuffer(GL_TEXTURE_BUFFER, 0);
     glCheckError();
 
@@ -136,6 +141,8 @@ bool GpuBufferTexture::Upload(int dataOffset, int dataLength, const void* source
 	::glBufferSubData(GL_TEXTURE_BUFFER, dataOffset, dataLength, sourceData);
     glCheckError();
 
+    gGraphicsDevice.mFrameCounters.mBufferUploadBytes += dataLength;
+
     ::glBindBuffer(GL_TEXTURE_BUFFER, 0);
     glCheckError();
     return true;
@@ -96,54 +96,83 @@ bool GpuProgram::IsProgramCompiled() const
 void GpuProgram::SetUniform(eRenderUniform constant, float param0)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &param0, sizeof(param0)))
+        return;
+
     SetCustomUniform(mConstants[constant], param0);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, float param0, float param1)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    const float values[] = {param0, param1};
+    if (!UpdateUniformValue(constant, values, sizeof(values)))
+        return;
+
     SetCustomUniform(mConstants[constant], param0, param1);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, float param0, float param1, float param2)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    const float values[] = {param0, param1, param2};
+    if (!UpdateUniformValue(constant, values, sizeof(values)))
+        return;
+
     SetCustomUniform(mConstants[constant], param0, param1, param2);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, int param0)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &param0, sizeof(param0)))
+        return;
+
     SetCustomUniform(mConstants[constant], param0);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, const glm::vec2& floatVector2)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &floatVector2, sizeof(floatVector2)))
+        return;
+
     SetCustomUniform(mConstants[constant], floatVector2);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, const glm::vec3& floatVector3)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &floatVector3, sizeof(floatVector3)))
+        return;
+
     SetCustomUniform(mConstants[constant], floatVector3);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, const glm::vec4& floatVector4)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &floatVector4, sizeof(floatVector4)))
+        return;
+
     SetCustomUniform(mConstants[constant], floatVector4);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, const glm::mat3& floatMatrix3)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &floatMatrix3, sizeof(floatMatrix3)))
+        return;
+
     SetCustomUniform(mConstants[constant], floatMatrix3);
 }
 
 void GpuProgram::SetUniform(eRenderUniform constant, const glm::mat4& floatMatrix4)
 {
     debug_assert(constant < eRenderUniform_COUNT);
+    if (!UpdateUniformValue(constant, &floatMatrix4, sizeof(floatMatrix4)))
+        return;
+
     SetCustomUniform(mConstants[constant], floatMatrix4);
 }
 
@@ -252,6 +281,13 @@ bool GpuProgram::CompileSourceCode(const char* shaderSource)
     // clear old program data
     mInputLayout.mEnabledAttributes = 0;
 
+    for (GraphicsContext::UniformValue& uniformValue: mUniformValues) { uniformValue.mDataSize = 0; }
+
+    if (mGraphicsContext.mAttributesProgram == this)
+    {
+        mGraphicsContext.InvalidateVertexAttributes();
+    }
+
     for (GpuVariableLocation& location: mAttributes) { location = GpuVariableNULL; }
     for (GpuVariableLocation& location: mConstants) { location = GpuVariableNULL; }
     for (GpuVariableLocation& location: mSamplers) { location = GpuVariableNULL; }
@@ -368,4 +404,18 @@ void GpuProgram::SetUnbound()
     {
         mGraphicsContext.mCurrentProgram = nullptr;
     }
+    if (this == mGraphicsContext.mAttributesProgram)
+    {
+        mGraphicsContext.InvalidateVertexAttributes();
+    }
+}
+
+bool GpuProgram::UpdateUniformValue(eRenderUniform constant, const void* sourceData, int dataSize)
+{
+    if (!mGraphicsContext.ChangeUniformValue(mUniformValues[constant], sourceData, dataSize))
+    {
+        ++gGraphicsDevice.mFrameCounters.mRedundantCallsSkipped;
+        return false;
+    }
+    return true;
 }
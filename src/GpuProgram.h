@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GraphicsDefs.h"
+#include "GraphicsContext.h"
 
 // defines hardware render program object
 class GpuProgram final: public cxx::noncopyable
@@ -65,6 +66,11 @@ private:
     bool CompileSourceCode(GpuProgramHandle targetHandle, const char* programSrc);
     void SetUnbound();
 
+    // Store standard constant value
+    // @returns false if value is not changed and upload could be skipped
+    bool UpdateUniformValue(eRenderUniform constant, const void* sourceData, int dataSize);
+
 private:
     GraphicsContext& mGraphicsContext;
+    GraphicsContext::UniformValue mUniformValues[eRenderUniform_COUNT]; // last uploaded values of standard constants
 };
\ No newline at end of file
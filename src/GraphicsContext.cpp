@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "GraphicsContext.h"
+
+bool GraphicsContext::SelfCheck()
+{
+    // objects are only compared by address and never dereferenced
+    int dummyObjects[4] = {};
+    GpuBuffer* bufferA = reinterpret_cast<GpuBuffer*>(&dummyObjects[0]);
+    GpuBuffer* bufferB = reinterpret_cast<GpuBuffer*>(&dummyObjects[1]);
+    GpuProgram* programA = reinterpret_cast<GpuProgram*>(&dummyObjects[2]);
+    GpuProgram* programB = reinterpret_cast<GpuProgram*>(&dummyObjects[3]);
+    GpuTexture2D* textureA = reinterpret_cast<GpuTexture2D*>(&dummyObjects[0]);
+    GpuTextureArray2D* textureArrayA = reinterpret_cast<GpuTextureArray2D*>(&dummyObjects[0]);
+
+    VertexFormat formatA;
+    formatA.SetAttribute(eVertexAttribute_Position0, eVertexAttributeFormat_3F, 0);
+    formatA.mDataStride = 12;
+    VertexFormat formatB = formatA;
+    formatB.mBaseOffset = 1024;
+
+    GraphicsContext context;
+
+    int mismatches = 0;
+    auto expectChange = [&mismatches](bool isChanged, bool expected)
+    {
+        if (isChanged != expected)
+        {
+            ++mismatches;
+        }
+    };
+
+    expectChange(context.ChangeProgram(programA), true);
+    expectChange(context.ChangeProgram(programA), false);
+    expectChange(context.ChangeProgram(nullptr), true);
+    expectChange(context.ChangeProgram(programA), true);
+
+    expectChange(context.ChangeBuffer(eBufferContent_Vertices, bufferA), true);
+    expectChange(context.ChangeBuffer(eBufferContent_Vertices, bufferA), false);
+    expectChange(context.ChangeBuffer(eBufferContent_Indices, bufferA), true);
+    expectChange(context.ChangeBuffer(eBufferContent_Vertices, nullptr), true);
+
+    expectChange(context.ChangeTextureUnit(eTextureUnit_0), false);
+    expectChange(context.ChangeTextureUnit(eTextureUnit_1), true);
+    expectChange(context.ChangeTextureUnit(eTextureUnit_1), false);
+
+    // texture types share unit but are tracked separately
+    expectChange(context.ChangeTexture(eTextureUnit_0, textureA), true);
+    expectChange(context.ChangeTexture(eTextureUnit_0, textureA), false);
+    expectChange(context.ChangeTexture(eTextureUnit_0, textureArrayA), true);
+    expectChange(context.ChangeTexture(eTextureUnit_1, textureA), true);
+    expectChange(context.ChangeTexture(eTextureUnit_0, (GpuTexture2D*) nullptr), true);
+
+    expectChange(context.ChangeAttributeArrayEnabled(0, false), false);
+    expectChange(context.ChangeAttributeArrayEnabled(0, true), true);
+    expectChange(context.ChangeAttributeArrayEnabled(0, true), false);
+    expectChange(context.ChangeAttributeArrayEnabled(1, true), true);
+
+    expectChange(context.ChangeAttributeDivisor(2, 0), false);
+    expectChange(context.ChangeAttributeDivisor(2, 1), true);
+    expectChange(context.ChangeAttributeDivisor(2, 1), false);
+
+    // attribute pointers depend on source buffer, program and format
+    expectChange(context.ChangeVertexAttributes(bufferA, formatA), true);
+    expectChange(context.ChangeVertexAttributes(bufferA, formatA), false);
+    expectChange(context.ChangeVertexAttributes(bufferB, formatA), true);
+    expectChange(context.ChangeVertexAttributes(bufferB, formatB), true);
+    context.ChangeProgram(programB);
+    expectChange(context.ChangeVertexAttributes(bufferB, formatB), true);
+    expectChange(context.ChangeVertexAttributes(bufferB, formatB), false);
+    context.InvalidateVertexAttributes();
+    expectChange(context.ChangeVertexAttributes(bufferB, formatB), true);
+
+    UniformValue uniformValue;
+    glm::vec4 colorA (1.0f, 0.5f, 0.25f, 1.0f);
+    glm::vec4 colorB (1.0f, 0.5f, 0.25f, 0.0f);
+    float scalarA = 1.0f;
+    expectChange(context.ChangeUniformValue(uniformValue, &colorA, sizeof(colorA)), true);
+    expectChange(context.ChangeUniformValue(uniformValue, &colorA, sizeof(colorA)), false);
+    expectChange(context.ChangeUniformValue(uniformValue, &colorB, sizeof(colorB)), true);
+    expectChange(context.ChangeUniformValue(uniformValue, &scalarA, sizeof(scalarA)), true);
+    expectChange(context.ChangeUniformValue(uniformValue, &scalarA, sizeof(scalarA)), false);
+    uniformValue.mDataSize = 0;
+    expectChange(context.ChangeUniformValue(uniformValue, &scalarA, sizeof(scalarA)), true);
+
+    // without filtering every request must be submitted
+    context.mFilterRedundantCalls = false;
+    expectChange(context.ChangeProgram(programB), true);
+    expectChange(context.ChangeBuffer(eBufferContent_Indices, bufferA), true);
+    expectChange(context.ChangeTextureUnit(eTextureUnit_1), true);
+    expectChange(context.ChangeTexture(eTextureUnit_1, textureA), true);
+    expectChange(context.ChangeAttributeArrayEnabled(1, true), true);
+    expectChange(context.ChangeAttributeDivisor(2, 1), true);
+    expectChange(context.ChangeVertexAttributes(bufferB, formatB), true);
+    expectChange(context.ChangeUniformValue(uniformValue, &scalarA, sizeof(scalarA)), true);
+
+    return mismatches == 0;
+}
@@ -14,8 +14,134 @@ public:
         , mCurrentTextures()
         , mCurrentProgram()
         , mVaoHandle()
+        , mEnabledAttributeArrays()
+        , mAttributeDivisors()
     {
     }
+
+    // Forget vertex attributes setup, must be called when source buffer or program objects are changed
+    inline void InvalidateVertexAttributes()
+    {
+        mAttributesSourceBuffer = nullptr;
+        mAttributesProgram = nullptr;
+    }
+
+    // Redundant state filtering, methods compare requested state against current one and remember it,
+    // they never touch graphics api so device submits calls only when true is returned
+    // @returns true if state is changed and call must be submitted
+
+    inline bool ChangeBuffer(eBufferContent bufferContent, GpuBuffer* buffer)
+    {
+        if (mFilterRedundantCalls && mCurrentBuffers[bufferContent] == buffer)
+            return false;
+
+        mCurrentBuffers[bufferContent] = buffer;
+        return true;
+    }
+
+    inline bool ChangeProgram(GpuProgram* program)
+    {
+        if (mFilterRedundantCalls && mCurrentProgram == program)
+            return false;
+
+        mCurrentProgram = program;
+        return true;
+    }
+
+    inline bool ChangeTextureUnit(eTextureUnit textureUnit)
+    {
+        if (mFilterRedundantCalls && mCurrentTextureUnit == textureUnit)
+            return false;
+
+        mCurrentTextureUnit = textureUnit;
+        return true;
+    }
+
+    inline bool ChangeTexture(eTextureUnit textureUnit, GpuBufferTexture* texture)
+    {
+        return ChangeTextureState(mCurrentTextures[textureUnit].mBufferTexture, texture);
+    }
+
+    inline bool ChangeTexture(eTextureUnit textureUnit, GpuTexture2D* texture)
+    {
+        return ChangeTextureState(mCurrentTextures[textureUnit].mTexture2D, texture);
+    }
+
+    inline bool ChangeTexture(eTextureUnit textureUnit, GpuTextureArray2D* texture)
+    {
+        return ChangeTextureState(mCurrentTextures[textureUnit].mTextureArray2D, texture);
+    }
+
+    inline bool ChangeAttributeArrayEnabled(int attributeIndex, bool isEnabled)
+    {
+        if (mFilterRedundantCalls && mEnabledAttributeArrays[attributeIndex] == isEnabled)
+            return false;
+
+        mEnabledAttributeArrays[attributeIndex] = isEnabled;
+        return true;
+    }
+
+    inline bool ChangeAttributeDivisor(int attributeIndex, unsigned int divisor)
+    {
+        if (mFilterRedundantCalls && mAttributeDivisors[attributeIndex] == divisor)
+            return false;
+
+        mAttributeDivisors[attributeIndex] = divisor;
+        return true;
+    }
+
+    // attribute pointers are still valid if source buffer, current program and layout are same
+    inline bool ChangeVertexAttributes(GpuBuffer* sourceBuffer, const VertexFormat& streamDefinition)
+    {
+        if (mFilterRedundantCalls && mAttributesSourceBuffer == sourceBuffer && 
+            mAttributesProgram == mCurrentProgram && mAttributesFormat == streamDefinition)
+        {
+            return false;
+        }
+
+        mAttributesSourceBuffer = sourceBuffer;
+        mAttributesProgram = mCurrentProgram;
+        mAttributesFormat = streamDefinition;
+        return true;
+    }
+
+    // last uploaded value of program constant
+    struct UniformValue
+    {
+        float mData[16]; // enough for 4x4 matrix
+        int mDataSize = 0; // bytes, 0 if value is unknown
+    };
+
+    inline bool ChangeUniformValue(UniformValue& uniformValue, const void* sourceData, int dataSize)
+    {
+        debug_assert(dataSize <= (int) sizeof(uniformValue.mData));
+        if (mFilterRedundantCalls && uniformValue.mDataSize == dataSize && 
+            ::memcmp(uniformValue.mData, sourceData, dataSize) == 0)
+        {
+            return false;
+        }
+
+        uniformValue.mDataSize = dataSize;
+        ::memcpy(uniformValue.mData, sourceData, dataSize);
+        return true;
+    }
+
+    // Run scripted sequence of state changes against standalone context and verify filtering decisions,
+    // does not access graphics api
+    // @returns false on mismatch
+    static bool SelfCheck();
+
+private:
+    template<typename TTexture>
+    inline bool ChangeTextureState(TTexture*& currentTexture, TTexture* texture)
+    {
+        if (mFilterRedundantCalls && currentTexture == texture)
+            return false;
+
+        currentTexture = texture;
+        return true;
+    }
+
 public:
 
     struct TextureUnitState
@@ -31,4 +157,16 @@ public:
     GpuProgram* mCurrentProgram;
     eTextureUnit mCurrentTextureUnit;
     TextureUnitState mCurrentTextures[eTextureUnit_COUNT];
+
+    // vertex attributes state of vao
+    bool mEnabledAttributeArrays[eVertexAttribute_MAX];
+    unsigned int mAttributeDivisors[eVertexAttribute_MAX];
+
+    // attribute pointers refer to buffer object and program attribute locations which were current during setup
+    GpuBuffer* mAttributesSourceBuffer = nullptr;
+    GpuProgram* mAttributesProgram = nullptr;
+    VertexFormat mAttributesFormat;
+
+    // redundant calls filtering is disabled if self check fails, so every change gets submitted
+    bool mFilterRedundantCalls = true;
 };
\ No newline at end of file
@@ -14,6 +14,7 @@ using GpuProgramHandle = unsigned int;
 using GpuBufferHandle = unsigned int;
 using GpuTextureHandle = unsigned int;
 using GpuVertexArrayHandle = unsigned int;
+using GpuQueryHandle = unsigned int;
 using GpuVariableLocation = int;
 
 // predefined value for unspecified render program variable location
@@ -237,6 +238,17 @@ enum eTextureWrapMode
 
 decl_enum_strings(eTextureWrapMode);
 
+// opengl context creation backend
+enum eGraphicsContextApi
+{
+    eGraphicsContextApi_Native, // glx, wgl or nsgl depending on platform
+    eGraphicsContextApi_EGL,
+    eGraphicsContextApi_OSMesa, // software rendering
+    eGraphicsContextApi_COUNT
+};
+
+decl_enum_strings(eGraphicsContextApi);
+
 enum eTextureFormat
 {
     eTextureFormat_Null,
@@ -328,6 +340,7 @@ enum eVertexAttributeFormat
 {
     eVertexAttributeFormat_2F,      // 2 floats
     eVertexAttributeFormat_3F,      // 3 floats
+    eVertexAttributeFormat_4F,      // 4 floats
     eVertexAttributeFormat_4UB,     // 4 unsigned bytes
     eVertexAttributeFormat_1US,     // 1 unsigned short
     eVertexAttributeFormat_2US,     // 2 unsigned shorts
@@ -360,6 +373,7 @@ inline unsigned int GetAttributeComponentCount(eVertexAttributeFormat attributeF
     {
         case eVertexAttributeFormat_2F: return 2;
         case eVertexAttributeFormat_3F: return 3;
+        case eVertexAttributeFormat_4F: return 4;
         case eVertexAttributeFormat_4UB: return 4;
         case eVertexAttributeFormat_1US: return 1;
         case eVertexAttributeFormat_2US: return 2;
@@ -376,6 +390,7 @@ inline unsigned int GetAttributeSizeBytes(eVertexAttributeFormat attributeFormat
     {
         case eVertexAttributeFormat_2F: return 2 * sizeof(float);
         case eVertexAttributeFormat_3F: return 3 * sizeof(float);
+        case eVertexAttributeFormat_4F: return 4 * sizeof(float);
         case eVertexAttributeFormat_4UB: return 4 * sizeof(unsigned char);
         case eVertexAttributeFormat_1US: return 1 * sizeof(unsigned short);
         case eVertexAttributeFormat_2US: return 2 * sizeof(unsigned short);
@@ -424,8 +439,27 @@ public:
     SingleAttribute mAttributes[eVertexAttribute_COUNT];
     unsigned int mDataStride = 0; // common to all attributes
     unsigned int mBaseOffset = 0; // additional offset in bytes within source vertex buffer, affects on all attribues
+    unsigned int mInstanceDivisor = 0; // 0 for per vertex data, otherwise attributes advance once per specified number of instances
 };
 
+inline bool operator == (const VertexFormat::SingleAttribute& a, const VertexFormat::SingleAttribute& b)
+{
+    return a.mFormat == b.mFormat && a.mDataOffset == b.mDataOffset && a.mNormalized == b.mNormalized;
+}
+
+inline bool operator == (const VertexFormat& a, const VertexFormat& b)
+{
+    if (a.mDataStride != b.mDataStride || a.mBaseOffset != b.mBaseOffset || a.mInstanceDivisor != b.mInstanceDivisor)
+        return false;
+
+    for (int iattribute = 0; iattribute < eVertexAttribute_COUNT; ++iattribute)
+    {
+        if (!(a.mAttributes[iattribute] == b.mAttributes[iattribute]))
+            return false;
+    }
+    return true;
+}
+
 // standard engine vertex definition
 struct Vertex3D_Format: public VertexFormat
 {
@@ -701,6 +735,8 @@ enum eGraphicsFeature
 {
     eGraphicsFeature_NPOT_Textures,
     eGraphicsFeature_ABGR,
+    eGraphicsFeature_TimerQuery,
+    eGraphicsFeature_InstancedArrays,
     eGraphicsFeature_COUNT
 };
 
@@ -713,4 +749,45 @@ public:
     int mMaxArrayTextureLayers;
     int mMaxTextureBufferSize;
     bool mFeatures[eGraphicsFeature_COUNT];
+};
+// graphics device work counters
+struct RenderCounters
+{
+public:
+    RenderCounters() = default;
+
+    inline void Clear()
+    {
+        *this = RenderCounters();
+    }
+
+    inline RenderCounters operator - (const RenderCounters& rhs) const
+    {
+        RenderCounters result;
+        result.mDrawCalls = mDrawCalls - rhs.mDrawCalls;
+        result.mVerticesSubmitted = mVerticesSubmitted - rhs.mVerticesSubmitted;
+        result.mIndicesSubmitted = mIndicesSubmitted - rhs.mIndicesSubmitted;
+        result.mTextureBinds = mTextureBinds - rhs.mTextureBinds;
+        result.mProgramBinds = mProgramBinds - rhs.mProgramBinds;
+        result.mRenderStateChanges = mRenderStateChanges - rhs.mRenderStateChanges;
+        result.mBufferUploadBytes = mBufferUploadBytes - rhs.mBufferUploadBytes;
+        result.mBufferUploadCalls = mBufferUploadCalls - rhs.mBufferUploadCalls;
+        result.mSpriteBatchBreaks = mSpriteBatchBreaks - rhs.mSpriteBatchBreaks;
+        result.mRedundantCallsSkipped = mRedundantCallsSkipped - rhs.mRedundantCallsSkipped;
+        result.mHudQuadsRebuilt = mHudQuadsRebuilt - rhs.mHudQuadsRebuilt;
+        return result;
+    }
+
+public:
+    int mDrawCalls = 0;
+    int mVerticesSubmitted = 0; // non-indexed draws
+    int mIndicesSubmitted = 0; // indexed draws
+    int mTextureBinds = 0;
+    int mProgramBinds = 0;
+    int mRenderStateChanges = 0;
+    int mBufferUploadBytes = 0;
+    int mBufferUploadCalls = 0;
+    int mSpriteBatchBreaks = 0; // reported by sprite batches when texture changes
+    int mRedundantCallsSkipped = 0; // state changes filtered out by shadow state
+    int mHudQuadsRebuilt = 0; // reported by hud panels when cached sprites get regenerated
 };
\ No newline at end of file
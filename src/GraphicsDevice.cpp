@@ -155,9 +155,10 @@ bool GraphicsDevice::Initialize()
 
     mScreenResolution.x = config.mScreenSizex;
     mScreenResolution.y = config.mScreenSizey;
-    gConsole.LogMessage(eLogMessage_Debug, "GraphicsDevice Initialization (%dx%d, Vsync: %s, Fullscreen: %s)",
+    gConsole.LogMessage(eLogMessage_Debug, "GraphicsDevice Initialization (%dx%d, Vsync: %s, Fullscreen: %s, Offscreen: %s, Context: %s)",
         mScreenResolution.x, mScreenResolution.y, 
-        config.mEnableVSync ? "enabled" : "disabled", config.mFullscreen ? "yes" : "no");
+        config.mEnableVSync ? "enabled" : "disabled", config.mFullscreen ? "yes" : "no", config.mOffscreen ? "yes" : "no",
+        cxx::enum_to_string(config.mGraphicsContextApi));
 
     if (::glfwInit() == GL_FALSE)
     {
@@ -178,7 +179,7 @@ bool GraphicsDevice::Initialize()
     );
 
     GLFWmonitor* graphicsMonitor = nullptr;
-    if (config.mFullscreen)
+    if (config.mFullscreen && !config.mOffscreen)
     {
         graphicsMonitor = ::glfwGetPrimaryMonitor();
         debug_assert(graphicsMonitor);
@@ -201,6 +202,23 @@ bool GraphicsDevice::Initialize()
     ::glfwWindowHint(GLFW_DEPTH_BITS, 24);
     ::glfwWindowHint(GLFW_DOUBLEBUFFER, 1);
 
+    // offscreen mode renders into hidden window, frames could be read back with ReadScreenPixels
+    if (config.mOffscreen)
+    {
+        ::glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+        ::glfwWindowHint(GLFW_FOCUSED, GL_FALSE);
+    }
+
+    // egl and osmesa backends allow to create context without gpu or display server extensions
+    if (config.mGraphicsContextApi == eGraphicsContextApi_EGL)
+    {
+        ::glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+    else if (config.mGraphicsContextApi == eGraphicsContextApi_OSMesa)
+    {
+        ::glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    }
+
     // create window and set current context
     GLFWwindow* graphicsWindow = ::glfwCreateWindow(mScreenResolution.x, mScreenResolution.y, GAME_TITLE, graphicsMonitor, nullptr);
     debug_assert(graphicsWindow);
@@ -283,6 +301,12 @@ bool GraphicsDevice::Initialize()
 
     QueryGraphicsDeviceCaps();
 
+    if (!GraphicsContext::SelfCheck())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Graphics context self check failed, redundant calls filtering disabled");
+        mGraphicsContext.mFilterRedundantCalls = false;
+    }
+
     // create global vertex array object
     ::glGenVertexArrays(1, &mGraphicsContext.mVaoHandle);
     glCheckError();
@@ -317,8 +341,9 @@ bool GraphicsDevice::Initialize()
     RenderStates defaultRenderStates;
     InternalSetRenderStates(defaultRenderStates, true);
 
-    EnableFullscreen(config.mFullscreen);
-    EnableVSync(config.mEnableVSync);
+    // there is no reason to wait for vertical blank in offscreen mode
+    EnableFullscreen(config.mFullscreen && !config.mOffscreen);
+    EnableVSync(config.mEnableVSync && !config.mOffscreen);
 
     // init gamepads
     for (int icurr = 0; icurr < eGamepadID_COUNT; ++icurr)
@@ -345,6 +370,16 @@ void GraphicsDevice::Deinit()
     ::glDeleteVertexArrays(1, &mGraphicsContext.mVaoHandle);
     glCheckError();
 
+    mGraphicsContext.InvalidateVertexAttributes();
+    for (bool& isEnabled: mGraphicsContext.mEnabledAttributeArrays)
+    {
+        isEnabled = false;
+    }
+    for (unsigned int& divisor: mGraphicsContext.mAttributeDivisors)
+    {
+        divisor = 0;
+    }
+
     if (mGraphicsWindow) // shutdown glfw system
     {
         ::glfwDestroyWindow(mGraphicsWindow);
@@ -538,18 +573,38 @@ void GraphicsDevice::BindVertexBuffer(GpuBuffer* sourceBuffer, const VertexForma
         debug_assert(sourceBuffer->mContent == eBufferContent_Vertices);
     }
 
-    if (mGraphicsContext.mCurrentBuffers[eBufferContent_Vertices] != sourceBuffer)
+    if (mGraphicsContext.ChangeBuffer(eBufferContent_Vertices, sourceBuffer))
     {
         GLenum bufferTargetGL = EnumToGL(eBufferContent_Vertices);
-        mGraphicsContext.mCurrentBuffers[eBufferContent_Vertices] = sourceBuffer;
         ::glBindBuffer(bufferTargetGL, sourceBuffer ? sourceBuffer->mResourceHandle : 0);
         glCheckError();
     }
+    else
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
+    }
 
-    if (sourceBuffer)
+    if (sourceBuffer == nullptr)
+        return;
+
+    // program attributes which are not provided by vertex format must be disabled
+    GpuProgram* currentProgram = mGraphicsContext.mCurrentProgram;
+    for (int iattribute = 0; iattribute < eVertexAttribute_COUNT; ++iattribute)
+    {
+        if (currentProgram->mAttributes[iattribute] == GpuVariableNULL)
+            continue;
+
+        bool isProvided = (streamDefinition.mAttributes[iattribute].mFormat != eVertexAttributeFormat_Unknown);
+        SetAttributeArrayEnabled(currentProgram->mAttributes[iattribute], isProvided);
+    }
+
+    if (!mGraphicsContext.ChangeVertexAttributes(sourceBuffer, streamDefinition))
     {
-        SetupVertexAttributes(streamDefinition);
+        ++mFrameCounters.mRedundantCallsSkipped;
+        return;
     }
+
+    SetupVertexAttributes(streamDefinition);
 }
 
 void GraphicsDevice::BindIndexBuffer(GpuBuffer* sourceBuffer)
@@ -565,10 +620,12 @@ void GraphicsDevice::BindIndexBuffer(GpuBuffer* sourceBuffer)
         debug_assert(sourceBuffer->mContent == eBufferContent_Indices);
     }
     
-    if (mGraphicsContext.mCurrentBuffers[eBufferContent_Indices] == sourceBuffer)
+    if (!mGraphicsContext.ChangeBuffer(eBufferContent_Indices, sourceBuffer))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
-    mGraphicsContext.mCurrentBuffers[eBufferContent_Indices] = sourceBuffer;
     GLenum bufferTargetGL = EnumToGL(eBufferContent_Indices);
     ::glBindBuffer(bufferTargetGL, sourceBuffer ? sourceBuffer->mResourceHandle : 0);
     glCheckError();
@@ -583,14 +640,18 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuBufferTexture* tex
     }
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
-    if (mGraphicsContext.mCurrentTextures[textureUnit].mBufferTexture == texture)
+    if (!mGraphicsContext.ChangeTexture(textureUnit, texture))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     ActivateTextureUnit(textureUnit);
 
-    mGraphicsContext.mCurrentTextures[textureUnit].mBufferTexture = texture;
     ::glBindTexture(GL_TEXTURE_BUFFER, texture ? texture->mResourceHandle : 0);
     glCheckError();
+
+    ++mFrameCounters.mTextureBinds;
 }
 
 void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTexture2D* texture)
@@ -602,14 +663,18 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTexture2D* texture
     }
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
-    if (mGraphicsContext.mCurrentTextures[textureUnit].mTexture2D == texture)
+    if (!mGraphicsContext.ChangeTexture(textureUnit, texture))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     ActivateTextureUnit(textureUnit);
 
-    mGraphicsContext.mCurrentTextures[textureUnit].mTexture2D = texture;
     ::glBindTexture(GL_TEXTURE_2D, texture ? texture->mResourceHandle : 0);
     glCheckError();
+
+    ++mFrameCounters.mTextureBinds;
 }
 
 void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTextureArray2D* texture)
@@ -621,14 +686,18 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTextureArray2D* te
     }
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
-    if (mGraphicsContext.mCurrentTextures[textureUnit].mTextureArray2D == texture)
+    if (!mGraphicsContext.ChangeTexture(textureUnit, texture))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     ActivateTextureUnit(textureUnit);
 
-    mGraphicsContext.mCurrentTextures[textureUnit].mTextureArray2D = texture;
     ::glBindTexture(GL_TEXTURE_2D_ARRAY, texture ? texture->mResourceHandle : 0);
     glCheckError();
+
+    ++mFrameCounters.mTextureBinds;
 }
 
 void GraphicsDevice::BindRenderProgram(GpuProgram* program)
@@ -639,11 +708,16 @@ void GraphicsDevice::BindRenderProgram(GpuProgram* program)
         return;
     }
 
-    if (mGraphicsContext.mCurrentProgram == program)
+    if (!mGraphicsContext.ChangeProgram(program))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     ::glUseProgram(program ? program->mResourceHandle : 0);
     glCheckError();
+
+    ++mFrameCounters.mProgramBinds;
     if (program)
     {
         bool programAttributes[eVertexAttribute_MAX] = {};
@@ -658,27 +732,16 @@ void GraphicsDevice::BindRenderProgram(GpuProgram* program)
         // setup attribute streams
         for (int ivattribute = 0; ivattribute < eVertexAttribute_COUNT; ++ivattribute)
         {
-            if (programAttributes[ivattribute])
-            {
-                ::glEnableVertexAttribArray(ivattribute);
-                glCheckError();
-            }
-            else
-            {
-                ::glDisableVertexAttribArray(ivattribute);
-                glCheckError();
-            }
+            SetAttributeArrayEnabled(ivattribute, programAttributes[ivattribute]);
         }
     }
     else
     {
         for (int ivattribute = 0; ivattribute < eVertexAttribute_MAX; ++ivattribute)
         {
-            ::glDisableVertexAttribArray(ivattribute);
-            glCheckError();
+            SetAttributeArrayEnabled(ivattribute, false);
         }
     }
-    mGraphicsContext.mCurrentProgram = program;
 }
 
 void GraphicsDevice::DestroyTexture(GpuBufferTexture* textureResource)
@@ -752,6 +815,9 @@ void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesT
     GLenum indicesTypeGL = EnumToGL(indices);
     ::glDrawElements(primitives, numIndices, indicesTypeGL, BUFFER_OFFSET(offset));
     glCheckError();
+
+    ++mFrameCounters.mDrawCalls;
+    mFrameCounters.mIndicesSubmitted += numIndices;
 }
 
 void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesType indices, unsigned int offset, unsigned int numIndices, unsigned int baseVertex)
@@ -770,6 +836,9 @@ void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesT
     GLenum indicesTypeGL = EnumToGL(indices);
     ::glDrawElementsBaseVertex(primitives, numIndices, indicesTypeGL, BUFFER_OFFSET(offset), baseVertex);
     glCheckError();
+
+    ++mFrameCounters.mDrawCalls;
+    mFrameCounters.mIndicesSubmitted += numIndices;
 }
 
 void GraphicsDevice::RenderPrimitives(ePrimitiveType primitiveType, unsigned int firstIndex, unsigned int numElements)
@@ -786,6 +855,28 @@ void GraphicsDevice::RenderPrimitives(ePrimitiveType primitiveType, unsigned int
     GLenum primitives = EnumToGL(primitiveType);
     ::glDrawArrays(primitives, firstIndex, numElements);
     glCheckError();
+
+    ++mFrameCounters.mDrawCalls;
+    mFrameCounters.mVerticesSubmitted += numElements;
+}
+
+void GraphicsDevice::RenderPrimitivesInstanced(ePrimitiveType primitiveType, unsigned int firstIndex, unsigned int numElements, unsigned int numInstances)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return;
+    }
+    GpuBuffer* vertexBuffer = mGraphicsContext.mCurrentBuffers[eBufferContent_Vertices];
+    debug_assert(vertexBuffer && mGraphicsContext.mCurrentProgram);
+    debug_assert(mCaps.mFeatures[eGraphicsFeature_InstancedArrays]);
+
+    GLenum primitives = EnumToGL(primitiveType);
+    ::glDrawArraysInstanced(primitives, firstIndex, numElements, numInstances);
+    glCheckError();
+
+    ++mFrameCounters.mDrawCalls;
+    mFrameCounters.mVerticesSubmitted += numElements * numInstances;
 }
 
 void GraphicsDevice::Present()
@@ -796,6 +887,9 @@ void GraphicsDevice::Present()
         return;
     }
 
+    mLastFrameCounters = mFrameCounters;
+    mFrameCounters.Clear();
+
     ::glfwSwapBuffers(mGraphicsWindow);
     // process window messages
     ::glfwPollEvents();
@@ -807,6 +901,79 @@ void GraphicsDevice::Present()
     ProcessGamepadsInputs();
 }
 
+bool GraphicsDevice::ReadScreenPixels(const Rect& sourceRectangle, std::vector<unsigned char>& outputPixels)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return false;
+    }
+
+    if (sourceRectangle.w <= 0 || sourceRectangle.h <= 0)
+        return false;
+
+    outputPixels.resize(sourceRectangle.w * sourceRectangle.h * 4);
+
+    ::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glCheckError();
+
+    ::glReadPixels(sourceRectangle.x, sourceRectangle.y, sourceRectangle.w, sourceRectangle.h, GL_RGBA, GL_UNSIGNED_BYTE, outputPixels.data());
+    glCheckError();
+    return true;
+}
+
+GpuQueryHandle GraphicsDevice::CreateTimestampQuery()
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return 0;
+    }
+
+    if (!mCaps.mFeatures[eGraphicsFeature_TimerQuery])
+        return 0;
+
+    GpuQueryHandle queryHandle = 0;
+    ::glGenQueries(1, &queryHandle);
+    glCheckError();
+    return queryHandle;
+}
+
+void GraphicsDevice::DestroyTimestampQuery(GpuQueryHandle queryHandle)
+{
+    if (queryHandle == 0)
+        return;
+
+    ::glDeleteQueries(1, &queryHandle);
+    glCheckError();
+}
+
+void GraphicsDevice::IssueTimestampQuery(GpuQueryHandle queryHandle)
+{
+    debug_assert(queryHandle);
+
+    ::glQueryCounter(queryHandle, GL_TIMESTAMP);
+    glCheckError();
+}
+
+bool GraphicsDevice::GetTimestampQueryResult(GpuQueryHandle queryHandle, unsigned long long& timestamp)
+{
+    debug_assert(queryHandle);
+
+    GLint resultAvailable = GL_FALSE;
+    ::glGetQueryObjectiv(queryHandle, GL_QUERY_RESULT_AVAILABLE, &resultAvailable);
+    glCheckError();
+    if (resultAvailable == GL_FALSE)
+        return false;
+
+    GLuint64 resultValue = 0;
+    ::glGetQueryObjectui64v(queryHandle, GL_QUERY_RESULT, &resultValue);
+    glCheckError();
+
+    timestamp = resultValue;
+    return true;
+}
+
 void GraphicsDevice::ProcessGamepadsInputs()
 {
     GLFWgamepadstate gamepadstate;
@@ -860,7 +1027,10 @@ void GraphicsDevice::SetViewportRect(const Rect& sourceRectangle)
     }
 
     if (mViewportRect == sourceRectangle)
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     mViewportRect = sourceRectangle;
     ::glViewport(mViewportRect.x, mViewportRect.y, mViewportRect.w, mViewportRect.h);
@@ -876,7 +1046,10 @@ void GraphicsDevice::SetScissorRect(const Rect& sourceRectangle)
     }
 
     if (mScissorBox == sourceRectangle)
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
     mScissorBox = sourceRectangle;
     ::glScissor(mScissorBox.x, mScissorBox.y, mScissorBox.w, mScissorBox.h);
@@ -970,7 +1143,7 @@ void GraphicsDevice::SetupVertexAttributes(const VertexFormat& streamDefinition)
         const auto& attribute = streamDefinition.mAttributes[iattribute];
         if (attribute.mFormat == eVertexAttributeFormat_Unknown)
         {
-            debug_assert(false);
+            // current vertex attribute is not provided, its array is disabled
             continue;
         }
 
@@ -997,13 +1170,28 @@ void GraphicsDevice::SetupVertexAttributes(const VertexFormat& streamDefinition)
                 streamDefinition.mDataStride, BUFFER_OFFSET(attribute.mDataOffset + streamDefinition.mBaseOffset));
             glCheckError();
         }
+
+        // set instancing divisor
+        GpuVariableLocation attributeLocation = currentProgram->mAttributes[iattribute];
+        if (mGraphicsContext.ChangeAttributeDivisor(attributeLocation, streamDefinition.mInstanceDivisor))
+        {
+            debug_assert(mCaps.mFeatures[eGraphicsFeature_InstancedArrays]);
+
+            ::glVertexAttribDivisorARB(attributeLocation, streamDefinition.mInstanceDivisor);
+            glCheckError();
+        }
     }
 }
 
 void GraphicsDevice::InternalSetRenderStates(const RenderStates& renderStates, bool forceState)
 {
     if (mCurrentStates == renderStates && !forceState)
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
+
+    ++mFrameCounters.mRenderStateChanges;
 
     // polygon mode
     if (forceState || (mCurrentStates.mFillMode != renderStates.mFillMode))
@@ -1156,6 +1344,8 @@ void GraphicsDevice::QueryGraphicsDeviceCaps()
 {
     mCaps.mFeatures[eGraphicsFeature_NPOT_Textures] = (GLEW_ARB_texture_non_power_of_two == GL_TRUE);
     mCaps.mFeatures[eGraphicsFeature_ABGR] = (GLEW_EXT_abgr == GL_TRUE);
+    mCaps.mFeatures[eGraphicsFeature_TimerQuery] = (GLEW_ARB_timer_query == GL_TRUE);
+    mCaps.mFeatures[eGraphicsFeature_InstancedArrays] = (GLEW_ARB_instanced_arrays == GL_TRUE);
 
     ::glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &mCaps.mMaxTextureBufferSize);
     glCheckError();
@@ -1168,12 +1358,30 @@ void GraphicsDevice::QueryGraphicsDeviceCaps()
     gConsole.LogMessage(eLogMessage_Info, " - max texture buffer size: %d bytes", mCaps.mMaxTextureBufferSize);
 }
 
-void GraphicsDevice::ActivateTextureUnit(eTextureUnit textureUnit)
+void GraphicsDevice::SetAttributeArrayEnabled(int attributeIndex, bool isEnabled)
 {
-    if (mGraphicsContext.mCurrentTextureUnit == textureUnit)
+    debug_assert(attributeIndex < eVertexAttribute_MAX);
+    if (!mGraphicsContext.ChangeAttributeArrayEnabled(attributeIndex, isEnabled))
+    {
+        ++mFrameCounters.mRedundantCallsSkipped;
         return;
+    }
 
-    mGraphicsContext.mCurrentTextureUnit = textureUnit;
+    if (isEnabled)
+    {
+        ::glEnableVertexAttribArray(attributeIndex);
+    }
+    else
+    {
+        ::glDisableVertexAttribArray(attributeIndex);
+    }
+    glCheckError();
+}
+
+void GraphicsDevice::ActivateTextureUnit(eTextureUnit textureUnit)
+{
+    if (!mGraphicsContext.ChangeTextureUnit(textureUnit))
+        return;
 
     ::glActiveTexture(GL_TEXTURE0 + textureUnit);
     glCheckError();
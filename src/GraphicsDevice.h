@@ -21,6 +21,10 @@ public:
     // current screen params
     Point mScreenResolution;
 
+    // work counters
+    RenderCounters mFrameCounters; // current frame, reset on present
+    RenderCounters mLastFrameCounters;
+
 public:
     GraphicsDevice();
     ~GraphicsDevice();
@@ -131,6 +135,14 @@ public:
     // @param numElements: Number of elements to render
     void RenderPrimitives(ePrimitiveType primitiveType, unsigned int firstIndex, unsigned int numElements);
 
+    // Render multiple instances of geometry, requires eGraphicsFeature_InstancedArrays
+    // Per instance attributes are specified with vertex format instance divisor
+    // @param primitiveType: Type of primitives to render
+    // @param firstIndex: Start position in per vertex attribute buffers, index
+    // @param numElements: Number of elements to render per instance
+    // @param numInstances: Number of instances
+    void RenderPrimitivesInstanced(ePrimitiveType primitiveType, unsigned int firstIndex, unsigned int numElements, unsigned int numInstances);
+
     // Finish render frame, prenent on screen
     void Present();
 
@@ -149,6 +161,29 @@ public:
     // Clear color and depth of current framebuffer
     void ClearScreen();
 
+    // Read back pixels of current frame, must be called before present
+    // @param sourceRectangle: Screen area, origin is bottom left corner
+    // @param outputPixels: Output RGBA8 pixels, rows are ordered from bottom to top
+    bool ReadScreenPixels(const Rect& sourceRectangle, std::vector<unsigned char>& outputPixels);
+
+    // Create gpu timestamp query, requires eGraphicsFeature_TimerQuery
+    // @returns 0 if timer queries are not supported
+    GpuQueryHandle CreateTimestampQuery();
+
+    // Free gpu query
+    // @param queryHandle: Target query, handle becomes invalid
+    void DestroyTimestampQuery(GpuQueryHandle queryHandle);
+
+    // Record gpu time when all previously submitted commands are completed
+    // @param queryHandle: Target query
+    void IssueTimestampQuery(GpuQueryHandle queryHandle);
+
+    // Get recorded gpu time without waiting
+    // @param queryHandle: Target query
+    // @param timestamp: Output time in nanoseconds
+    // @returns false if result is not available yet
+    bool GetTimestampQueryResult(GpuQueryHandle queryHandle, unsigned long long& timestamp);
+
     // Test whether graphics is initialized properly
     bool IsDeviceInited() const;
     
@@ -159,6 +194,7 @@ private:
     bool InitializeOGLExtensions();
     void QueryGraphicsDeviceCaps();
     void ActivateTextureUnit(eTextureUnit textureUnit);
+    void SetAttributeArrayEnabled(int attributeIndex, bool isEnabled);
 
     void SetupVertexAttributes(const VertexFormat& streamDefinition);
 
@@ -24,6 +24,31 @@ HUDPanel::~HUDPanel()
 }
 
 void HUDPanel::DrawFrame(GuiContext& guiContext)
+{
+    if (mGeometryInvalid || (mCachedPanelPosition != mPanelPosition) || (mCachedPanelSize != mPanelSize))
+    {
+        mCachedSprites.clear();
+        BuildGeometry(mCachedSprites);
+
+        mCachedPanelPosition = mPanelPosition;
+        mCachedPanelSize = mPanelSize;
+        mGeometryInvalid = false;
+
+        gGraphicsDevice.mFrameCounters.mHudQuadsRebuilt += (int) mCachedSprites.size();
+    }
+
+    for (const Sprite2D& currSprite: mCachedSprites)
+    {
+        guiContext.mSpriteBatch.DrawSprite(currSprite);
+    }
+}
+
+void HUDPanel::InvalidateGeometry()
+{
+    mGeometryInvalid = true;
+}
+
+void HUDPanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
     // do nothing
 }
@@ -72,9 +97,13 @@ void HUDWeaponPanel::SetupHUD()
 
     mAmmunitionFont = gFontManager.GetFont("SUB1.FON");
     debug_assert(mAmmunitionFont);
+
+    mFontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
+    mPrevSpriteIndex = -1;
+    InvalidateGeometry();
 }
 
-void HUDWeaponPanel::DrawFrame(GuiContext& guiContext)
+void HUDWeaponPanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
     if (mWeaponIcon.IsNull())
         return;
@@ -82,7 +111,7 @@ void HUDWeaponPanel::DrawFrame(GuiContext& guiContext)
     mWeaponIcon.mPosition.x = mPanelPosition.x * 1.0f;
     mWeaponIcon.mPosition.y = mPanelPosition.y * 1.0f;
 
-    guiContext.mSpriteBatch.DrawSprite(mWeaponIcon);
+    panelSprites.push_back(mWeaponIcon);
 
     if (mAmmunitionFont)
     {
@@ -94,8 +123,7 @@ void HUDWeaponPanel::DrawFrame(GuiContext& guiContext)
             (mPanelPosition.x + mPanelSize.x) - textDims.x,
             (mPanelPosition.y + mPanelSize.y) - textDims.y + 4,
         };
-        int fontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
-        mAmmunitionFont->DrawString(guiContext, mAmmunitionText, textPos, mPanelSize, fontPaletteIndex);
+        mAmmunitionFont->LayoutString(mAmmunitionText, textPos, mFontPaletteIndex, panelSprites);
     }
 }
 
@@ -111,12 +139,17 @@ void HUDWeaponPanel::SetWeaponInfo(Weapon& weaponState)
     {
         mPrevAmmunitionCount = weaponState.mAmmunition;
         mAmmunitionText = cxx::va("%d", weaponState.mAmmunition);
+        InvalidateGeometry();
     }
 
     WeaponInfo* weaponInfo = weaponState.GetWeaponInfo();
     int spriteIndex = gGameMap.mStyleData.GetSpriteIndex(eSpriteType_Arrow, weaponInfo->mSpriteIndex);
-
-    gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, spriteIndex, 0, mWeaponIcon);
+    if (mPrevSpriteIndex != spriteIndex)
+    {
+        mPrevSpriteIndex = spriteIndex;
+        gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, spriteIndex, 0, mWeaponIcon);
+        InvalidateGeometry();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -129,14 +162,16 @@ void HUDBigFontMessage::SetupHUD()
 {
     mMessageFont = gFontManager.GetFont("BIG2.FON");
     debug_assert(mMessageFont);
+
+    mFontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
+    InvalidateGeometry();
 }
 
-void HUDBigFontMessage::DrawFrame(GuiContext& guiContext)
+void HUDBigFontMessage::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {   
     if (mMessageFont)
     {
-        int fontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
-        mMessageFont->DrawString(guiContext, mMessageText, mPanelPosition, mPanelSize, fontPaletteIndex);
+        mMessageFont->LayoutString(mMessageText, mPanelPosition, mFontPaletteIndex, panelSprites);
     }
 }
 
@@ -148,9 +183,13 @@ void HUDBigFontMessage::UpdatePanelSize(const Point& maxSize)
     }
 }
 
-void HUDBigFontMessage::SetMessageText(const std::string& messageText)
+void HUDBigFontMessage::SetMessageText(const char* messageText)
 {
-    mMessageText = messageText;
+    if (mMessageText != messageText)
+    {
+        mMessageText = messageText;
+        InvalidateGeometry();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -159,9 +198,13 @@ HUDCarNamePanel::HUDCarNamePanel()
 {
 }
 
-void HUDCarNamePanel::SetMessageText(const std::string& messageText)
+void HUDCarNamePanel::SetMessageText(const char* messageText)
 {
-    mMessageText = messageText;
+    if (mMessageText != messageText)
+    {
+        mMessageText = messageText;
+        InvalidateGeometry();
+    }
 }
 
 void HUDCarNamePanel::SetupHUD()
@@ -175,14 +218,17 @@ void HUDCarNamePanel::SetupHUD()
     mBackgroundSprite.mHeight = 0.0f;
     mBackgroundSprite.mScale = HUD_SPRITE_SCALE;
     mBackgroundSprite.mOriginMode = eSpriteOrigin_TopLeft;
+
+    mFontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
+    InvalidateGeometry();
 }
 
-void HUDCarNamePanel::DrawFrame(GuiContext& guiContext)
+void HUDCarNamePanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
     mBackgroundSprite.mPosition.x = mPanelPosition.x * 1.0f;
     mBackgroundSprite.mPosition.y = mPanelPosition.y * 1.0f;
 
-    guiContext.mSpriteBatch.DrawSprite(mBackgroundSprite);
+    panelSprites.push_back(mBackgroundSprite);
     if (mMessageFont)
     {
         Point textDims;
@@ -192,8 +238,7 @@ void HUDCarNamePanel::DrawFrame(GuiContext& guiContext)
         textPosition.x = mPanelPosition.x + (mPanelSize.x / 2) - (textDims.x / 2);
         textPosition.y = mPanelPosition.y + (mPanelSize.y / 2) - (textDims.y / 2);
 
-        int fontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
-        mMessageFont->DrawString(guiContext, mMessageText, textPosition, fontPaletteIndex);
+        mMessageFont->LayoutString(mMessageText, textPosition, mFontPaletteIndex, panelSprites);
     }
 }
 
@@ -209,9 +254,13 @@ HUDDistrictNamePanel::HUDDistrictNamePanel()
 {
 }
 
-void HUDDistrictNamePanel::SetMessageText(const std::string& messageText)
+void HUDDistrictNamePanel::SetMessageText(const char* messageText)
 {
-    mMessageText = messageText;
+    if (mMessageText != messageText)
+    {
+        mMessageText = messageText;
+        InvalidateGeometry();
+    }
 }
 
 void HUDDistrictNamePanel::SetupHUD()
@@ -230,17 +279,20 @@ void HUDDistrictNamePanel::SetupHUD()
     mBackgroundSpriteRightPart.mHeight = 0.0f;
     mBackgroundSpriteRightPart.mScale = HUD_SPRITE_SCALE;
     mBackgroundSpriteRightPart.mOriginMode = eSpriteOrigin_TopLeft;
+
+    mFontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
+    InvalidateGeometry();
 }
 
-void HUDDistrictNamePanel::DrawFrame(GuiContext& guiContext)
+void HUDDistrictNamePanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
     mBackgroundSpriteLeftPart.mPosition.x = (mPanelPosition.x * 1.0f);
     mBackgroundSpriteLeftPart.mPosition.y = (mPanelPosition.y * 1.0f);
-    guiContext.mSpriteBatch.DrawSprite(mBackgroundSpriteLeftPart);
+    panelSprites.push_back(mBackgroundSpriteLeftPart);
 
     mBackgroundSpriteRightPart.mPosition.x = (mPanelPosition.x * 1.0f) + mBackgroundSpriteLeftPart.mTextureRegion.mRectangle.w;
     mBackgroundSpriteRightPart.mPosition.y = (mPanelPosition.y * 1.0f);
-    guiContext.mSpriteBatch.DrawSprite(mBackgroundSpriteRightPart);
+    panelSprites.push_back(mBackgroundSpriteRightPart);
 
     if (mMessageFont)
     {
@@ -251,8 +303,7 @@ void HUDDistrictNamePanel::DrawFrame(GuiContext& guiContext)
         textPosition.x = mPanelPosition.x + (mPanelSize.x / 2) - (textDims.x / 2);
         textPosition.y = mPanelPosition.y + (mPanelSize.y / 2) - (textDims.y / 2);
 
-        int fontPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
-        mMessageFont->DrawString(guiContext, mMessageText, textPosition, fontPaletteIndex);
+        mMessageFont->LayoutString(mMessageText, textPosition, mFontPaletteIndex, panelSprites);
     }
 }
 
@@ -272,7 +323,11 @@ HUDWantedLevelPanel::HUDWantedLevelPanel()
 void HUDWantedLevelPanel::SetWantedLevel(int wantedLevel)
 {
     debug_assert(mCopSpritesCount <= GAME_MAX_WANTED_LEVEL);
-    mCopSpritesCount = wantedLevel;
+    if (mCopSpritesCount != wantedLevel)
+    {
+        mCopSpritesCount = wantedLevel;
+        InvalidateGeometry();
+    }
 }
 
 void HUDWantedLevelPanel::SetupHUD()
@@ -294,16 +349,17 @@ void HUDWantedLevelPanel::SetupHUD()
         // initial sprite
         gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, eSpriteID_Arrow_WantedFrame1, 0, currCopSprite);
     }
+    InvalidateGeometry();
 }
 
-void HUDWantedLevelPanel::DrawFrame(GuiContext& guiContext)
+void HUDWantedLevelPanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
     for (int icurr = 0; icurr < mCopSpritesCount; ++icurr)
     {
         Sprite2D& currSprite = mCopSprites[icurr];
         currSprite.mPosition.x = (mPanelPosition.x * 1.0f) + icurr * currSprite.mTextureRegion.mRectangle.w;
         currSprite.mPosition.y = (mPanelPosition.y * 1.0f);
-        guiContext.mSpriteBatch.DrawSprite(currSprite);
+        panelSprites.push_back(currSprite);
     }
 }
 
@@ -316,6 +372,7 @@ void HUDWantedLevelPanel::UpdateFrame()
         if (currCopSprite.mAnimationState.UpdateFrame(gTimeManager.mUiFrameDelta))
         {
             gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, currCopSprite.mAnimationState.GetSpriteIndex(), 0, currCopSprite);
+            InvalidateGeometry();
         }
     }
 }
@@ -339,18 +396,21 @@ void HUDScoresPanel::SetScores(int score, int lives, int multiplier)
     {
         mPrevScore = score;
         mScoreText = cxx::va("%d", score);
+        InvalidateGeometry();
     }
 
     if (lives != mPrevLives)
     {
         mPrevLives = lives;
         mLivesText = cxx::va(":%d", lives);
+        InvalidateGeometry();
     }
 
     if (multiplier != mPrevMultiplier)
     {
         mPrevMultiplier = multiplier;
         mMultiplierText = cxx::va(":%d", multiplier);
+        InvalidateGeometry();
     }
 }
 
@@ -376,28 +436,30 @@ void HUDScoresPanel::SetupHUD()
     {
         mFontMultiplier->SetFontBaseCharCode('0');
     }
+
+    mStandardPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
+    mLivesPaletteIndex = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Green);
+    InvalidateGeometry();
 }
 
-void HUDScoresPanel::DrawFrame(GuiContext& guiContext)
+void HUDScoresPanel::BuildGeometry(std::vector<Sprite2D>& panelSprites)
 {
-    int standardPalette = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Default);
-    int livesPalette = gGameMap.mStyleData.GetFontPaletteIndex(FontRemap_Green);
     if (mFontScore)
     {
         Point pos {mPanelPosition.x + mColumnCountersDims.x, mPanelPosition.y};
-        mFontScore->DrawString(guiContext, mScoreText, pos, standardPalette);
+        mFontScore->LayoutString(mScoreText, pos, mStandardPaletteIndex, panelSprites);
     }
     int yoffset = 0;
     if (mFontLives)
     {
         Point pos {mPanelPosition.x, mPanelPosition.y};
-        mFontLives->DrawString(guiContext, mLivesText, pos, livesPalette);
+        mFontLives->LayoutString(mLivesText, pos, mLivesPaletteIndex, panelSprites);
         yoffset = mFontLives->GetLineHeight();
     }
     if (mFontMultiplier)
     {
         Point pos {mPanelPosition.x, mPanelPosition.y + yoffset};
-        mFontMultiplier->DrawString(guiContext, mMultiplierText, pos, standardPalette);
+        mFontMultiplier->LayoutString(mMultiplierText, pos, mStandardPaletteIndex, panelSprites);
     }
 }
 
@@ -633,24 +695,24 @@ void HUD::ArrangePanelsVert(const Rect& bounds, eHUDPanelAlign panelsAlign, int
 void HUD::ShowBigFontMessage(eHUDBigFontMessage messageType)
 {
     // todo: move this elsewhere
-    static const std::string messageIDs[] =
-    {
-        "2500", // MissionComplete
-        "2501", // MissionFailed
-        "2503", // KillFrenzy
-        "2504", // FrenzyFailed
-        "2505", // ExtraLifeBonus
-        "8787", // Gouranga
-        "4000", // YouGotIt
-        "4001", // FrenzyPassed
-        "4002", // BonusLost
-        "4003", // Busted
-        "4004", // Wasted
-        "4005", // GoGoGo
+    static constexpr GameTextID messageIDs[] =
+    {
+        MakeGameTextID("2500"), // MissionComplete
+        MakeGameTextID("2501"), // MissionFailed
+        MakeGameTextID("2503"), // KillFrenzy
+        MakeGameTextID("2504"), // FrenzyFailed
+        MakeGameTextID("2505"), // ExtraLifeBonus
+        MakeGameTextID("8787"), // Gouranga
+        MakeGameTextID("4000"), // YouGotIt
+        MakeGameTextID("4001"), // FrenzyPassed
+        MakeGameTextID("4002"), // BonusLost
+        MakeGameTextID("4003"), // Busted
+        MakeGameTextID("4004"), // Wasted
+        MakeGameTextID("4005"), // GoGoGo
     };
     if (messageType < CountOf(messageIDs))
     {
-        const std::string& messageText = gGameTexts.GetText(messageIDs[messageType]);
+        const char* messageText = gGameTexts.GetText(messageIDs[messageType]);
         mBigFontMessage.SetMessageText(messageText);
         ShowAutoHidePanel(&mBigFontMessage, gGameParams.mHudBigFontMessageShowDuration);
     }
@@ -664,9 +726,7 @@ void HUD::ShowCarNameMessage(eVehicleModel carModel)
 {
     debug_assert(carModel < eVehicle_COUNT);
 
-    std::string textID = cxx::va("car%d", carModel);
-
-    const std::string& messageText = gGameTexts.GetText(textID);
+    const char* messageText = gGameTexts.GetText(cxx::va("car%d", carModel));
     mCarNamePanel.SetMessageText(messageText);
     ShowAutoHidePanel(&mCarNamePanel, gGameParams.mHudCarNameShowDuration);
 }
@@ -675,8 +735,7 @@ void HUD::ShowDistrictNameMessage(int districtIndex)
 {
     debug_assert(districtIndex >= 0);
 
-    std::string textID = cxx::va("%03darea%03d", gGameMap.mStyleFileNumber, districtIndex);
-    const std::string& messageText = gGameTexts.GetText(textID);
+    const char* messageText = gGameTexts.GetText(cxx::va("%03darea%03d", gGameMap.mStyleFileNumber, districtIndex));
     mDistrictNamePanel.SetMessageText(messageText);
     ShowAutoHidePanel(&mDistrictNamePanel, gGameParams.mHudDistrictNameShowDuration);
 }
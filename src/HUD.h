@@ -18,9 +18,12 @@ public:
     virtual ~HUDPanel();
     // overridable methods
     virtual void SetupHUD();
-    virtual void DrawFrame(GuiContext& guiContext);
     virtual void UpdateFrame();
     virtual void UpdatePanelSize(const Point& maxSize);
+    // Draw cached panel sprites, they get rebuilt if content, position or size changed since last draw
+    void DrawFrame(GuiContext& guiContext);
+    // Force rebuild panel sprites on next draw
+    void InvalidateGeometry();
     // Set top left corner position on screen
     void SetPanelPosition(const Point& tlcornerPosition)
     {
@@ -30,8 +33,17 @@ public:
     void ShowPanel();
     void HidePanel();
     bool IsPanelVisible() const;
+protected:
+    // Generate panel sprites, invoked only when cached geometry is outdated
+    // @param panelSprites: Output sprites
+    virtual void BuildGeometry(std::vector<Sprite2D>& panelSprites);
 protected:
     bool mIsPanelVisible = true; // whether the panel should draw and update
+private:
+    std::vector<Sprite2D> mCachedSprites;
+    Point mCachedPanelPosition;
+    Point mCachedPanelSize;
+    bool mGeometryInvalid = true;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -44,12 +56,15 @@ public:
     void SetWeaponInfo(Weapon& weaponState);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdatePanelSize(const Point& maxSize) override;
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     Sprite2D mWeaponIcon;
     Font* mAmmunitionFont = nullptr;
+    int mFontPaletteIndex = 0;
     int mPrevAmmunitionCount = 0;
+    int mPrevSpriteIndex = -1;
     std::string mAmmunitionText; // cached message text
 };
 
@@ -59,13 +74,15 @@ class HUDBigFontMessage: public HUDPanel
 {
 public:
     HUDBigFontMessage();
-    void SetMessageText(const std::string& messageText);
+    void SetMessageText(const char* messageText);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdatePanelSize(const Point& maxSize) override; 
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     Font* mMessageFont = nullptr;
+    int mFontPaletteIndex = 0;
     std::string mMessageText; // cached message text
 };
 
@@ -75,14 +92,15 @@ class HUDCarNamePanel: public HUDPanel
 {
 public:
     HUDCarNamePanel();
-    void SetMessageText(const std::string& messageText);
+    void SetMessageText(const char* messageText);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdatePanelSize(const Point& maxSize) override; 
-
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     Font* mMessageFont = nullptr;
+    int mFontPaletteIndex = 0;
     Sprite2D mBackgroundSprite;
     std::string mMessageText; // cached message text
 };
@@ -93,14 +111,15 @@ class HUDDistrictNamePanel: public HUDPanel
 {
 public:
     HUDDistrictNamePanel();
-    void SetMessageText(const std::string& messageText);
+    void SetMessageText(const char* messageText);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdatePanelSize(const Point& maxSize) override; 
-
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     Font* mMessageFont = nullptr;
+    int mFontPaletteIndex = 0;
     Sprite2D mBackgroundSpriteLeftPart;
     Sprite2D mBackgroundSpriteRightPart;
     std::string mMessageText; // cached message text
@@ -115,9 +134,10 @@ public:
     void SetWantedLevel(int level);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdateFrame() override;
     void UpdatePanelSize(const Point& maxSize) override;
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     struct CopSprite: public Sprite2D
     {
@@ -136,13 +156,16 @@ public:
     void SetScores(int score, int lives, int multiplier);
     // override HUDPanel methods
     void SetupHUD() override;
-    void DrawFrame(GuiContext& guiContext) override;
     void UpdateFrame() override;
     void UpdatePanelSize(const Point& maxSize) override;
+protected:
+    void BuildGeometry(std::vector<Sprite2D>& panelSprites) override;
 private:
     Font* mFontScore = nullptr;
     Font* mFontLives = nullptr;
     Font* mFontMultiplier = nullptr;
+    int mStandardPaletteIndex = 0;
+    int mLivesPaletteIndex = 0;
     Point mColumnCountersDims;
     // cache score values
     int mPrevScore = 0;
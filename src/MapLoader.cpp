@@ -0,0 +1,209 @@
+#include "stdafx.h"
+#include "MapLoader.h"
+#include "GameMapManager.h"
+#include "SpriteManager.h"
+#include "PhysicsManager.h"
+#include "AudioManager.h"
+
+// stages that must be completed before specified one could start
+static const unsigned int MapLoadStageDependencies[eMapLoadStage_COUNT] =
+{
+    0, // eMapLoadStage_MapData
+    (1 << eMapLoadStage_MapData), // eMapLoadStage_LevelSounds
+    (1 << eMapLoadStage_MapData), // eMapLoadStage_CityMesh
+    (1 << eMapLoadStage_MapData), // eMapLoadStage_Spritesheet
+    (1 << eMapLoadStage_MapData), // eMapLoadStage_BlocksTexture
+    (1 << eMapLoadStage_MapData), // eMapLoadStage_Collision
+};
+
+MapLoader::MapLoader()
+    : mLoaderState(eLoaderState_Idle)
+    , mCancelRequest(false)
+{
+}
+
+MapLoader::~MapLoader()
+{
+    Cleanup();
+}
+
+bool MapLoader::LoadMap(const std::string& mapName)
+{
+    Cleanup();
+
+    mMapName = mapName;
+    mLoaderState = eLoaderState_Loading;
+
+    bool isSuccess = LoadMapData();
+    mLoaderState = isSuccess ? eLoaderState_Loaded : eLoaderState_Failed;
+    return isSuccess;
+}
+
+void MapLoader::StartLoadingMap(const std::string& mapName)
+{
+    Cleanup();
+
+    mMapName = mapName;
+    mLoaderState = eLoaderState_Loading;
+    mWorkerThread = std::thread(&MapLoader::WorkerThreadProc, this);
+}
+
+void MapLoader::Cleanup()
+{
+    if (mWorkerThread.joinable())
+    {
+        mCancelRequest = true;
+        mWorkerThread.join();
+        mCancelRequest = false;
+    }
+
+    SafeDelete(mGameMap);
+
+    mMapMesh = MapMeshData();
+    mBlocksPixels.Cleanup();
+    mSpritesheetPixels.Cleanup();
+    mSpritesheetEntries.clear();
+    mMapCollisionBlocks.clear();
+    mLevelSounds.FreeArchive();
+    mVoiceSounds.FreeArchive();
+    mMapName.clear();
+
+    mLoaderState = eLoaderState_Idle;
+}
+
+bool MapLoader::LoadMapData()
+{
+    if (mGameMap == nullptr)
+    {
+        mGameMap = new GameMapManager;
+    }
+
+    for (float& currStageTime: mStageTime)
+    {
+        currStageTime = 0.0f;
+    }
+    mLoadTime = 0.0f;
+
+    const unsigned int AllStagesMask = (1 << eMapLoadStage_COUNT) - 1;
+
+    double loadStartTime = gSystem.GetSystemSeconds();
+    // run stages in waves, each wave contains all stages which dependencies are completed
+    unsigned int completedStages = 0;
+    while (completedStages != AllStagesMask)
+    {
+        if (mCancelRequest)
+        {
+            gConsole.LogMessage(eLogMessage_Info, "Loading map '%s' cancelled", mMapName.c_str());
+            return false;
+        }
+
+        eMapLoadStage readyStages[eMapLoadStage_COUNT];
+        int readyStagesCount = 0;
+        for (int istage = 0; istage < eMapLoadStage_COUNT; ++istage)
+        {
+            unsigned int dependencies = MapLoadStageDependencies[istage];
+            if ((completedStages & (1 << istage)) == 0 && (completedStages & dependencies) == dependencies)
+            {
+                readyStages[readyStagesCount++] = (eMapLoadStage) istage;
+            }
+        }
+
+        debug_assert(readyStagesCount > 0);
+        if (readyStagesCount == 0)
+            return false;
+
+        bool stageResults[eMapLoadStage_COUNT] = {};
+        if (mParallelStages && readyStagesCount > 1)
+        {
+            // first stage is executed on current thread
+            std::thread stageThreads[eMapLoadStage_COUNT];
+            for (int iready = 1; iready < readyStagesCount; ++iready)
+            {
+                eMapLoadStage loadStage = readyStages[iready];
+                stageThreads[iready] = std::thread([this, loadStage, &stageResults]()
+                    {
+                        stageResults[loadStage] = ExecuteStage(loadStage);
+                    });
+            }
+            stageResults[readyStages[0]] = ExecuteStage(readyStages[0]);
+            for (int iready = 1; iready < readyStagesCount; ++iready)
+            {
+                stageThreads[iready].join();
+            }
+        }
+        else
+        {
+            for (int iready = 0; iready < readyStagesCount; ++iready)
+            {
+                stageResults[readyStages[iready]] = ExecuteStage(readyStages[iready]);
+            }
+        }
+
+        for (int iready = 0; iready < readyStagesCount; ++iready)
+        {
+            if (!stageResults[readyStages[iready]])
+                return false;
+
+            completedStages |= (1 << readyStages[iready]);
+        }
+    }
+    mLoadTime = (float) (gSystem.GetSystemSeconds() - loadStartTime);
+
+    float stagesTime = 0.0f;
+    for (int istage = 0; istage < eMapLoadStage_COUNT; ++istage)
+    {
+        gConsole.LogMessage(eLogMessage_Info, "Map load stage '%s': %.3f s", cxx::enum_to_string((eMapLoadStage) istage), mStageTime[istage]);
+        stagesTime += mStageTime[istage];
+    }
+    gConsole.LogMessage(eLogMessage_Info, "Map '%s' prepared in %.3f s (stages total %.3f s, %s)", mMapName.c_str(), mLoadTime, stagesTime, 
+        mParallelStages ? "parallel" : "serial");
+    return true;
+}
+
+bool MapLoader::ExecuteStage(eMapLoadStage loadStage)
+{
+    bool isSuccess = true;
+
+    double stageStartTime = gSystem.GetSystemSeconds();
+    switch (loadStage)
+    {
+        case eMapLoadStage_MapData:
+            if (!mGameMap->LoadFromFile(mMapName))
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Cannot load map '%s'", mMapName.c_str());
+                isSuccess = false;
+            }
+        break;
+        case eMapLoadStage_LevelSounds:
+            AudioManager::PrepareLevelSounds(mGameMap->mAudioFileNumber, mLevelSounds, mVoiceSounds);
+        break;
+        case eMapLoadStage_CityMesh:
+            MapRenderer::PrepareMapMesh(*mGameMap, mMapMesh);
+        break;
+        case eMapLoadStage_Spritesheet:
+            if (!SpriteManager::PrepareObjectsSpritesheet(mGameMap->mStyleData, mSpritesheetPixels, mSpritesheetEntries))
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Cannot build objects spritesheet");
+                isSuccess = false;
+            }
+        break;
+        case eMapLoadStage_BlocksTexture:
+            if (!SpriteManager::PrepareBlocksTexture(mGameMap->mStyleData, mBlocksPixels))
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Cannot build blocks texture");
+                isSuccess = false;
+            }
+        break;
+        case eMapLoadStage_Collision:
+            PhysicsManager::PrepareMapCollisionBlocks(*mGameMap, mMapCollisionBlocks);
+        break;
+    }
+    mStageTime[loadStage] = (float) (gSystem.GetSystemSeconds() - stageStartTime);
+    return isSuccess;
+}
+
+void MapLoader::WorkerThreadProc()
+{
+    bool isSuccess = LoadMapData();
+    mLoaderState = isSuccess ? eLoaderState_Loaded : eLoaderState_Failed;
+}
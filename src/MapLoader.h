@@ -0,0 +1,87 @@
+#pragma once
+
+#include "MapRenderer.h"
+#include "SfxArchive.h"
+
+class GameMapManager;
+
+// map loading stages which does not require gpu, audio device or physics world
+// stages that depend on decoded map data only are executed concurrently
+enum eMapLoadStage
+{
+    eMapLoadStage_MapData, // cmp and style files
+    eMapLoadStage_LevelSounds, // sound archives indexing
+    eMapLoadStage_CityMesh,
+    eMapLoadStage_Spritesheet,
+    eMapLoadStage_BlocksTexture,
+    eMapLoadStage_Collision,
+    eMapLoadStage_COUNT
+};
+
+decl_enum_strings(eMapLoadStage);
+
+// Loads map data into staging instance and prepares level resources on cpu
+// Loading could be performed on worker thread, so main thread only creates gpu and physics objects when data is ready
+class MapLoader final: public cxx::noncopyable
+{
+public:
+    // readonly
+    std::string mMapName;
+    GameMapManager* mGameMap = nullptr; // staging map data, gets swapped with current map on scenario start
+
+    MapMeshData mMapMesh;
+    PixelsArray mBlocksPixels;
+    PixelsArray mSpritesheetPixels;
+    std::vector<TextureRegion> mSpritesheetEntries;
+    std::vector<Point> mMapCollisionBlocks;
+    SfxArchive mLevelSounds;
+    SfxArchive mVoiceSounds;
+
+    float mStageTime[eMapLoadStage_COUNT] = {}; // seconds
+    float mLoadTime = 0.0f; // seconds, wall time of all stages
+
+    bool mParallelStages = true; // run independent stages on helper threads
+
+public:
+    MapLoader();
+    ~MapLoader();
+
+    // Load map and prepare level resources on calling thread, pending background loading gets cancelled
+    // @param mapName: Map file name
+    bool LoadMap(const std::string& mapName);
+
+    // Start loading map and preparing level resources on worker thread, pending background loading gets cancelled
+    // @param mapName: Map file name
+    void StartLoadingMap(const std::string& mapName);
+
+    // Cancel background loading and free loaded data
+    void Cleanup();
+
+    // Test whether worker thread is still loading map
+    inline bool IsLoading() const { return mLoaderState == eLoaderState_Loading; }
+
+    // Test whether map data is loaded and ready to use
+    inline bool IsLoaded() const { return mLoaderState == eLoaderState_Loaded; }
+
+    // Test whether last loading was completed with error
+    inline bool IsFailed() const { return mLoaderState == eLoaderState_Failed; }
+
+private:
+    enum eLoaderState
+    {
+        eLoaderState_Idle,
+        eLoaderState_Loading,
+        eLoaderState_Loaded,
+        eLoaderState_Failed,
+    };
+
+private:
+    bool LoadMapData();
+    bool ExecuteStage(eMapLoadStage loadStage);
+    void WorkerThreadProc();
+
+private:
+    std::thread mWorkerThread;
+    std::atomic<eLoaderState> mLoaderState;
+    std::atomic<bool> mCancelRequest;
+};
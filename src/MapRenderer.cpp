@@ -12,13 +12,18 @@
 #include "Vehicle.h"
 #include "RenderView.h"
 #include "TrafficManager.h"
+#include "BulletsManager.h"
+#include "ParticleEffectsManager.h"
 
 //////////////////////////////////////////////////////////////////////////
 
 void MapRenderStats::FrameBegin()
 {
     mBlockChunksDrawnCount = 0;
+    mBlockChunksDrawCalls = 0;
     mSpritesDrawnCount = 0;
+    mSnapshotCaptureTime = 0.0f;
+    mSnapshotWaitTime = 0.0f;
 
     ++mRenderFramesCounter;
 }
@@ -40,18 +45,30 @@ bool MapRenderer::Initialize()
     if (mCityMeshBufferV == nullptr || mCityMeshBufferI == nullptr)
         return false;
 
-    if (!mSpriteBatch.Initialize())
+    for (ViewSnapshot& currView: mSnapshot.mViews)
     {
-        gConsole.LogMessage(eLogMessage_Warning, "Cannot initialize sprites batch");
-        return false;
+        if (!currView.mSpriteBatch.Initialize())
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot initialize sprites batch");
+            return false;
+        }
     }
 
+    StartPrepareThread();
     return true;
 }
 
 void MapRenderer::Deinit()
 {
-    mSpriteBatch.Deinit();
+    WaitSnapshotPrepared();
+    ClearSnapshot(mSnapshot);
+    StopPrepareThread();
+
+    for (ViewSnapshot& currView: mSnapshot.mViews)
+    {
+        currView.mSpriteBatch.Deinit();
+    }
+
     if (mCityMeshBufferV)
     {
         gGraphicsDevice.DestroyBuffer(mCityMeshBufferV);
@@ -65,7 +82,7 @@ void MapRenderer::Deinit()
     }
 }
 
-void MapRenderer::RenderFrameBegin()
+void MapRenderer::RenderFrameBegin(const std::vector<RenderView*>& renderViews)
 {
     mRenderStats.FrameBegin();
 
@@ -77,13 +94,110 @@ void MapRenderer::RenderFrameBegin()
 
         PreDrawGameObject(gameObject);
     }
+
+    gBulletsManager.PreDrawFrame();
+
+    CaptureSnapshot(renderViews, mSnapshot);
+
+    if (mWorkerThreadPrepare && mPrepareThread.joinable())
+    {
+        // main thread waits for preparation right before drawing sprites of first view
+        {
+            std::lock_guard<std::mutex> prepareLock (mPrepareMutex);
+            mPrepareSnapshot = &mSnapshot;
+        }
+        mPrepareCondition.notify_all();
+    }
+    else
+    {
+        PrepareSnapshot(mSnapshot);
+    }
 }
 
 void MapRenderer::RenderFrameEnd()
 {
+    // discard sprites of views that were not drawn, snapshot is never kept across frames
+    // so objects, sprite textures and delta atlas could change freely until next capture
+    WaitSnapshotPrepared();
+    ClearSnapshot(mSnapshot);
+
     mRenderStats.FrameEnd();
 }
 
+void MapRenderer::ClearSnapshot(RenderSnapshot& snapshot)
+{
+    for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+    {
+        snapshot.mViews[iview].mSpriteBatch.Clear();
+    }
+    snapshot.mViewsCount = 0;
+}
+
+void MapRenderer::WaitSnapshotPrepared()
+{
+    std::unique_lock<std::mutex> prepareLock (mPrepareMutex);
+    if (mPrepareSnapshot)
+    {
+        double waitStartTime = gSystem.GetSystemSeconds();
+        mPrepareCondition.wait(prepareLock, [this]()
+            {
+                return mPrepareSnapshot == nullptr;
+            });
+        mRenderStats.mSnapshotWaitTime += (float) ((gSystem.GetSystemSeconds() - waitStartTime) * 1000.0);
+    }
+}
+
+void MapRenderer::StartPrepareThread()
+{
+    mPrepareThreadQuitRequest = false;
+    mPrepareThread = std::thread(&MapRenderer::PrepareThreadProc, this);
+}
+
+void MapRenderer::StopPrepareThread()
+{
+    if (!mPrepareThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> prepareLock (mPrepareMutex);
+        mPrepareThreadQuitRequest = true;
+    }
+    mPrepareCondition.notify_all();
+    mPrepareThread.join();
+}
+
+void MapRenderer::PrepareThreadProc()
+{
+    std::unique_lock<std::mutex> prepareLock (mPrepareMutex);
+    for (;;)
+    {
+        mPrepareCondition.wait(prepareLock, [this]()
+            {
+                return mPrepareSnapshot || mPrepareThreadQuitRequest;
+            });
+
+        if (mPrepareThreadQuitRequest)
+            break;
+
+        // main thread does not access queued snapshot until it is prepared
+        RenderSnapshot* snapshot = mPrepareSnapshot;
+        prepareLock.unlock();
+        PrepareSnapshot(*snapshot);
+        prepareLock.lock();
+
+        mPrepareSnapshot = nullptr;
+        mPrepareCondition.notify_all();
+    }
+}
+
+void MapRenderer::PrepareSnapshot(RenderSnapshot& snapshot)
+{
+    for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+    {
+        snapshot.mViews[iview].mSpriteBatch.Prepare(snapshot.mSpritesInstancing);
+    }
+}
+
 void MapRenderer::PreDrawGameObject(GameObject* gameObject)
 {
     if (gameObject->IsMarkedForDeletion() || gameObject->IsInvisibleFlag())
@@ -104,74 +218,204 @@ void MapRenderer::PreDrawGameObject(GameObject* gameObject)
     }
 }
 
-void MapRenderer::RenderFrame(RenderView* renderview)
+void MapRenderer::CaptureSnapshot(const std::vector<RenderView*>& renderViews, RenderSnapshot& snapshot)
 {
-    debug_assert(renderview);
+    double captureStartTime = gSystem.GetSystemSeconds();
 
-    gGraphicsDevice.BindTexture(eTextureUnit_3, gSpriteManager.mPalettesTable);
-    gGraphicsDevice.BindTexture(eTextureUnit_2, gSpriteManager.mPaletteIndicesTable);
+    debug_assert((int) renderViews.size() <= MaxRenderViews);
+    snapshot.mViewsCount = std::min((int) renderViews.size(), (int) MaxRenderViews);
+    snapshot.mSpritesInstancing = gRenderManager.mEnableSpritesInstancing && gRenderManager.mSpritesProgram.IsInstancingSupported();
 
-    if (gGameCheatsWindow.mEnableDrawCityMesh)
+    // objects outside of all views are rejected with single test
+    cxx::aabbox2d_t viewsArea;
+    for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
     {
-        DrawCityMesh(renderview);
+        RenderView* renderview = renderViews[iview];
+
+        ViewSnapshot& viewSnapshot = snapshot.mViews[iview];
+        viewSnapshot.mRenderView = renderview;
+        viewSnapshot.mCamera = renderview->mCamera;
+        viewSnapshot.mCamera.ComputeMatricesAndFrustum();
+        viewSnapshot.mSpriteBatch.BeginBatch(SpriteBatch::DepthAxis_Y, eSpritesSortMode_HeightAndDrawOrder);
+
+        viewsArea = (iview == 0) ? renderview->mOnScreenArea : viewsArea.union_with(renderview->mOnScreenArea);
     }
 
-    mSpriteBatch.BeginBatch(SpriteBatch::DepthAxis_Y, eSpritesSortMode_HeightAndDrawOrder);
+    if (snapshot.mViewsCount == 0)
+        return;
+
+    // city mesh chunks, when camera looks straight down chunks are selected from grid range under view area,
+    // geometry above ground gets projected closer to view center so ground area is conservative
+    memset(snapshot.mChunksViewMask, 0, sizeof(snapshot.mChunksViewMask));
+    for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+    {
+        const unsigned int viewBit = (1U << iview);
+
+        const GameCamera& viewCamera = snapshot.mViews[iview].mCamera;
+        if ((viewCamera.mCurrentMode != eSceneCameraMode_Perspective) || !viewCamera.IsTopDownOrientation())
+        {
+            // tilted free look camera sees beyond ground area, so each chunk is tested against frustum
+            for (int ichunk = 0; ichunk < BlocksBatchCount; ++ichunk)
+            {
+                const MapBlocksChunk& currChunk = mMapBlocksChunks[ichunk];
+                if (currChunk.mIndicesCount > 0 && viewCamera.mFrustum.contains(currChunk.mBounds))
+                {
+                    snapshot.mChunksViewMask[ichunk] |= viewBit;
+                }
+            }
+            continue;
+        }
+
+        const cxx::aabbox2d_t& onScreenArea = snapshot.mViews[iview].mRenderView->mOnScreenArea;
 
-    // collect and render game objects sprites
+        Point minBatch;
+        minBatch.x = (int) floorf((Convert::MetersToMapUnits(onScreenArea.mMin.x) + ExtraBlocksPerSide) / BlocksBatchDims);
+        minBatch.y = (int) floorf((Convert::MetersToMapUnits(onScreenArea.mMin.y) + ExtraBlocksPerSide) / BlocksBatchDims);
+        Point maxBatch;
+        maxBatch.x = (int) floorf((Convert::MetersToMapUnits(onScreenArea.mMax.x) + ExtraBlocksPerSide) / BlocksBatchDims);
+        maxBatch.y = (int) floorf((Convert::MetersToMapUnits(onScreenArea.mMax.y) + ExtraBlocksPerSide) / BlocksBatchDims);
+
+        minBatch.x = std::max(minBatch.x, 0);
+        minBatch.y = std::max(minBatch.y, 0);
+        maxBatch.x = std::min(maxBatch.x, BlocksBatchesPerSide - 1);
+        maxBatch.y = std::min(maxBatch.y, BlocksBatchesPerSide - 1);
+
+        for (int batchy = minBatch.y; batchy <= maxBatch.y; ++batchy)
+        {
+            for (int batchx = minBatch.x; batchx <= maxBatch.x; ++batchx)
+            {
+                snapshot.mChunksViewMask[batchy * BlocksBatchesPerSide + batchx] |= viewBit;
+            }
+        }
+    }
+
+    // game objects
     for (GameObject* gameObject: gGameObjectsManager.mAllObjects)
     {
         // attached objects must be drawn after the object to which they are attached
         if (gameObject->IsAttachedToObject())
             continue;
 
-        DrawGameObject(renderview, gameObject);
+        CollectVisibleObjects(gameObject, viewsArea, snapshot);
+    }
+
+    // bullets
+    for (const Sprite2D& currSprite: gBulletsManager.mDrawSprites)
+    {
+        if (!viewsArea.contains(currSprite.mPosition))
+            continue;
+
+        for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+        {
+            ViewSnapshot& viewSnapshot = snapshot.mViews[iview];
+            if (viewSnapshot.mRenderView->mOnScreenArea.contains(currSprite.mPosition))
+            {
+                viewSnapshot.mSpriteBatch.DrawSprite(currSprite);
+                ++mRenderStats.mSpritesDrawnCount;
+            }
+        }
+    }
+
+    if (gGameCheatsWindow.mEnableDrawDecorations)
+    {
+        for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+        {
+            ViewSnapshot& viewSnapshot = snapshot.mViews[iview];
+            mRenderStats.mSpritesDrawnCount += gParticleEffects.DrawParticles(viewSnapshot.mRenderView->mOnScreenArea, viewSnapshot.mSpriteBatch);
+        }
+    }
+
+    mRenderStats.mSnapshotCaptureTime += (float) ((gSystem.GetSystemSeconds() - captureStartTime) * 1000.0);
+}
+
+void MapRenderer::CollectVisibleObjects(GameObject* gameObject, const cxx::aabbox2d_t& viewsArea, RenderSnapshot& snapshot)
+{
+    if (gameObject->IsMarkedForDeletion() || gameObject->IsInvisibleFlag())
+        return;
+
+    bool debugSkipDraw = 
+        (!gGameCheatsWindow.mEnableDrawPedestrians && gameObject->IsPedestrianClass()) ||
+        (!gGameCheatsWindow.mEnableDrawVehicles && gameObject->IsVehicleClass()) ||
+        (!gGameCheatsWindow.mEnableDrawObstacles && gameObject->IsObstacleClass()) ||
+        (!gGameCheatsWindow.mEnableDrawDecorations && gameObject->IsDecorationClass());
+
+    // detect in which views gameobject is visible
+    if (!debugSkipDraw && gameObject->IsOnScreen(viewsArea))
+    {
+        unsigned int viewMask = 0;
+        for (int iview = 0; iview < snapshot.mViewsCount; ++iview)
+        {
+            ViewSnapshot& viewSnapshot = snapshot.mViews[iview];
+            if (gameObject->IsOnScreen(viewSnapshot.mRenderView->mOnScreenArea))
+            {
+                // sprite is copied so it could be sorted on worker thread while main thread keeps drawing
+                viewSnapshot.mSpriteBatch.DrawSprite(gameObject->mDrawSprite);
+                ++mRenderStats.mSpritesDrawnCount;
+                viewMask |= (1U << iview);
+            }
+        }
+
+        if (viewMask)
+        {
+            gameObject->mLastRenderFrame = mRenderStats.mRenderFramesCounter;
+        }
+    }
+
+    // collect attached objects
+    for (int ichild = 0; ; ++ichild)
+    {
+        GameObject* currentChild = gameObject->GetAttachedObject(ichild);
+        if (currentChild == nullptr)
+            break;
+
+        CollectVisibleObjects(currentChild, viewsArea, snapshot);
+    }
+}
+
+void MapRenderer::RenderFrame(RenderView* renderview)
+{
+    debug_assert(renderview);
+
+    int viewIndex = 0;
+    for (; viewIndex < mSnapshot.mViewsCount; ++viewIndex)
+    {
+        if (mSnapshot.mViews[viewIndex].mRenderView == renderview)
+            break;
+    }
+    // view was not captured
+    if (viewIndex == mSnapshot.mViewsCount)
+        return;
+
+    ViewSnapshot& viewSnapshot = mSnapshot.mViews[viewIndex];
+
+    gGraphicsDevice.BindTexture(eTextureUnit_3, gSpriteManager.mPalettesTable);
+    gGraphicsDevice.BindTexture(eTextureUnit_2, gSpriteManager.mPaletteIndicesTable);
+
+    if (gGameCheatsWindow.mEnableDrawCityMesh)
+    {
+        gRenderManager.mStatistics.BeginPass(eRenderPass_CityMesh);
+        DrawCityMesh(mSnapshot, viewIndex);
+        gRenderManager.mStatistics.EndPass(eRenderPass_CityMesh);
     }
 
     gRenderManager.mSpritesProgram.Activate();
-    gRenderManager.mSpritesProgram.UploadCameraTransformMatrices(renderview->mCamera);
+    gRenderManager.mSpritesProgram.UploadCameraTransformMatrices(viewSnapshot.mCamera);
 
     RenderStates guiRenderStates = RenderStates()
         .Disable(RenderStateFlags_FaceCulling)
         .Disable(RenderStateFlags_DepthWrite);
     gGraphicsDevice.SetRenderStates(guiRenderStates);
 
-    mSpriteBatch.Flush();
+    // city mesh is submitted while worker thread prepares sprites
+    WaitSnapshotPrepared();
+
+    gRenderManager.mStatistics.BeginPass(eRenderPass_Sprites);
+    viewSnapshot.mSpriteBatch.Submit();
+    gRenderManager.mStatistics.EndPass(eRenderPass_Sprites);
 
     gRenderManager.mSpritesProgram.Deactivate();
 }
 
-void MapRenderer::DrawGameObject(RenderView* renderview, GameObject* gameObject)
-{
-    if (gameObject->IsMarkedForDeletion() || gameObject->IsInvisibleFlag())
-        return;
-
-    bool debugSkipDraw = 
-        (!gGameCheatsWindow.mEnableDrawPedestrians && gameObject->IsPedestrianClass()) ||
-        (!gGameCheatsWindow.mEnableDrawVehicles && gameObject->IsVehicleClass()) ||
-        (!gGameCheatsWindow.mEnableDrawObstacles && gameObject->IsObstacleClass()) ||
-        (!gGameCheatsWindow.mEnableDrawDecorations && gameObject->IsDecorationClass());
-
-    // detect if gameobject is visible on screen
-    if (!debugSkipDraw && gameObject->IsOnScreen(renderview->mOnScreenArea))
-    {
-        mSpriteBatch.DrawSprite(gameObject->mDrawSprite);
-
-        ++mRenderStats.mSpritesDrawnCount;
-        gameObject->mLastRenderFrame = mRenderStats.mRenderFramesCounter;
-    }
-
-    // draw attached objects
-    for (int ichild = 0; ; ++ichild)
-    {
-        GameObject* currentChild = gameObject->GetAttachedObject(ichild);
-        if (currentChild == nullptr)
-            break;
-
-        DrawGameObject(renderview, currentChild);
-    }
-}
-
 void MapRenderer::DebugDraw(RenderView* renderview, DebugRenderer& debugRender)
 {
     debug_assert(renderview);
@@ -185,14 +429,14 @@ void MapRenderer::DebugDraw(RenderView* renderview, DebugRenderer& debugRender)
     }
 }
 
-void MapRenderer::DrawCityMesh(RenderView* renderview)
+void MapRenderer::DrawCityMesh(const RenderSnapshot& snapshot, int viewIndex)
 {
     RenderStates cityMeshRenderStates;
 
     gGraphicsDevice.SetRenderStates(cityMeshRenderStates);
 
     gRenderManager.mCityMeshProgram.Activate();
-    gRenderManager.mCityMeshProgram.UploadCameraTransformMatrices(renderview->mCamera);
+    gRenderManager.mCityMeshProgram.UploadCameraTransformMatrices(snapshot.mViews[viewIndex].mCamera);
 
     if (mCityMeshBufferV && mCityMeshBufferI)
     {
@@ -201,23 +445,62 @@ void MapRenderer::DrawCityMesh(RenderView* renderview)
         gGraphicsDevice.BindTexture(eTextureUnit_0, gSpriteManager.mBlocksTextureArray);
         gGraphicsDevice.BindTexture(eTextureUnit_1, gSpriteManager.mBlocksIndicesTable);
 
-        for (const MapBlocksChunk& currChunk: mMapBlocksChunks)
+        // chunks are stored in row-major order, so neighbour visible chunks are merged into single draw
+        unsigned int rangeIndicesStart = 0;
+        unsigned int rangeIndicesCount = 0;
+
+        const unsigned int viewBit = (1U << viewIndex);
+        for (int ichunk = 0; ichunk < BlocksBatchCount; ++ichunk)
         {
-            if (!renderview->mCamera.mFrustum.contains(currChunk.mBounds))
+            const MapBlocksChunk& currChunk = mMapBlocksChunks[ichunk];
+            // empty chunk does not break range
+            if (currChunk.mIndicesCount == 0)
                 continue;
 
-            gGraphicsDevice.RenderIndexedPrimitives(ePrimitiveType_Triangles, eIndicesType_i32, 
-                currChunk.mIndicesStart * Sizeof_DrawIndex, currChunk.mIndicesCount);
+            if ((snapshot.mChunksViewMask[ichunk] & viewBit) == 0)
+            {
+                DrawCityMeshRange(rangeIndicesStart, rangeIndicesCount);
+                rangeIndicesCount = 0;
+                continue;
+            }
+
+            if (rangeIndicesCount > 0 && (rangeIndicesStart + rangeIndicesCount) != currChunk.mIndicesStart)
+            {
+                DrawCityMeshRange(rangeIndicesStart, rangeIndicesCount);
+                rangeIndicesCount = 0;
+            }
+
+            if (rangeIndicesCount == 0)
+            {
+                rangeIndicesStart = currChunk.mIndicesStart;
+            }
+            rangeIndicesCount += currChunk.mIndicesCount;
 
             ++mRenderStats.mBlockChunksDrawnCount;
         }
+        DrawCityMeshRange(rangeIndicesStart, rangeIndicesCount);
     }
     gRenderManager.mCityMeshProgram.Deactivate();
 }
 
-void MapRenderer::BuildMapMesh()
+void MapRenderer::DrawCityMeshRange(unsigned int indicesStart, unsigned int indicesCount)
+{
+    if (indicesCount == 0)
+        return;
+
+    gGraphicsDevice.RenderIndexedPrimitives(ePrimitiveType_Triangles, eIndicesType_i32, 
+        indicesStart * Sizeof_DrawIndex, indicesCount);
+
+    ++mRenderStats.mBlockChunksDrawCalls;
+}
+
+void MapRenderer::PrepareMapMesh(GameMapManager& gameMap, MapMeshData& meshData)
 {
-    CityMeshData blocksMesh;
+    CityMeshData& blocksMesh = meshData.mGeometry;
+    blocksMesh.Clear();
+
+    meshData.mChunks.clear();
+    meshData.mChunks.resize(BlocksBatchCount);
     for (int batchy = 0; batchy < BlocksBatchesPerSide; ++batchy)
     {
         for (int batchx = 0; batchx < BlocksBatchesPerSide; ++batchx)
@@ -231,7 +514,7 @@ void MapRenderer::BuildMapMesh()
             unsigned int prevVerticesCount = blocksMesh.mBlocksVertices.size();
             unsigned int prevIndicesCount = blocksMesh.mBlocksIndices.size();
 
-            MapBlocksChunk& currChunk = mMapBlocksChunks[batchy * BlocksBatchesPerSide + batchx];
+            MapBlocksChunk& currChunk = meshData.mChunks[batchy * BlocksBatchesPerSide + batchx];
             currChunk.mBounds.mMin = glm::vec3 { mapArea.x * METERS_PER_MAP_UNIT, 0.0f, mapArea.y * METERS_PER_MAP_UNIT };
             currChunk.mBounds.mMax = glm::vec3 { 
                 (mapArea.x + mapArea.w) * METERS_PER_MAP_UNIT, MAP_LAYERS_COUNT * METERS_PER_MAP_UNIT, 
@@ -241,12 +524,20 @@ void MapRenderer::BuildMapMesh()
             currChunk.mIndicesStart = prevIndicesCount;
             
             // append new geometry
-            GameMapHelpers::BuildMapMesh(gGameMap, mapArea, blocksMesh);
+            GameMapHelpers::BuildMapMesh(gameMap, mapArea, blocksMesh);
             
             currChunk.mVerticesCount = blocksMesh.mBlocksVertices.size() - prevVerticesCount;
             currChunk.mIndicesCount = blocksMesh.mBlocksIndices.size() - prevIndicesCount;
         }
     }
+}
+
+void MapRenderer::BuildMapMesh(const MapMeshData& meshData)
+{
+    const CityMeshData& blocksMesh = meshData.mGeometry;
+
+    debug_assert(meshData.mChunks.size() == BlocksBatchCount);
+    std::copy(meshData.mChunks.begin(), meshData.mChunks.end(), mMapBlocksChunks);
 
     // upload map geometry to video memory
     int totalVertexDataBytes = blocksMesh.mBlocksVertices.size() * Sizeof_CityVertex3D;
@@ -1,11 +1,33 @@
 #pragma once
 
+#include <mutex>
+#include <condition_variable>
 #include "SpriteBatch.h"
 #include "GameDefs.h"
+#include "GameMapHelpers.h"
+#include "GameCamera.h"
 
 class DebugRenderer;
 class RenderView;
 
+// part of city mesh, used for culling
+struct MapBlocksChunk
+{
+public:
+    cxx::aabbox_t mBounds;
+    // index/vertex data offset in vbo
+    unsigned int mIndicesStart = 0, mIndicesCount = 0;
+    unsigned int mVerticesStart = 0, mVerticesCount = 0;
+};
+
+// city mesh geometry generated on cpu
+struct MapMeshData
+{
+public:
+    CityMeshData mGeometry;
+    std::vector<MapBlocksChunk> mChunks;
+};
+
 // map renderer statistics info
 struct MapRenderStats
 {
@@ -16,30 +38,49 @@ public:
 
 public:
     int mBlockChunksDrawnCount = 0;  // per frame
+    int mBlockChunksDrawCalls = 0; // per frame, neighbour chunks are drawn at once
     int mSpritesDrawnCount = 0; // per frame
+    float mSnapshotCaptureTime = 0.0f; // milliseconds per frame, including visibility pass
+    float mSnapshotWaitTime = 0.0f; // milliseconds per frame, main thread was waiting for sprites preparation
 
     unsigned int mRenderFramesCounter = 0; // gets incremented on every frame
 };
 
 // renders map mesh, peds, cars and map objects
+// drawing data of all views is captured into render snapshot at frame begin, then sprites are sorted and batched
+// on worker thread while main thread draws city mesh, snapshot is drawn in same frame in which it was captured
 class MapRenderer final: public cxx::noncopyable
 {
 public:
     MapRenderStats mRenderStats;
 
+    bool mWorkerThreadPrepare = true; // sprites preparation overlaps with city mesh drawing
+
 public:
     bool Initialize();
     void Deinit();
-    void RenderFrameBegin();
-    void RenderFrame(RenderView* renderview);
+
+    // Prepare objects for drawing and capture render snapshot of all active views,
+    // visibility is computed once for all views
+    // @param renderViews: Views to be drawn in current frame
+    void RenderFrameBegin(const std::vector<RenderView*>& renderViews);
+
+    // Draw city mesh chunks and sprites of specified view from prepared render snapshot
+    // @param renderview: View previously passed to RenderFrameBegin
+    void RenderFrame(RenderView* renderview);
     void DebugDraw(RenderView* renderview, DebugRenderer& debugRender);
+
+    // Wait until snapshot is prepared and discard all captured data
     void RenderFrameEnd();
-    void BuildMapMesh();
 
-private:
-    void DrawCityMesh(RenderView* renderview);
-    void DrawGameObject(RenderView* renderview, GameObject* gameObject);
-    void PreDrawGameObject(GameObject* gameObject);
+    // Generate city mesh geometry, does not access gpu so it could be called from worker thread
+    // @param gameMap: Source map data
+    // @param meshData: Output geometry
+    static void PrepareMapMesh(GameMapManager& gameMap, MapMeshData& meshData);
+
+    // Upload city mesh geometry to video memory
+    // @param meshData: Prepared geometry
+    void BuildMapMesh(const MapMeshData& meshData);
 
 private:
     enum
@@ -49,17 +90,52 @@ private:
         BlocksBatchesPerSide = ((MAP_DIMENSIONS + (ExtraBlocksPerSide * 2)) + BlocksBatchDims - 1) / BlocksBatchDims,
         BlocksBatchCount = BlocksBatchesPerSide * BlocksBatchesPerSide,
     };
-    struct MapBlocksChunk
+
+    static const int MaxRenderViews = GAME_MAX_PLAYERS;
+
+    // drawing data of single view, immutable after capture except for sprites preparation
+    struct ViewSnapshot
+    {
+    public:
+        RenderView* mRenderView = nullptr; // only compared on draw, view could be removed after capture
+        GameCamera mCamera;
+        SpriteBatch mSpriteBatch; // visible objects, bullets and particles
+    };
+
+    struct RenderSnapshot
     {
-        cxx::aabbox_t mBounds; // for culling
-        // index/vertex data offset in vbo
-        unsigned int mIndicesStart = 0, mIndicesCount = 0;
-        unsigned int mVerticesStart = 0, mVerticesCount = 0;
+    public:
+        ViewSnapshot mViews[MaxRenderViews];
+        int mViewsCount = 0;
+        unsigned int mChunksViewMask[BlocksBatchCount] = {}; // one bit per view
+        bool mSpritesInstancing = false;
     };
+
+private:
+    void DrawCityMesh(const RenderSnapshot& snapshot, int viewIndex);
+    void DrawCityMeshRange(unsigned int indicesStart, unsigned int indicesCount);
+    void PreDrawGameObject(GameObject* gameObject);
+    void CaptureSnapshot(const std::vector<RenderView*>& renderViews, RenderSnapshot& snapshot);
+    void CollectVisibleObjects(GameObject* gameObject, const cxx::aabbox2d_t& viewsArea, RenderSnapshot& snapshot);
+    void ClearSnapshot(RenderSnapshot& snapshot);
+    void WaitSnapshotPrepared();
+    void StartPrepareThread();
+    void StopPrepareThread();
+    void PrepareThreadProc();
+    static void PrepareSnapshot(RenderSnapshot& snapshot);
+
+private:
     MapBlocksChunk mMapBlocksChunks[BlocksBatchCount];
 
     GpuBuffer* mCityMeshBufferV;
     GpuBuffer* mCityMeshBufferI;
 
-    SpriteBatch mSpriteBatch;
+    RenderSnapshot mSnapshot; // captured in current frame
+
+    // worker thread lives while renderer is initialized and waits for snapshot to prepare
+    std::thread mPrepareThread;
+    std::mutex mPrepareMutex;
+    std::condition_variable mPrepareCondition; // signaled when snapshot is queued or prepared
+    RenderSnapshot* mPrepareSnapshot = nullptr; // queued for preparation, guarded by mutex
+    bool mPrepareThreadQuitRequest = false; // guarded by mutex
 };
\ No newline at end of file
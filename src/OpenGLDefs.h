@@ -141,6 +141,7 @@ inline GLenum GetAttributeDataTypeGL(eVertexAttributeFormat attributeFormat)
     {
         case eVertexAttributeFormat_2F: return GL_FLOAT;
         case eVertexAttributeFormat_3F: return GL_FLOAT;
+        case eVertexAttributeFormat_4F: return GL_FLOAT;
         case eVertexAttributeFormat_4UB: return GL_UNSIGNED_BYTE;
         case eVertexAttributeFormat_1US: return GL_UNSIGNED_SHORT;
         case eVertexAttributeFormat_2US: return GL_UNSIGNED_SHORT;
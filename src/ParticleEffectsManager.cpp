@@ -0,0 +1,212 @@
+#include "stdafx.h"
+#include "ParticleEffectsManager.h"
+#include "GameMapManager.h"
+#include "TimeManager.h"
+#include "SpriteManager.h"
+#include "SpriteBatch.h"
+
+ParticleEffectsManager gParticleEffects;
+
+void ParticleEffectsManager::UpdateFrame()
+{
+    float deltaTime = gTimeManager.mGameFrameDelta;
+    if (deltaTime <= 0.0f)
+        return;
+
+    StyleData& cityStyle = gGameMap.mStyleData;
+
+    // advance animations
+    for (int iparticle = 0; iparticle < GetParticlesCount(); )
+    {
+        const SpriteAnimData& animData = cityStyle.mObjects[mObjectTypes[iparticle]].mAnimationData;
+
+        const float FrameDuration = (1.0f / animData.mFrameRate);
+        const int LastFrame = animData.GetFramesCount() - 1;
+
+        bool isExpired = false;
+
+        float& frameTime = mFrameTimes[iparticle];
+        int& frameCursor = mFrameCursors[iparticle];
+        for (frameTime += deltaTime; frameTime >= FrameDuration; frameTime -= FrameDuration)
+        {
+            if (frameCursor < LastFrame)
+            {
+                ++frameCursor;
+                continue;
+            }
+
+            // cycle completed
+            int& cyclesLeft = mCyclesLeft[iparticle];
+            if ((cyclesLeft > 0) && (--cyclesLeft == 0))
+            {
+                isExpired = true;
+                break;
+            }
+            frameCursor = 0;
+        }
+
+        if (isExpired)
+        {
+            DestroyParticle(iparticle);
+            continue;
+        }
+        ++iparticle;
+    }
+
+    // advance positions
+    for (int iparticle = 0, Count = GetParticlesCount(); iparticle < Count; ++iparticle)
+    {
+        mPositions[iparticle] += mVelocities[iparticle] * deltaTime;
+    }
+}
+
+void ParticleEffectsManager::ClearParticles()
+{
+    mPositions.clear();
+    mVelocities.clear();
+    mHeadings.clear();
+    mObjectTypes.clear();
+    mFrameCursors.clear();
+    mFrameTimes.clear();
+    mCyclesLeft.clear();
+    mDrawOrders.clear();
+    mEmitSerials.clear();
+}
+
+int ParticleEffectsManager::DrawParticles(const cxx::aabbox2d_t& onScreenArea, SpriteBatch& spriteBatch) const
+{
+    StyleData& cityStyle = gGameMap.mStyleData;
+
+    int spritesCounter = 0;
+
+    Sprite2D drawSprite;
+    for (int iparticle = 0, Count = GetParticlesCount(); iparticle < Count; ++iparticle)
+    {
+        const glm::vec3& position = mPositions[iparticle];
+        if (!onScreenArea.contains(glm::vec2(position.x, position.z)))
+            continue;
+
+        const SpriteAnimData& animData = cityStyle.mObjects[mObjectTypes[iparticle]].mAnimationData;
+        int spriteIndex = animData.mFrames[mFrameCursors[iparticle]].mSprite;
+        gSpriteManager.GetSpriteTexture(GAMEOBJECT_ID_NULL, spriteIndex, 0, drawSprite);
+
+        drawSprite.mPosition.x = position.x;
+        drawSprite.mPosition.y = position.z;
+        drawSprite.mHeight = position.y;
+        drawSprite.mRotateAngle = mHeadings[iparticle] - cxx::angle_t::from_degrees(SPRITE_ZERO_ANGLE);
+        drawSprite.mDrawOrder = mDrawOrders[iparticle];
+        spriteBatch.DrawSprite(drawSprite);
+        ++spritesCounter;
+    }
+    return spritesCounter;
+}
+
+void ParticleEffectsManager::EmitEffect(const GameObjectInfo& desc, const glm::vec3& position, cxx::angle_t heading, eSpriteDrawOrder drawOrder,
+    int lifeDuration, const glm::vec3& moveVelocity)
+{
+    debug_assert(desc.mClassID == eGameObjectClass_Decoration);
+
+    // nothing to draw
+    if (desc.mAnimationData.GetFramesCount() == 0)
+        return;
+
+    if (GetParticlesCount() == MaxParticles)
+    {
+        // endless effects like smoke must not block short hit and blood effects
+        int particleIndex = FindOldestParticle(true);
+        if ((particleIndex == -1) && (lifeDuration > 0))
+        {
+            particleIndex = FindOldestParticle(false);
+        }
+        if (particleIndex == -1)
+            return;
+
+        DestroyParticle(particleIndex);
+    }
+
+    mPositions.push_back(position);
+    mVelocities.push_back(moveVelocity);
+    mHeadings.push_back(heading);
+    mObjectTypes.push_back(desc.mObjectType);
+    mFrameCursors.push_back(0);
+    mFrameTimes.push_back(0.0f);
+    mCyclesLeft.push_back(lifeDuration);
+    mDrawOrders.push_back(drawOrder);
+    mEmitSerials.push_back(mEmitCounter++);
+}
+
+void ParticleEffectsManager::EmitFirstBlood(const glm::vec3& position)
+{
+    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_FirstBlood];
+    EmitEffect(objectInfo, position, cxx::angle_t(), eSpriteDrawOrder_GroundDecals, objectInfo.mLifeDuration, glm::vec3(0.0f));
+}
+
+void ParticleEffectsManager::EmitWaterSplash(const glm::vec3& position)
+{
+    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_Splash];
+    EmitEffect(objectInfo, position, cxx::angle_t(), objectInfo.mDrawOrder, objectInfo.mLifeDuration, glm::vec3(0.0f));
+}
+
+void ParticleEffectsManager::EmitBigSmoke(const glm::vec3& position)
+{
+    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[GameObjectType_BigSmoke];
+
+    const glm::vec3 velocity (1.0f, 0.0f, 0.0f); // add some wind effect, todo: magic values
+    EmitEffect(objectInfo, position, cxx::angle_t(), objectInfo.mDrawOrder, objectInfo.mLifeDuration, velocity);
+}
+
+void ParticleEffectsManager::EmitHitEffect(int objectType, const glm::vec3& position)
+{
+    GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[objectType];
+    EmitEffect(objectInfo, position, cxx::angle_t(), eSpriteDrawOrder_Projectiles, 1, glm::vec3(0.0f));
+}
+
+void ParticleEffectsManager::DestroyParticle(int particleIndex)
+{
+    debug_assert(particleIndex > -1 && particleIndex < GetParticlesCount());
+
+    // move last particle in place of destroyed one
+    int lastIndex = GetParticlesCount() - 1;
+    if (particleIndex != lastIndex)
+    {
+        mPositions[particleIndex] = mPositions[lastIndex];
+        mVelocities[particleIndex] = mVelocities[lastIndex];
+        mHeadings[particleIndex] = mHeadings[lastIndex];
+        mObjectTypes[particleIndex] = mObjectTypes[lastIndex];
+        mFrameCursors[particleIndex] = mFrameCursors[lastIndex];
+        mFrameTimes[particleIndex] = mFrameTimes[lastIndex];
+        mCyclesLeft[particleIndex] = mCyclesLeft[lastIndex];
+        mDrawOrders[particleIndex] = mDrawOrders[lastIndex];
+        mEmitSerials[particleIndex] = mEmitSerials[lastIndex];
+    }
+
+    mPositions.pop_back();
+    mVelocities.pop_back();
+    mHeadings.pop_back();
+    mObjectTypes.pop_back();
+    mFrameCursors.pop_back();
+    mFrameTimes.pop_back();
+    mCyclesLeft.pop_back();
+    mDrawOrders.pop_back();
+    mEmitSerials.pop_back();
+}
+
+int ParticleEffectsManager::FindOldestParticle(bool endlessOnly) const
+{
+    int oldestIndex = -1;
+    unsigned int oldestAge = 0;
+    for (int iparticle = 0, Count = GetParticlesCount(); iparticle < Count; ++iparticle)
+    {
+        if (endlessOnly && (mCyclesLeft[iparticle] > 0))
+            continue;
+
+        // counter could wrap around, so compare ages rather than serials
+        unsigned int particleAge = mEmitCounter - mEmitSerials[iparticle];
+        if ((oldestIndex == -1) || (particleAge > oldestAge))
+        {
+            oldestIndex = iparticle;
+            oldestAge = particleAge;
+        }
+    }
+    return oldestIndex;
+}
\ No newline at end of file
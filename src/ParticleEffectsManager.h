@@ -0,0 +1,68 @@
+#pragma once
+
+#include "GameDefs.h"
+
+class SpriteBatch;
+
+// Short-lived visual effects manager - blood, smoke, water splashes, hits
+// Unlike decoration gameobjects effects cannot be attached or referenced, so they are stored compactly
+// and animated all at once
+class ParticleEffectsManager final: public cxx::noncopyable
+{
+public:
+    static const int MaxParticles = 4096;
+
+public:
+    void UpdateFrame();
+
+    // Destroy all active effects
+    void ClearParticles();
+
+    // Emit sprites of visible effects
+    // @param onScreenArea: Visible map rectangle, meters
+    // @param spriteBatch: Target sprite batch
+    // @returns number of emitted sprites
+    int DrawParticles(const cxx::aabbox2d_t& onScreenArea, SpriteBatch& spriteBatch) const;
+
+    // Add new effect instance at specific location
+    // @param desc: Effect gameobject type, must be decoration class
+    // @param position: Position, meters
+    // @param heading: Rotation
+    // @param drawOrder: Sprite draw order
+    // @param lifeDuration: Number of animation cycles before effect will be destroyed, or 0 for endless lifetime
+    // When particles limit is reached oldest endless effect gets replaced, short effects only replace each other
+    // @param moveVelocity: Move velocity, meters per second
+    void EmitEffect(const GameObjectInfo& desc, const glm::vec3& position, cxx::angle_t heading, eSpriteDrawOrder drawOrder,
+        int lifeDuration, const glm::vec3& moveVelocity);
+
+    void EmitFirstBlood(const glm::vec3& position);
+    void EmitWaterSplash(const glm::vec3& position);
+    void EmitBigSmoke(const glm::vec3& position);
+    void EmitHitEffect(int objectType, const glm::vec3& position);
+
+    inline int GetParticlesCount() const { return (int) mPositions.size(); }
+
+private:
+    void DestroyParticle(int particleIndex);
+
+    // Find oldest effect to replace when particles limit is reached
+    // @param endlessOnly: Consider only effects with endless lifetime
+    // @returns particle index or -1
+    int FindOldestParticle(bool endlessOnly) const;
+
+private:
+    // particles data, each property is stored in separate array
+    std::vector<glm::vec3> mPositions; // meters
+    std::vector<glm::vec3> mVelocities; // meters per second
+    std::vector<cxx::angle_t> mHeadings;
+    std::vector<int> mObjectTypes; // index in gameobjects types table
+    std::vector<int> mFrameCursors;
+    std::vector<float> mFrameTimes; // animation time accumulator
+    std::vector<int> mCyclesLeft; // animation cycles until destroy, 0 for endless lifetime
+    std::vector<eSpriteDrawOrder> mDrawOrders;
+    std::vector<unsigned int> mEmitSerials; // emit sequence number, used to find oldest effect
+
+    unsigned int mEmitCounter = 0;
+};
+
+extern ParticleEffectsManager gParticleEffects;
\ No newline at end of file
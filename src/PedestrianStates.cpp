@@ -8,6 +8,7 @@
 #include "TimeManager.h"
 #include "BroadcastEventsManager.h"
 #include "AudioManager.h"
+#include "ParticleEffectsManager.h"
 
 PedestrianStatesManager::PedestrianStatesManager(Pedestrian* pedestrian)
     : mPedestrian(pedestrian)
@@ -370,11 +371,7 @@ void PedestrianStatesManager::StateDead_ProcessEnter(const PedestrianStateEvent&
     if (createBlood)
     {
         glm::vec3 position = mPedestrian->mPhysicsBody->GetPosition();
-        Decoration* decoration = gGameObjectsManager.CreateFirstBlood(position);
-        if (decoration)
-        {
-            decoration->SetDrawOrder(eSpriteDrawOrder_GroundDecals);
-        }
+        gParticleEffects.EmitFirstBlood(position);
     }
 
     if (mPedestrian->IsHumanPlayerCharacter())
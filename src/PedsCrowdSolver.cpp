@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include "PedsCrowdSolver.h"
+#include "PhysicsComponents.h"
+#include "PhysicsDefs.h"
+#include "Pedestrian.h"
+#include "GameMapManager.h"
+
+void PedsCrowdSolver::SimulationStep(const std::vector<PhysicsBody*>& pedsBodies, float stepTime)
+{
+    GatherPeds(pedsBodies, stepTime);
+
+    mPairsCount = 0;
+    if (mPedsCount > 1)
+    {
+        BuildSpatialHash();
+        SolveOverlaps();
+    }
+    ScatterPeds(stepTime);
+}
+
+void PedsCrowdSolver::RestoreVelocities()
+{
+    for (const CrowdPed& currPed: mPeds)
+    {
+        // velocity could be changed by collision handlers during world step
+        if (currPed.mPedBody->GetLinearVelocity() != currPed.mSolvedVelocity)
+            continue;
+
+        currPed.mPedBody->SetLinearVelocity(currPed.mVelocity);
+    }
+}
+
+void PedsCrowdSolver::GatherPeds(const std::vector<PhysicsBody*>& pedsBodies, float stepTime)
+{
+    mPeds.clear();
+
+    // cell is large enough to find all overlapping neighbours in adjacent cells
+    mCellSize = gGameParams.mPedestrianBoundsSphereRadius * 2.0f;
+
+    for (PhysicsBody* currBody: pedsBodies)
+    {
+        PedPhysicsBody* pedBody = static_cast<PedPhysicsBody*>(currBody);
+        // pedestrian touching car stays dynamic so car could push it
+        bool isCrowdMember = !pedBody->mWaterContact && (pedBody->mContactingCars == 0) && 
+            pedBody->ShouldContactWith(PHYSICS_OBJCAT_PED);
+
+        pedBody->SetCrowdMember(isCrowdMember);
+        if (!isCrowdMember)
+            continue;
+
+        CrowdPed crowdPed;
+        crowdPed.mPedBody = pedBody;
+        crowdPed.mStartPosition = pedBody->GetPosition2();
+        crowdPed.mVelocity = pedBody->GetLinearVelocity();
+        crowdPed.mPosition = crowdPed.mStartPosition + crowdPed.mVelocity * stepTime;
+        crowdPed.mCell.x = (int) floorf(crowdPed.mPosition.x / mCellSize);
+        crowdPed.mCell.y = (int) floorf(crowdPed.mPosition.y / mCellSize);
+        crowdPed.mMapLayer = (int) (Convert::MetersToMapUnits(pedBody->mHeight) + 0.5f);
+        mPeds.push_back(crowdPed);
+    }
+    mPedsCount = (int) mPeds.size();
+}
+
+void PedsCrowdSolver::BuildSpatialHash()
+{
+    int bucketsCount = 64;
+    while (bucketsCount < mPedsCount * 2)
+    {
+        bucketsCount *= 2;
+    }
+    mBuckets.assign(bucketsCount, -1);
+
+    for (int iped = 0; iped < mPedsCount; ++iped)
+    {
+        int bucketIndex = GetBucketIndex(mPeds[iped].mCell);
+        mPeds[iped].mNextInBucket = mBuckets[bucketIndex];
+        mBuckets[bucketIndex] = iped;
+    }
+}
+
+void PedsCrowdSolver::SolveOverlaps()
+{
+    const int IterationsCount = 2;
+    const float MinDistance = gGameParams.mPedestrianBoundsSphereRadius * 2.0f;
+
+    for (int iteration = 0; iteration < IterationsCount; ++iteration)
+    {
+        for (int iped = 0; iped < mPedsCount; ++iped)
+        {
+            CrowdPed& currPed = mPeds[iped];
+            for (int offsety = -1; offsety < 2; ++offsety)
+            {
+                for (int offsetx = -1; offsetx < 2; ++offsetx)
+                {
+                    Point neighbourCell (currPed.mCell.x + offsetx, currPed.mCell.y + offsety);
+                    for (int iother = mBuckets[GetBucketIndex(neighbourCell)]; iother != -1; iother = mPeds[iother].mNextInBucket)
+                    {
+                        CrowdPed& otherPed = mPeds[iother];
+                        // each pair is processed once, also skip peds from other cells mapped into same bucket
+                        if (iother <= iped || otherPed.mCell != neighbourCell || otherPed.mMapLayer != currPed.mMapLayer)
+                            continue;
+
+                        glm::vec2 toOther = otherPed.mPosition - currPed.mPosition;
+                        float distance2 = glm::dot(toOther, toOther);
+                        if (distance2 >= MinDistance * MinDistance)
+                            continue;
+
+                        float distance = sqrtf(distance2);
+                        // peds at same point are pushed apart along arbitrary axis
+                        glm::vec2 direction = (distance > 0.0001f) ? (toOther / distance) : glm::vec2(1.0f, 0.0f);
+                        glm::vec2 correction = direction * ((MinDistance - distance) * 0.5f);
+                        currPed.mPosition -= correction;
+                        otherPed.mPosition += correction;
+                        if (iteration == 0)
+                        {
+                            ++mPairsCount;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void PedsCrowdSolver::ScatterPeds(float stepTime)
+{
+    // prevent too large jumps in dense crowds
+    const float MaxCorrection = gGameParams.mPedestrianBoundsSphereRadius;
+
+    for (CrowdPed& currPed: mPeds)
+    {
+        glm::vec2 displacement = currPed.mVelocity * stepTime;
+        glm::vec2 correction = currPed.mPosition - (currPed.mStartPosition + displacement);
+        float correctionLength = glm::length(correction);
+        if (correctionLength > MaxCorrection)
+        {
+            correction *= (MaxCorrection / correctionLength);
+        }
+        displacement = ClipByBuildings(currPed, displacement + correction);
+
+        // body is moved by world step, it is cheaper than teleport which touches broadphase proxy twice
+        currPed.mSolvedVelocity = displacement / stepTime;
+        currPed.mPedBody->SetLinearVelocity(currPed.mSolvedVelocity);
+    }
+}
+
+int PedsCrowdSolver::GetBucketIndex(const Point& cell) const
+{
+    unsigned int hash = ((unsigned int) cell.x * 73856093u) ^ ((unsigned int) cell.y * 19349663u);
+    return (int) (hash & (mBuckets.size() - 1));
+}
+
+bool PedsCrowdSolver::IsBuildingBlock(const glm::vec2& position, int mapLayer) const
+{
+    int mapx = (int) floorf(Convert::MetersToMapUnits(position.x));
+    int mapy = (int) floorf(Convert::MetersToMapUnits(position.y));
+
+    const MapBlockInfo* blockData = gGameMap.GetBlockInfo(mapx, mapy, mapLayer);
+    return (blockData->mGroundType == eGroundType_Building);
+}
+
+glm::vec2 PedsCrowdSolver::ClipByBuildings(const CrowdPed& crowdPed, const glm::vec2& displacement) const
+{
+    // ped which is already inside building is not restricted
+    if (IsBuildingBlock(crowdPed.mStartPosition, crowdPed.mMapLayer))
+        return displacement;
+
+    const float BlockSize = Convert::MapUnitsToMeters(1.0f);
+    const float Radius = gGameParams.mPedestrianBoundsSphereRadius;
+
+    glm::vec2 clippedDisplacement = displacement;
+    glm::vec2 position = crowdPed.mStartPosition;
+    // move along each axis separately so ped slides along building walls
+    for (int iaxis = 0; iaxis < 2; ++iaxis)
+    {
+        float distance = clippedDisplacement[iaxis];
+        if (distance == 0.0f)
+            continue;
+
+        float side = (distance > 0.0f) ? Radius : -Radius;
+        glm::vec2 probePosition = position;
+        probePosition[iaxis] += distance + side;
+        if (IsBuildingBlock(probePosition, crowdPed.mMapLayer))
+        {
+            // stop at block edge but never push ped back
+            float blockEdge = floorf(probePosition[iaxis] / BlockSize) * BlockSize;
+            if (distance < 0.0f)
+            {
+                blockEdge += BlockSize;
+            }
+            float allowedDistance = blockEdge - side - position[iaxis];
+            distance = (distance > 0.0f) ? glm::clamp(allowedDistance, 0.0f, distance) : glm::clamp(allowedDistance, distance, 0.0f);
+            clippedDisplacement[iaxis] = distance;
+        }
+        position[iaxis] += distance;
+    }
+    return clippedDisplacement;
+}
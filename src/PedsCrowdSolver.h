@@ -0,0 +1,52 @@
+#pragma once
+
+class PhysicsBody;
+class PedPhysicsBody;
+
+// Moves pedestrians on foot without involving physics engine contacts
+// Crowd pedestrians bodies are kinematic, physics world only integrates velocities computed by solver:
+// predicted positions are binned into spatial hash, overlapping pairs are pushed apart and resulting
+// displacement is clipped by building blocks, cars still collide with crowd pedestrians bodies
+class PedsCrowdSolver final: public cxx::noncopyable
+{
+public:
+    // readonly
+    int mPedsCount = 0; // pedestrians processed on last step
+    int mPairsCount = 0; // overlapping pairs resolved on last step
+
+public:
+    // Compute crowd pedestrians velocities, should be called before physics world step
+    // @param pedsBodies: Pedestrians physics bodies
+    // @param stepTime: Physics world step time
+    void SimulationStep(const std::vector<PhysicsBody*>& pedsBodies, float stepTime);
+
+    // Restore desired velocities of crowd pedestrians, should be called after physics world step
+    void RestoreVelocities();
+
+private:
+    struct CrowdPed
+    {
+        PedPhysicsBody* mPedBody = nullptr;
+        glm::vec2 mStartPosition;
+        glm::vec2 mPosition;
+        glm::vec2 mVelocity; // desired velocity
+        glm::vec2 mSolvedVelocity; // velocity for physics world step
+        Point mCell;
+        int mMapLayer = 0;
+        int mNextInBucket = -1;
+    };
+
+    void GatherPeds(const std::vector<PhysicsBody*>& pedsBodies, float stepTime);
+    void BuildSpatialHash();
+    void SolveOverlaps();
+    void ScatterPeds(float stepTime);
+
+    int GetBucketIndex(const Point& cell) const;
+    bool IsBuildingBlock(const glm::vec2& position, int mapLayer) const;
+    glm::vec2 ClipByBuildings(const CrowdPed& crowdPed, const glm::vec2& displacement) const;
+
+private:
+    std::vector<CrowdPed> mPeds;
+    std::vector<int> mBuckets; // first ped index in bucket or -1
+    float mCellSize = 0.0f;
+};
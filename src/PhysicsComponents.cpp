@@ -7,6 +7,7 @@
 #include "Explosion.h"
 #include "PhysicsManager.h"
 #include "TimeManager.h"
+#include "ParticleEffectsManager.h"
 #include "Box2D_Helpers.h"
 #include "CarnageGame.h"
 
@@ -244,6 +245,40 @@ PedPhysicsBody::PedPhysicsBody(b2World* physicsWorld, Pedestrian* object)
     debug_assert(b2fixture);
 }
 
+void PedPhysicsBody::SetPedsContactsEnabled(bool isEnabled)
+{
+    for (b2Fixture* currFixture = mPhysicsBody->GetFixtureList(); currFixture; currFixture = currFixture->GetNext())
+    {
+        b2Filter filterData = currFixture->GetFilterData();
+        if (filterData.categoryBits != PHYSICS_OBJCAT_PED)
+            continue;
+
+        // sensors of other peds are excluded as well, they only handle contacts with cars
+        const unsigned short PedsBits = PHYSICS_OBJCAT_PED | PHYSICS_OBJCAT_PED_SENSOR;
+        unsigned short maskBits = isEnabled ? (filterData.maskBits | PedsBits) : (filterData.maskBits & ~PedsBits);
+        if (filterData.maskBits == maskBits)
+            continue;
+
+        filterData.maskBits = maskBits;
+        currFixture->SetFilterData(filterData);
+    }
+}
+
+void PedPhysicsBody::SetCrowdMember(bool isCrowdMember)
+{
+    // changing body type resets its contacts, so do it only on actual change
+    b2BodyType bodyType = isCrowdMember ? b2_kinematicBody : b2_dynamicBody;
+    if (mPhysicsBody->GetType() != bodyType)
+    {
+        mPhysicsBody->SetType(bodyType);
+    }
+}
+
+bool PedPhysicsBody::IsCrowdMember() const
+{
+    return mPhysicsBody->GetType() == b2_kinematicBody;
+}
+
 void PedPhysicsBody::SimulationStep()
 {
     if (mReferencePed->mCurrentCar)
@@ -326,8 +361,7 @@ void PedPhysicsBody::HandleWaterContact()
         mFalling = false;
 
         // create effect
-        Decoration* splashEffect = gGameObjectsManager.CreateWaterSplash(GetPosition());
-        debug_assert(splashEffect);
+        gParticleEffects.EmitWaterSplash(GetPosition());
 
         mHeight -= Convert::MapUnitsToMeters(1.0f); // put it down
     }
@@ -421,30 +455,43 @@ void CarPhysicsBody::HandleWaterContact()
     splashPoints[4] = GetPosition2();
     for (const glm::vec2& currPoint: splashPoints)
     {
-        Decoration* splashEffect = gGameObjectsManager.CreateWaterSplash(glm::vec3(currPoint.x, mHeight, currPoint.y));
-        debug_assert(splashEffect);
+        gParticleEffects.EmitWaterSplash(glm::vec3(currPoint.x, mHeight, currPoint.y));
     }
     mHeight -= Convert::MapUnitsToMeters(1.0f); // put it down
 }
 
 void CarPhysicsBody::SimulationStep()
+{
+    UpdateDynamics();
+}
+
+CarPhysicsBody::DynamicsForces CarPhysicsBody::UpdateDynamics()
 {
     DriveCtlState currCtlState;
+    GetDriveCtlState(currCtlState);
 
-    if (!mReferenceCar->IsWrecked())
+    DynamicsForces forces;
+    UpdateFriction(currCtlState, forces);
+    UpdateDrive(currCtlState, forces);
+    UpdateSteer(currCtlState);
+
+    mPhysicsBody->ApplyForceToCenter(forces.mForce, true);
+    mPhysicsBody->ApplyTorque(forces.mTorque, true);
+    return forces;
+}
+
+void CarPhysicsBody::GetDriveCtlState(DriveCtlState& currCtlState) const
+{
+    if (mReferenceCar->IsWrecked())
+        return;
+
+    Pedestrian* carDriver = mReferenceCar->GetCarDriver();
+    if (carDriver)
     {
-        Pedestrian* carDriver = mReferenceCar->GetCarDriver();
-        if (carDriver)
-        {
-            currCtlState.mDriveDirection = carDriver->mCtlState.mAcceleration;
-            currCtlState.mSteerDirection = carDriver->mCtlState.mSteerDirection;
-            currCtlState.mHandBrake = carDriver->mCtlState.mHandBrake;
-        }
+        currCtlState.mDriveDirection = carDriver->mCtlState.mAcceleration;
+        currCtlState.mSteerDirection = carDriver->mCtlState.mSteerDirection;
+        currCtlState.mHandBrake = carDriver->mCtlState.mHandBrake;
     }
-
-    UpdateFriction(currCtlState);
-    UpdateDrive(currCtlState);
-    UpdateSteer(currCtlState);
 }
 
 bool CarPhysicsBody::ShouldContactWith(unsigned int objCatBits) const
@@ -577,8 +624,8 @@ void CarPhysicsBody::HandleFallEnd()
 
 void CarPhysicsBody::UpdateSteer(const DriveCtlState& currCtlState)
 {
-    const float LockAngleRadians = glm::radians(30.0f);
-    const float TurnSpeedPerSec = glm::radians(270.0f * 1.0f);
+    const float LockAngleRadians = glm::radians(SteerLockAngleDegrees);
+    const float TurnSpeedPerSec = glm::radians(SteerTurnSpeedDegrees);
 
     float turnPerTimeStep = (TurnSpeedPerSec * gTimeManager.mGameFrameDelta);
     float desiredAngle = (LockAngleRadians * currCtlState.mSteerDirection);
@@ -586,49 +633,49 @@ void CarPhysicsBody::UpdateSteer(const DriveCtlState& currCtlState)
     mSteeringAngleRadians = b2Clamp(mSteeringAngleRadians + angleToTurn, -LockAngleRadians, LockAngleRadians);
 }
 
-void CarPhysicsBody::UpdateFriction(const DriveCtlState& currCtlState)
+void CarPhysicsBody::UpdateFriction(const DriveCtlState& currCtlState, DynamicsForces& forces)
 {
     b2Vec2 linearVelocityVector = mPhysicsBody->GetLinearVelocity();
     float linearSpeed = linearVelocityVector.Normalize();
 
     // kill lateral velocity front tire
     {
-        b2Vec2 impulse = mPhysicsBody->GetMass() * 0.20f * -b2GetTireLateralVelocity(eCarTire_Front);
+        b2Vec2 impulse = mPhysicsBody->GetMass() * TireLateralImpulseFactor * -b2GetTireLateralVelocity(eCarTire_Front);
         mPhysicsBody->ApplyLinearImpulse(impulse, b2GetTirePos(eCarTire_Front), true);
     }
 
     // kill lateral velocity rear tire
     {
-        b2Vec2 impulse = mPhysicsBody->GetMass() * 0.20f * -b2GetTireLateralVelocity(eCarTire_Rear);
+        b2Vec2 impulse = mPhysicsBody->GetMass() * TireLateralImpulseFactor * -b2GetTireLateralVelocity(eCarTire_Rear);
         mPhysicsBody->ApplyLinearImpulse(impulse, b2GetTirePos(eCarTire_Rear), true);
     }
 
     // rolling resistance
     if (linearSpeed > 0.0f)
     {
-        float rrCoef = 520.0f;
-        mPhysicsBody->ApplyForce(rrCoef * -linearVelocityVector, b2GetTirePos(eCarTire_Front), true);
-        mPhysicsBody->ApplyForce(rrCoef * -linearVelocityVector, b2GetTirePos(eCarTire_Rear), true);
+        float rrCoef = RollingResistanceCoef;
+        AddForce(rrCoef * -linearVelocityVector, b2GetTirePos(eCarTire_Front), forces);
+        AddForce(rrCoef * -linearVelocityVector, b2GetTirePos(eCarTire_Rear), forces);
     }
 
     // apply drag force
     if (linearSpeed > 0.0f)
     {
-        float dragForceCoef = 102.0f;
+        float dragForceCoef = DragForceCoef;
         b2Vec2 dragForce = -dragForceCoef * linearSpeed * linearVelocityVector;
 
-        mPhysicsBody->ApplyForceToCenter(dragForce, true);
+        forces.mForce += dragForce;
     }
 }
 
-void CarPhysicsBody::UpdateDrive(const DriveCtlState& currCtlState)
+void CarPhysicsBody::UpdateDrive(const DriveCtlState& currCtlState, DynamicsForces& forces)
 {
     if (currCtlState.mDriveDirection == 0.0f)
         return;
 
-    float driveForce = 6750.0f;
+    float driveForce = DriveForce;
     float brakeForce = driveForce * mCarDesc->mHandbrakeFriction;
-    float reverseForce = driveForce * 0.75f;
+    float reverseForce = driveForce * ReverseForceFactor;
 
     float currentSpeed = GetCurrentSpeed();
     float engineForce = 0.0f;
@@ -650,7 +697,13 @@ void CarPhysicsBody::UpdateDrive(const DriveCtlState& currCtlState)
     }
 
     b2Vec2 F = engineForce * currCtlState.mDriveDirection * b2GetTireForward(eCarTire_Rear);
-    mPhysicsBody->ApplyForce(F, b2GetTirePos(eCarTire_Rear), true);
+    AddForce(F, b2GetTirePos(eCarTire_Rear), forces);
+}
+
+void CarPhysicsBody::AddForce(const b2Vec2& force, const b2Vec2& point, DynamicsForces& forces) const
+{
+    forces.mForce += force;
+    forces.mTorque += b2Cross(point - mPhysicsBody->GetWorldCenter(), force);
 }
 
 b2Vec2 CarPhysicsBody::b2GetTireLateralVelocity(eCarTire tireID) const
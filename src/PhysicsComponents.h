@@ -113,6 +113,7 @@ protected:
 class PedPhysicsBody: public PhysicsBody
 {
     friend class PhysicsManager;
+    friend class PedsCrowdSolver;
 
 public:
     // readonly
@@ -132,6 +133,15 @@ public:
     void HandleCarContactBegin();
     void HandleCarContactEnd();
     void HandleWaterContact();
+
+    // Enable or disable contacts with other pedestrians bodies in physics world
+    // @param isEnabled: Flag
+    void SetPedsContactsEnabled(bool isEnabled);
+
+    // Switch body to kinematic while pedestrian is moved by crowd solver or back to dynamic
+    // @param isCrowdMember: Flag
+    void SetCrowdMember(bool isCrowdMember);
+    bool IsCrowdMember() const;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -147,6 +157,7 @@ enum eCarTire
 class CarPhysicsBody: public PhysicsBody
 {
     friend class PhysicsManager;
+    friend class CarPhysicsBatch;
 
 public:
     // readonly
@@ -187,9 +198,32 @@ private:
         bool mHandBrake = false;
     };
 
+    // dynamics coefficients, same values are used by batched implementation
+    static constexpr float TireLateralImpulseFactor = 0.20f;
+    static constexpr float RollingResistanceCoef = 520.0f;
+    static constexpr float DragForceCoef = 102.0f;
+    static constexpr float DriveForce = 6750.0f;
+    static constexpr float ReverseForceFactor = 0.75f;
+    static constexpr float SteerLockAngleDegrees = 30.0f;
+    static constexpr float SteerTurnSpeedDegrees = 270.0f; // per second
+
+    // forces of single simulation step, they are summed up and applied to body at once
+    struct DynamicsForces
+    {
+        b2Vec2 mForce = b2Vec2(0.0f, 0.0f); // at center of mass
+        float mTorque = 0.0f; // about center of mass
+    };
+
+    // Process tires friction, drive and steering for current simulation step
+    // @returns Forces applied to body
+    DynamicsForces UpdateDynamics();
+
+    void GetDriveCtlState(DriveCtlState& currCtlState) const;
     void UpdateSteer(const DriveCtlState& currCtlState);
-    void UpdateFriction(const DriveCtlState& currCtlState);
-    void UpdateDrive(const DriveCtlState& currCtlState);
+    // tires impulses are applied immediately, forces are accumulated
+    void UpdateFriction(const DriveCtlState& currCtlState, DynamicsForces& forces);
+    void UpdateDrive(const DriveCtlState& currCtlState, DynamicsForces& forces);
+    void AddForce(const b2Vec2& force, const b2Vec2& point, DynamicsForces& forces) const;
 
     // helpers, world space
     b2Vec2 b2GetTireLateralVelocity(eCarTire tireID) const;
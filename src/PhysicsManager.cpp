@@ -62,7 +62,7 @@ PhysicsManager::PhysicsManager()
 {
 }
 
-bool PhysicsManager::InitPhysicsWorld()
+bool PhysicsManager::InitPhysicsWorld(const std::vector<Point>& mapCollisionBlocks)
 {
     b2Vec2 gravity {0.0f, 0.0f}; // default gravity shoild be disabled
     mPhysicsWorld = new b2World(gravity);
@@ -70,8 +70,9 @@ bool PhysicsManager::InitPhysicsWorld()
 
     mSimulationStepTime = 1.0f / std::max(gSystem.mConfig.mPhysicsFramerate, 1.0f);
     mGravity = Convert::MapUnitsToMeters(0.5f);
+    mCarsBatchSelfCheckSteps = CarsBatchSelfCheckSteps;
 
-    CreateMapCollisionShape();
+    CreateMapCollisionShape(mapCollisionBlocks);
     return true;
 }
 
@@ -102,6 +103,21 @@ void PhysicsManager::ProcessSimulationStep()
     const int velocityIterations = 6;
     const int positionIterations = 2;
 
+    // crowd solver replaces contacts between pedestrians
+    if (mPedsContactsEnabled == mPedsCrowdSolver)
+    {
+        mPedsContactsEnabled = !mPedsCrowdSolver;
+        for (PhysicsBody* currComponent: mPedsBodiesList)
+        {
+            PedPhysicsBody* pedBody = static_cast<PedPhysicsBody*>(currComponent);
+            pedBody->SetPedsContactsEnabled(mPedsContactsEnabled);
+            if (mPedsContactsEnabled)
+            {
+                pedBody->SetCrowdMember(false);
+            }
+        }
+    }
+
     // get previous position
     for (PhysicsBody* currComponent: mCarsBodiesList)
     {
@@ -119,12 +135,60 @@ void PhysicsManager::ProcessSimulationStep()
         currComponent->mPreviousRotation = currComponent->mSmoothRotation = currComponent->GetRotationAngle();
     }
 
+    // crowd pedestrians are kinematic bodies, world step only moves them with velocities computed by solver
+    float crowdSolverTime = 0.0f;
+    if (mPedsCrowdSolver)
+    {
+        double crowdSolverStartTime = gSystem.GetSystemSeconds();
+        mCrowdSolver.SimulationStep(mPedsBodiesList, mSimulationStepTime);
+        crowdSolverTime = (float) ((gSystem.GetSystemSeconds() - crowdSolverStartTime) * 1000.0);
+    }
+    mCrowdSolverTime = glm::mix(mCrowdSolverTime, crowdSolverTime, 0.05f);
+
+    double worldStepStartTime = gSystem.GetSystemSeconds();
     mPhysicsWorld->Step(mSimulationStepTime, velocityIterations, positionIterations);
+    float worldStepTime = (float) ((gSystem.GetSystemSeconds() - worldStepStartTime) * 1000.0);
+    mWorldStepTime = glm::mix(mWorldStepTime, worldStepTime, 0.05f);
 
-    // process physics components
-    for (size_t i = 0, NumElements = mCarsBodiesList.size(); i < NumElements; ++i)
+    if (mPedsCrowdSolver)
+    {
+        mCrowdSolver.RestoreVelocities();
+    }
+
+    // process physics components, batched cars dynamics is not trusted until it matches per car processing
+    bool carsBatchSelfCheck = mBatchedCarsDynamics && (mCarsBatchSelfCheckSteps > 0) && !mCarsBodiesList.empty();
+    if (mValidateCarsDynamics || carsBatchSelfCheck)
     {
-        mCarsBodiesList[i]->SimulationStep();
+        float maxError = 0.0f;
+        int mismatchCount = mCarsBatch.ValidationStep(mCarsBodiesList, gTimeManager.mGameFrameDelta, maxError);
+        if (mValidateCarsDynamics)
+        {
+            gConsole.LogMessage(mismatchCount > 0 ? eLogMessage_Warning : eLogMessage_Info,
+                "Batched cars dynamics validation: %d cars, %d mismatches, max error %f", (int) mCarsBodiesList.size(), mismatchCount, maxError);
+            mValidateCarsDynamics = false;
+        }
+        if (carsBatchSelfCheck)
+        {
+            --mCarsBatchSelfCheckSteps;
+            if (mismatchCount > 0)
+            {
+                gConsole.LogMessage(eLogMessage_Warning,
+                    "Batched cars dynamics self check failed: %d mismatches, max error %f, batch is turned off", mismatchCount, maxError);
+                mBatchedCarsDynamics = false;
+                mCarsBatchSelfCheckSteps = 0;
+            }
+        }
+    }
+    else if (mBatchedCarsDynamics)
+    {
+        mCarsBatch.SimulationStep(mCarsBodiesList, gTimeManager.mGameFrameDelta);
+    }
+    else
+    {
+        for (size_t i = 0, NumElements = mCarsBodiesList.size(); i < NumElements; ++i)
+        {
+            mCarsBodiesList[i]->SimulationStep();
+        }
     }
     for (size_t i = 0, NumElements = mPedsBodiesList.size(); i < NumElements; ++i)
     {
@@ -167,6 +231,10 @@ PedPhysicsBody* PhysicsManager::CreatePhysicsObject(Pedestrian* object, const gl
 
     PedPhysicsBody* physicsObject = mPedsBodiesPool.create(mPhysicsWorld, object);
     physicsObject->SetPosition(position, rotationAngle);
+    if (!mPedsContactsEnabled)
+    {
+        physicsObject->SetPedsContactsEnabled(false);
+    }
 
     mPedsBodiesList.push_back(physicsObject);
     return physicsObject;
@@ -195,20 +263,15 @@ ProjectilePhysicsBody* PhysicsManager::CreatePhysicsObject(Projectile* object, c
     return physicsObject;
 }
 
-void PhysicsManager::CreateMapCollisionShape()
+void PhysicsManager::PrepareMapCollisionBlocks(const GameMapManager& gameMap, std::vector<Point>& collisionBlocks)
 {
-    b2BodyDef bodyDef;
-    bodyDef.type = b2_staticBody;
+    collisionBlocks.clear();
 
-    mMapCollisionShape = mPhysicsWorld->CreateBody(&bodyDef);
-
-    int numFixtures = 0;
-    // for each block create fixture
     for (int x = 0; x < MAP_DIMENSIONS; ++x)
     for (int y = 0; y < MAP_DIMENSIONS; ++y)
     for (int layer = 0; layer < MAP_LAYERS_COUNT; ++layer)
     {
-        const MapBlockInfo* blockData = gGameMap.GetBlockInfo(x, y, layer);
+        const MapBlockInfo* blockData = gameMap.GetBlockInfo(x, y, layer);
         debug_assert(blockData);
 
         if (blockData->mGroundType != eGroundType_Building)
@@ -216,10 +279,10 @@ void PhysicsManager::CreateMapCollisionShape()
 
         // checek blox is inner
         {
-            const MapBlockInfo* neighbourE = gGameMap.GetBlockInfo(x + 1, y, layer); 
-            const MapBlockInfo* neighbourW = gGameMap.GetBlockInfo(x - 1, y, layer); 
-            const MapBlockInfo* neighbourN = gGameMap.GetBlockInfo(x, y - 1, layer); 
-            const MapBlockInfo* neighbourS = gGameMap.GetBlockInfo(x, y + 1, layer);
+            const MapBlockInfo* neighbourE = gameMap.GetBlockInfo(x + 1, y, layer); 
+            const MapBlockInfo* neighbourW = gameMap.GetBlockInfo(x - 1, y, layer); 
+            const MapBlockInfo* neighbourN = gameMap.GetBlockInfo(x, y - 1, layer); 
+            const MapBlockInfo* neighbourS = gameMap.GetBlockInfo(x, y + 1, layer);
 
             auto is_walkable = [](eGroundType gtype)
             {
@@ -233,6 +296,24 @@ void PhysicsManager::CreateMapCollisionShape()
             }
         }
 
+        collisionBlocks.emplace_back(x, y);
+        break; // single fixture per block column
+    }
+}
+
+void PhysicsManager::CreateMapCollisionShape(const std::vector<Point>& mapCollisionBlocks)
+{
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_staticBody;
+
+    mMapCollisionShape = mPhysicsWorld->CreateBody(&bodyDef);
+
+    // for each block create fixture
+    for (const Point& currBlock: mapCollisionBlocks)
+    {
+        int x = currBlock.x;
+        int y = currBlock.y;
+
         b2PolygonShape b2shapeDef;
 
         box2d::vec2 shapeCenter (x + 0.5f, y + 0.5f);
@@ -255,9 +336,6 @@ void PhysicsManager::CreateMapCollisionShape()
 
         b2Fixture* b2fixture = mMapCollisionShape->CreateFixture(&b2fixtureDef);
         debug_assert(b2fixture);
-
-        ++numFixtures;
-        break; // single fixture per block column
     }
 }
 
@@ -381,6 +459,18 @@ void PhysicsManager::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
                 CarPhysicsBody* car = CastFixtureBody<CarPhysicsBody>(fixtureCar);
                 hasCollision = ped->ShouldContactWith(PHYSICS_OBJCAT_CAR) &&
                     HasCollisionPedVsCar(contact, ped, car);
+
+                // crowd pedestrian body is not pushed by car, it becomes dynamic on next step
+                if (hasCollision && ped->IsCrowdMember())
+                {
+                    b2WorldManifold wmanifold;
+                    contact->GetWorldManifold(&wmanifold);
+
+                    b2Vec2 relativeVelocity = car->mPhysicsBody->GetLinearVelocity() - ped->mPhysicsBody->GetLinearVelocity();
+                    float contactImpulse = car->mPhysicsBody->GetMass() * fabsf(b2Dot(relativeVelocity, wmanifold.normal));
+                    HandleCollision(contact, ped, car, contactImpulse);
+                    hasCollision = false;
+                }
             }
         }
         // car vs map solid block
@@ -721,6 +811,11 @@ void PhysicsManager::HandleCollision(b2Contact* contact, PedPhysicsBody* ped, Ca
         maxImpulse = b2Max(maxImpulse, impulse->normalImpulses[i]);
     }
 
+    HandleCollision(contact, ped, car, maxImpulse);
+}
+
+void PhysicsManager::HandleCollision(b2Contact* contact, PedPhysicsBody* ped, CarPhysicsBody* car, float contactImpulse)
+{
     b2WorldManifold wmanifold;
     contact->GetWorldManifold(&wmanifold);
 
@@ -729,7 +824,7 @@ void PhysicsManager::HandleCollision(b2Contact* contact, PedPhysicsBody* ped, Ca
     DamageInfo damageInfo;
     damageInfo.mDamageCause = eDamageCause_CarCrash;
     damageInfo.mSourceObject = car->mReferenceCar;
-    damageInfo.mContactImpulse = maxImpulse;
+    damageInfo.mContactImpulse = contactImpulse;
     damageInfo.mContactPoint = glm::vec3 ( contactPoint.x, ped->mHeight, contactPoint.y );
 
     ped->mReferencePed->ReceiveDamage(damageInfo);
@@ -3,16 +3,37 @@
 #include "PhysicsDefs.h"
 #include "GameDefs.h"
 #include "PhysicsComponents.h"
+#include "CarPhysicsBatch.h"
+#include "PedsCrowdSolver.h"
+
+class GameMapManager;
 
 // note that the physics only works with meter units (Mt) rather then map units
 
 // this class manages physics and collision detections for map and objects
 class PhysicsManager final: private b2ContactListener
 {
+public:
+    bool mBatchedCarsDynamics = true; // process all cars with single batch instead of one by one, turned off if self check fails
+    bool mValidateCarsDynamics = false; // compare batched and per car results on next simulation step, gets reset after
+    bool mPedsCrowdSolver = false; // move pedestrians on foot with crowd solver, their bodies are kinematic in physics world
+
+    // readonly
+    PedsCrowdSolver mCrowdSolver;
+    float mWorldStepTime = 0.0f; // physics world step smoothed over recent steps, milliseconds
+    float mCrowdSolverTime = 0.0f; // crowd solver step smoothed over recent steps, milliseconds
+
 public:
     PhysicsManager();
 
-    bool InitPhysicsWorld();
+    // Find map blocks which require collision shapes, does not access physics world so it could be called from worker thread
+    // @param gameMap: Source map data
+    // @param collisionBlocks: Output map columns coordinates
+    static void PrepareMapCollisionBlocks(const GameMapManager& gameMap, std::vector<Point>& collisionBlocks);
+
+    // Create physics world with map collision shape
+    // @param mapCollisionBlocks: Prepared map blocks
+    bool InitPhysicsWorld(const std::vector<Point>& mapCollisionBlocks);
     void FreePhysicsWorld();
 
     void UpdateFrame();
@@ -51,7 +72,7 @@ public:
 
 private:
     // create level map body, used internally
-    void CreateMapCollisionShape();
+    void CreateMapCollisionShape(const std::vector<Point>& mapCollisionBlocks);
 
     // apply gravity forces and correct y coord for objects
     void ProcessGravityStep();
@@ -80,11 +101,15 @@ private:
 
     // post solve collisions
     void HandleCollision(b2Contact* contact, PedPhysicsBody* ped, CarPhysicsBody* car, const b2ContactImpulse* impulse);
+    void HandleCollision(b2Contact* contact, PedPhysicsBody* ped, CarPhysicsBody* car, float contactImpulse);
     void HandleCollision(b2Contact* contact, CarPhysicsBody* carA, CarPhysicsBody* carB, const b2ContactImpulse* impulse);
 
     // sensors
     bool ProcessSensorContact(b2Contact* contact, bool onBegin);
 
+private:
+    static const int CarsBatchSelfCheckSteps = 120;
+
 private:
     b2Body* mMapCollisionShape;
     b2World* mPhysicsWorld;
@@ -103,6 +128,10 @@ private:
     std::vector<PhysicsBody*> mPedsBodiesList;
     std::vector<PhysicsBody*> mCarsBodiesList;
     std::vector<PhysicsBody*> mProjectileBodiesList;
+
+    CarPhysicsBatch mCarsBatch;
+    int mCarsBatchSelfCheckSteps = 0; // batched results are compared with per car results during first steps with cars
+    bool mPedsContactsEnabled = true; // current state of pedestrians bodies filters
 };
 
 extern PhysicsManager gPhysics;
\ No newline at end of file
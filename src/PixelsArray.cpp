@@ -12,7 +12,8 @@
 #define STBI_NO_PIC
 #define STBI_NO_PNM
 
-static cxx::memory_allocator* gPixelsArrayAllocator = nullptr;
+// bitmaps could be decoded on worker threads
+static thread_local cxx::memory_allocator* gPixelsArrayAllocator = nullptr;
 
 inline void* stbi_malloc_proxy(size_t dataLength)
 {
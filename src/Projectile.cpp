@@ -7,6 +7,7 @@
 #include "DebugRenderer.h"
 #include "GameObjectsManager.h"
 #include "AudioManager.h"
+#include "ParticleEffectsManager.h"
 
 Projectile::Projectile(WeaponInfo* weaponInfo, Pedestrian* shooter) 
     : GameObject(eGameObjectClass_Projectile, GAMEOBJECT_ID_NULL)
@@ -109,15 +110,7 @@ void Projectile::UpdateFrame()
 
     if (mWeaponInfo->mProjectileHitEffect > GameObjectType_Null)
     {
-        GameObjectInfo& objectInfo = gGameMap.mStyleData.mObjects[mWeaponInfo->mProjectileHitEffect];
-        Decoration* hitEffect = gGameObjectsManager.CreateDecoration(mPhysicsBody->mContactPoint, cxx::angle_t(), &objectInfo);
-        debug_assert(hitEffect);
-
-        if (hitEffect)
-        {
-            hitEffect->SetDrawOrder(eSpriteDrawOrder_Projectiles);
-            hitEffect->SetLifeDuration(1);
-        }
+        gParticleEffects.EmitHitEffect(mWeaponInfo->mProjectileHitEffect, mPhysicsBody->mContactPoint);
     }
 
     if (mWeaponInfo->mProjectileHitObjectSound != -1)
@@ -0,0 +1,188 @@
+#include "stdafx.h"
+#include "RenderBenchmark.h"
+#include "CarnageGame.h"
+#include "RenderingManager.h"
+#include "TimeManager.h"
+
+static const char* ReportFilePath = "render_benchmark.csv";
+
+RenderBenchmark gRenderBenchmark;
+
+bool RenderBenchmark::Start(int framesCount, bool quitOnComplete)
+{
+    if (IsRunning())
+    {
+        Stop();
+    }
+
+    HumanPlayer* humanPlayer = gCarnageGame.mHumanPlayers[0];
+    if (humanPlayer == nullptr || framesCount < 1)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot start render benchmark");
+        return false;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Render benchmark started (%d frames)", framesCount);
+
+    mPlayerView = &humanPlayer->mPlayerView;
+    mQuitOnComplete = quitOnComplete;
+    mFramesCount = framesCount;
+    mFrameIndex = 0;
+    mFramebufferHash = 0;
+    mFrames.clear();
+    mFrames.reserve(framesCount);
+
+    // freeze world and remove framerate limit
+    mPrevGameTimeScale = gTimeManager.mGameTimeScale;
+    mPrevMaxFramerate = gTimeManager.mMaxFramerate;
+    gTimeManager.SetGameTimeScale(0.0f);
+    gTimeManager.SetMaxFramerate(10000.0f);
+
+    mPlayerView->SetCameraController(&mPlayerView->mFreeLookCameraController);
+    UpdateFrame();
+    return true;
+}
+
+void RenderBenchmark::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    gTimeManager.SetGameTimeScale(mPrevGameTimeScale);
+    gTimeManager.SetMaxFramerate(mPrevMaxFramerate);
+
+    mPlayerView->SetCameraController(&mPlayerView->mFollowCameraController);
+    mPlayerView = nullptr;
+}
+
+void RenderBenchmark::UpdateFrame()
+{
+    if (!IsRunning())
+        return;
+
+    int measuredFrame = std::max(mFrameIndex - WarmupFramesCount, 0);
+    float pathProgress = (mFramesCount > 1) ? (measuredFrame * 1.0f) / (mFramesCount - 1) : 0.0f;
+    mPlayerView->mCamera.SetPosition(GetCameraPosition(pathProgress));
+    // player view has already been updated this frame, so visible area must follow new camera position
+    mPlayerView->mOnScreenArea = mPlayerView->mCamera.ComputeViewBounds2();
+}
+
+void RenderBenchmark::CaptureFrame()
+{
+    if (!IsRunning())
+        return;
+
+    double currentTimestamp = gSystem.GetSystemSeconds();
+    if (mFrameIndex >= WarmupFramesCount)
+    {
+        const MapRenderStats& renderStats = gRenderManager.mMapRenderer.mRenderStats;
+
+        FrameRecord& frameRecord = mFrames.emplace_back();
+        frameRecord.mFrameTime = (float) ((currentTimestamp - mLastFrameTimestamp) * 1000.0);
+        frameRecord.mDrawCalls = gGraphicsDevice.mFrameCounters.mDrawCalls;
+        frameRecord.mSpritesDrawn = renderStats.mSpritesDrawnCount;
+        frameRecord.mBlockChunksDrawn = renderStats.mBlockChunksDrawnCount;
+    }
+    mLastFrameTimestamp = currentTimestamp;
+    ++mFrameIndex;
+
+    if ((int) mFrames.size() == mFramesCount)
+    {
+        Complete();
+    }
+}
+
+void RenderBenchmark::Complete()
+{
+    // hash final frame, fnv-1a
+    mFramebufferHash = 2166136261U;
+    if (gGraphicsDevice.ReadScreenPixels(gGraphicsDevice.mViewportRect, mFramebufferPixels))
+    {
+        for (unsigned char currByte: mFramebufferPixels)
+        {
+            mFramebufferHash = (mFramebufferHash ^ currByte) * 16777619U;
+        }
+    }
+
+    WriteReport();
+
+    bool quitOnComplete = mQuitOnComplete;
+    Stop();
+
+    if (quitOnComplete)
+    {
+        gSystem.QuitRequest();
+    }
+}
+
+void RenderBenchmark::WriteReport() const
+{
+    if (mFrames.empty())
+        return;
+
+    std::vector<float> frameTimes;
+    frameTimes.reserve(mFrames.size());
+
+    double totalDrawCalls = 0.0;
+    double totalSprites = 0.0;
+    for (const FrameRecord& currFrame: mFrames)
+    {
+        frameTimes.push_back(currFrame.mFrameTime);
+        totalDrawCalls += currFrame.mDrawCalls;
+        totalSprites += currFrame.mSpritesDrawn;
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    int framesCount = (int) frameTimes.size();
+    double totalFrameTime = 0.0;
+    for (float currFrameTime: frameTimes)
+    {
+        totalFrameTime += currFrameTime;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Render benchmark complete, %d frames", framesCount);
+    gConsole.LogMessage(eLogMessage_Info, "Frame time avg: %.3f ms, min: %.3f ms, p95: %.3f ms, max: %.3f ms",
+        totalFrameTime / framesCount, frameTimes.front(), frameTimes[(framesCount * 95) / 100], frameTimes.back());
+    gConsole.LogMessage(eLogMessage_Info, "Draw calls avg: %.1f, sprites avg: %.1f",
+        totalDrawCalls / framesCount, totalSprites / framesCount);
+    gConsole.LogMessage(eLogMessage_Info, "Framebuffer hash: %08x", mFramebufferHash);
+
+    std::ofstream outstream (ReportFilePath, std::ios::out | std::ios::trunc);
+    if (!outstream.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot write render benchmark report '%s'", ReportFilePath);
+        return;
+    }
+
+    outstream << "frame,frame_time_ms,draw_calls,sprites,block_chunks" << std::endl;
+    for (int iframe = 0; iframe < framesCount; ++iframe)
+    {
+        const FrameRecord& currFrame = mFrames[iframe];
+        outstream << iframe << "," << currFrame.mFrameTime << "," << currFrame.mDrawCalls << "," <<
+            currFrame.mSpritesDrawn << "," << currFrame.mBlockChunksDrawn << std::endl;
+    }
+    outstream << "# framebuffer_hash," << cxx::va("%08x", mFramebufferHash) << std::endl;
+}
+
+glm::vec3 RenderBenchmark::GetCameraPosition(float pathProgress) const
+{
+    // sweep map in several passes changing direction each time
+    const int PassesCount = 4;
+    const float CameraHeight = 32.0f;
+    const float MapSize = Convert::MapUnitsToMeters(MAP_DIMENSIONS * 1.0f);
+    const float MapMargin = Convert::MapUnitsToMeters(16.0f);
+
+    float passPosition = glm::clamp(pathProgress, 0.0f, 1.0f) * PassesCount;
+    int passIndex = std::min((int) passPosition, PassesCount - 1);
+    float passProgress = passPosition - passIndex;
+    if (passIndex % 2)
+    {
+        passProgress = 1.0f - passProgress;
+    }
+
+    float sweepLength = MapSize - MapMargin * 2.0f;
+    return glm::vec3(
+        MapMargin + sweepLength * passProgress,
+        CameraHeight,
+        MapMargin + sweepLength * ((passIndex + 0.5f) / PassesCount));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+class HumanPlayerView;
+
+// Measures rendering performance by flying camera over loaded map along fixed path
+// Game time is paused while benchmark is running so frames are reproducible, which allows to compare
+// hash of final frame between runs
+class RenderBenchmark final: public cxx::noncopyable
+{
+public:
+    static const int WarmupFramesCount = 10; // not measured
+
+public:
+    // Start benchmark in current scenario, first human player view is used
+    // @param framesCount: Number of measured frames
+    // @param quitOnComplete: Request application quit when benchmark completes
+    bool Start(int framesCount, bool quitOnComplete);
+
+    // Abort current benchmark without report
+    void Stop();
+
+    // Move camera along benchmark path, called before frame rendering
+    void UpdateFrame();
+
+    // Collect frame counters, called when game views are rendered but before gui
+    void CaptureFrame();
+
+    inline bool IsRunning() const { return mPlayerView != nullptr; }
+
+private:
+    // measured frame counters
+    struct FrameRecord
+    {
+        float mFrameTime; // milliseconds
+        int mDrawCalls;
+        int mSpritesDrawn;
+        int mBlockChunksDrawn;
+    };
+
+private:
+    void Complete();
+    void WriteReport() const;
+    glm::vec3 GetCameraPosition(float pathProgress) const;
+
+private:
+    HumanPlayerView* mPlayerView = nullptr;
+    bool mQuitOnComplete = false;
+
+    int mFramesCount = 0; // measured frames
+    int mFrameIndex = 0; // including warmup frames
+    double mLastFrameTimestamp = 0.0;
+    unsigned int mFramebufferHash = 0; // hash of final frame pixels
+
+    std::vector<FrameRecord> mFrames;
+    std::vector<unsigned char> mFramebufferPixels;
+
+    // settings to restore after benchmark
+    float mPrevGameTimeScale = 1.0f;
+    float mPrevMaxFramerate = 0.0f;
+};
+
+extern RenderBenchmark gRenderBenchmark;
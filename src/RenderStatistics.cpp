@@ -0,0 +1,223 @@
+#include "stdafx.h"
+#include "RenderStatistics.h"
+
+RenderStatistics::RenderStatistics()
+{
+    for (int& currQueryIndex: mOpenPassQueries)
+    {
+        currQueryIndex = -1;
+    }
+}
+
+void RenderStatistics::Deinit()
+{
+    StopRecording();
+
+    for (FrameQueries& currFrame: mFrameQueries)
+    {
+        for (PassQuery& currQuery: currFrame.mPassQueries)
+        {
+            gGraphicsDevice.DestroyTimestampQuery(currQuery.mStartQuery);
+            gGraphicsDevice.DestroyTimestampQuery(currQuery.mEndQuery);
+        }
+        currFrame.mPassQueries.clear();
+        currFrame.mPassQueriesCount = 0;
+        currFrame.mPending = false;
+    }
+
+    for (int& currQueryIndex: mOpenPassQueries)
+    {
+        currQueryIndex = -1;
+    }
+}
+
+void RenderStatistics::FrameBegin(int viewsCount)
+{
+    ++mFrameIndex;
+    mFrameStartTime = gSystem.GetSystemSeconds();
+
+    mViewCounters.resize(viewsCount);
+
+    // reuse oldest queries, results must be available at this point
+    mCurrentFrameQueries = (mCurrentFrameQueries + 1) % GpuTimersLatency;
+
+    FrameQueries& frameQueries = mFrameQueries[mCurrentFrameQueries];
+    ResolveGpuTimers(frameQueries);
+
+    frameQueries.mFrameIndex = mFrameIndex;
+    frameQueries.mPassQueriesCount = 0;
+    frameQueries.mPending = false;
+
+    for (int& currQueryIndex: mOpenPassQueries)
+    {
+        currQueryIndex = -1;
+    }
+}
+
+void RenderStatistics::FrameEnd()
+{
+    mCpuFrameTime = (float) ((gSystem.GetSystemSeconds() - mFrameStartTime) * 1000.0);
+    mFrameCounters = gGraphicsDevice.mFrameCounters;
+
+    if (IsRecording())
+    {
+        WriteRecordFrame();
+    }
+}
+
+void RenderStatistics::BeginView(int viewIndex)
+{
+    debug_assert(viewIndex < (int) mViewCounters.size());
+
+    mViewStartCounters = gGraphicsDevice.mFrameCounters;
+}
+
+void RenderStatistics::EndView(int viewIndex)
+{
+    debug_assert(viewIndex < (int) mViewCounters.size());
+
+    mViewCounters[viewIndex] = gGraphicsDevice.mFrameCounters - mViewStartCounters;
+}
+
+void RenderStatistics::BeginPass(eRenderPass renderPass)
+{
+    debug_assert(renderPass < eRenderPass_COUNT);
+    if (!mGpuTimersEnabled)
+        return;
+
+    FrameQueries& frameQueries = mFrameQueries[mCurrentFrameQueries];
+    if (frameQueries.mPassQueriesCount == (int) frameQueries.mPassQueries.size())
+    {
+        PassQuery passQuery;
+        passQuery.mStartQuery = gGraphicsDevice.CreateTimestampQuery();
+        passQuery.mEndQuery = gGraphicsDevice.CreateTimestampQuery();
+        if (passQuery.mStartQuery == 0 || passQuery.mEndQuery == 0)
+        {
+            gGraphicsDevice.DestroyTimestampQuery(passQuery.mStartQuery);
+            gGraphicsDevice.DestroyTimestampQuery(passQuery.mEndQuery);
+
+            gConsole.LogMessage(eLogMessage_Warning, "Gpu timers are not supported");
+            mGpuTimersEnabled = false;
+            return;
+        }
+        frameQueries.mPassQueries.push_back(passQuery);
+    }
+
+    int queryIndex = frameQueries.mPassQueriesCount++;
+
+    PassQuery& passQuery = frameQueries.mPassQueries[queryIndex];
+    passQuery.mRenderPass = renderPass;
+    gGraphicsDevice.IssueTimestampQuery(passQuery.mStartQuery);
+
+    mOpenPassQueries[renderPass] = queryIndex;
+}
+
+void RenderStatistics::EndPass(eRenderPass renderPass)
+{
+    debug_assert(renderPass < eRenderPass_COUNT);
+
+    int queryIndex = mOpenPassQueries[renderPass];
+    if (queryIndex == -1)
+        return;
+
+    FrameQueries& frameQueries = mFrameQueries[mCurrentFrameQueries];
+    gGraphicsDevice.IssueTimestampQuery(frameQueries.mPassQueries[queryIndex].mEndQuery);
+    frameQueries.mPending = true;
+
+    mOpenPassQueries[renderPass] = -1;
+}
+
+void RenderStatistics::ResolveGpuTimers(FrameQueries& frameQueries)
+{
+    if (!frameQueries.mPending)
+        return;
+
+    unsigned long long passTime[eRenderPass_COUNT] = {};
+    for (int iquery = 0; iquery < frameQueries.mPassQueriesCount; ++iquery)
+    {
+        const PassQuery& passQuery = frameQueries.mPassQueries[iquery];
+
+        unsigned long long startTimestamp = 0;
+        unsigned long long endTimestamp = 0;
+        if (!gGraphicsDevice.GetTimestampQueryResult(passQuery.mStartQuery, startTimestamp) ||
+            !gGraphicsDevice.GetTimestampQueryResult(passQuery.mEndQuery, endTimestamp))
+        {
+            return; // gpu is too far behind, skip frame
+        }
+
+        if (endTimestamp > startTimestamp)
+        {
+            passTime[passQuery.mRenderPass] += (endTimestamp - startTimestamp);
+        }
+    }
+
+    for (int ipass = 0; ipass < eRenderPass_COUNT; ++ipass)
+    {
+        mGpuPassTime[ipass] = (float) (passTime[ipass] / 1000000.0);
+    }
+    mGpuTimersFrame = frameQueries.mFrameIndex;
+}
+
+bool RenderStatistics::StartRecording(const std::string& filePath)
+{
+    StopRecording();
+
+    mRecordFile.open(filePath, std::ios::out | std::ios::trunc);
+    if (!mRecordFile.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot create render stats file '%s'", filePath.c_str());
+        return false;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Render stats recording started '%s'", filePath.c_str());
+    WriteRecordHeader();
+    return true;
+}
+
+void RenderStatistics::StopRecording()
+{
+    if (!IsRecording())
+        return;
+
+    mRecordFile.close();
+    gConsole.LogMessage(eLogMessage_Info, "Render stats recording stopped");
+}
+
+bool RenderStatistics::IsGpuTimersSupported() const
+{
+    return gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_TimerQuery];
+}
+
+void RenderStatistics::WriteRecordHeader()
+{
+    mRecordFile << "frame,cpu_ms,draw_calls,vertices,indices,texture_binds,program_binds,state_changes,upload_bytes,upload_calls,sprite_batch_breaks,skipped_calls,hud_quads_rebuilt,gpu_frame";
+    for (int ipass = 0; ipass < eRenderPass_COUNT; ++ipass)
+    {
+        mRecordFile << ",gpu_" << cxx::enum_to_string((eRenderPass) ipass) << "_ms";
+    }
+    mRecordFile << std::endl;
+}
+
+void RenderStatistics::WriteRecordFrame()
+{
+    mRecordFile << mFrameIndex << "," << mCpuFrameTime << "," <<
+        mFrameCounters.mDrawCalls << "," <<
+        mFrameCounters.mVerticesSubmitted << "," <<
+        mFrameCounters.mIndicesSubmitted << "," <<
+        mFrameCounters.mTextureBinds << "," <<
+        mFrameCounters.mProgramBinds << "," <<
+        mFrameCounters.mRenderStateChanges << "," <<
+        mFrameCounters.mBufferUploadBytes << "," <<
+        mFrameCounters.mBufferUploadCalls << "," <<
+        mFrameCounters.mSpriteBatchBreaks << "," <<
+        mFrameCounters.mRedundantCallsSkipped << "," <<
+        mFrameCounters.mHudQuadsRebuilt << ",";
+
+    // gpu times are written for older frame
+    mRecordFile << mGpuTimersFrame;
+    for (float currPassTime: mGpuPassTime)
+    {
+        mRecordFile << "," << currPassTime;
+    }
+    mRecordFile << "\n";
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "GraphicsDefs.h"
+
+// render frame passes measured with gpu timers
+enum eRenderPass
+{
+    eRenderPass_CityMesh,
+    eRenderPass_Sprites,
+    eRenderPass_Debug,
+    eRenderPass_Gui,
+    eRenderPass_COUNT
+};
+
+decl_enum_strings(eRenderPass);
+
+// collects graphics device counters per frame and per render view, measures render passes on gpu,
+// frames could be recorded to csv file
+class RenderStatistics final: public cxx::noncopyable
+{
+public:
+    static const int GpuTimersLatency = 3; // frames to wait before reading gpu timer results
+
+public:
+    // readonly
+    RenderCounters mFrameCounters; // last frame
+    std::vector<RenderCounters> mViewCounters; // last frame, in order of active render views
+
+    float mCpuFrameTime = 0.0f; // milliseconds spent on render frame submission
+    float mGpuPassTime[eRenderPass_COUNT] = {}; // milliseconds, results lag behind by few frames
+    unsigned int mGpuTimersFrame = 0; // frame which gpu pass times are belongs to
+    unsigned int mFrameIndex = 0;
+
+    bool mGpuTimersEnabled = false;
+
+public:
+    RenderStatistics();
+
+    // Free gpu queries and close record file
+    void Deinit();
+
+    // Start and finish render frame, must be called before present
+    // @param viewsCount: Number of render views in frame
+    void FrameBegin(int viewsCount);
+    void FrameEnd();
+
+    // Collect device counters of specific render view
+    // @param viewIndex: Index of view in frame
+    void BeginView(int viewIndex);
+    void EndView(int viewIndex);
+
+    // Measure render pass with gpu timer, does nothing if timers are disabled
+    // Pass could be measured multiple times per frame, times are accumulated
+    // @param renderPass: Pass identifier
+    void BeginPass(eRenderPass renderPass);
+    void EndPass(eRenderPass renderPass);
+
+    // Write frames statistics to csv file, one row per frame
+    // @param filePath: Output file path
+    bool StartRecording(const std::string& filePath);
+    void StopRecording();
+
+    inline bool IsRecording() const { return mRecordFile.is_open(); }
+
+    // Test whether gpu timers are supported by graphics device
+    bool IsGpuTimersSupported() const;
+
+private:
+    // pair of timestamps around render pass
+    struct PassQuery
+    {
+        eRenderPass mRenderPass;
+        GpuQueryHandle mStartQuery;
+        GpuQueryHandle mEndQuery;
+    };
+
+    // issued gpu queries of single frame
+    struct FrameQueries
+    {
+        std::vector<PassQuery> mPassQueries; // query objects are reused
+        int mPassQueriesCount = 0;
+        unsigned int mFrameIndex = 0;
+        bool mPending = false;
+    };
+
+private:
+    void ResolveGpuTimers(FrameQueries& frameQueries);
+    void WriteRecordHeader();
+    void WriteRecordFrame();
+
+private:
+    FrameQueries mFrameQueries[GpuTimersLatency];
+    int mCurrentFrameQueries = 0;
+    int mOpenPassQueries[eRenderPass_COUNT]; // index in current frame queries or -1
+
+    RenderCounters mViewStartCounters;
+    double mFrameStartTime = 0.0;
+
+    std::ofstream mRecordFile;
+};
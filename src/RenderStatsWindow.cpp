@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "RenderStatsWindow.h"
+#include "imgui.h"
+#include "RenderingManager.h"
+#include "SpriteManager.h"
+
+static const char* RenderStatsRecordPath = "render_stats.csv";
+
+RenderStatsWindow gRenderStatsWindow;
+
+RenderStatsWindow::RenderStatsWindow() : DebugWindow("Render Stats")
+{
+}
+
+void RenderStatsWindow::DoUI(ImGuiIO& imguiContext)
+{
+    ImGuiWindowFlags wndFlags = ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_AlwaysAutoResize;
+    if (!ImGui::Begin(mWindowName, &mWindowShown, wndFlags))
+    {
+        ImGui::End();
+        return;
+    }
+
+    RenderStatistics& statistics = gRenderManager.mStatistics;
+
+    ImGui::Text("Frame: %u", statistics.mFrameIndex);
+    ImGui::Text("Cpu frame time: %.3f ms", statistics.mCpuFrameTime);
+    ImGui::Text("Sprites drawn: %d", gRenderManager.mMapRenderer.mRenderStats.mSpritesDrawnCount);
+    ImGui::Text("Map chunks drawn: %d (%d draws)", gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawnCount, 
+        gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawCalls);
+    ImGui::Text("Snapshot capture: %.3f ms", gRenderManager.mMapRenderer.mRenderStats.mSnapshotCaptureTime);
+    ImGui::Text("Snapshot wait: %.3f ms", gRenderManager.mMapRenderer.mRenderStats.mSnapshotWaitTime);
+
+    if (ImGui::CollapsingHeader("Frame counters", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Checkbox("Merge blocks indices uploads", &gSpriteManager.mMergeBlocksIndicesUploads);
+        DoCountersUI(statistics.mFrameCounters);
+    }
+
+    for (int iview = 0; iview < (int) statistics.mViewCounters.size(); ++iview)
+    {
+        ImGui::PushID(iview);
+        if (ImGui::CollapsingHeader(cxx::va("View %d counters", iview)))
+        {
+            DoCountersUI(statistics.mViewCounters[iview]);
+        }
+        ImGui::PopID();
+    }
+
+    if (ImGui::CollapsingHeader("Gpu timers", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        if (statistics.IsGpuTimersSupported())
+        {
+            ImGui::Checkbox("Enable gpu timers", &statistics.mGpuTimersEnabled);
+            if (statistics.mGpuTimersEnabled)
+            {
+                float gpuFrameTime = 0.0f;
+                for (int ipass = 0; ipass < eRenderPass_COUNT; ++ipass)
+                {
+                    ImGui::Text("%s: %.3f ms", cxx::enum_to_string((eRenderPass) ipass), statistics.mGpuPassTime[ipass]);
+                    gpuFrameTime += statistics.mGpuPassTime[ipass];
+                }
+                ImGui::Text("Total: %.3f ms (frame %u)", gpuFrameTime, statistics.mGpuTimersFrame);
+            }
+        }
+        else
+        {
+            ImGui::Text("Gpu timers are not supported");
+        }
+    }
+
+    ImGui::Separator();
+    if (statistics.IsRecording())
+    {
+        if (ImGui::Button("Stop recording"))
+        {
+            statistics.StopRecording();
+        }
+    }
+    else if (ImGui::Button("Record to csv"))
+    {
+        statistics.StartRecording(RenderStatsRecordPath);
+    }
+
+    ImGui::End();
+}
+
+void RenderStatsWindow::DoCountersUI(const RenderCounters& renderCounters)
+{
+    ImGui::Text("Draw calls: %d", renderCounters.mDrawCalls);
+    ImGui::Text("Vertices: %d", renderCounters.mVerticesSubmitted);
+    ImGui::Text("Indices: %d", renderCounters.mIndicesSubmitted);
+    ImGui::Text("Texture binds: %d", renderCounters.mTextureBinds);
+    ImGui::Text("Program binds: %d", renderCounters.mProgramBinds);
+    ImGui::Text("Render state changes: %d", renderCounters.mRenderStateChanges);
+    ImGui::Text("Buffer uploads: %d bytes (%d calls)", renderCounters.mBufferUploadBytes, renderCounters.mBufferUploadCalls);
+    ImGui::Text("Sprite batch breaks: %d", renderCounters.mSpriteBatchBreaks);
+    ImGui::Text("Redundant calls skipped: %d", renderCounters.mRedundantCallsSkipped);
+    ImGui::Text("HUD quads rebuilt: %d", renderCounters.mHudQuadsRebuilt);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "DebugWindow.h"
+
+struct RenderCounters;
+
+// displays render statistics of last frame
+class RenderStatsWindow: public DebugWindow
+{
+public:
+    RenderStatsWindow();
+
+private:
+    // process window state
+    // @param imguiContext: Internal imgui context
+    void DoUI(ImGuiIO& imguiContext) override;
+
+    void DoCountersUI(const RenderCounters& renderCounters);
+};
+
+extern RenderStatsWindow gRenderStatsWindow;
@@ -7,6 +7,8 @@
 #include "GameCheatsWindow.h"
 #include "AiManager.h"
 #include "TrafficManager.h"
+#include "BulletsManager.h"
+#include "RenderBenchmark.h"
 
 RenderingManager gRenderManager;
 
@@ -28,6 +30,7 @@ bool RenderingManager::Initialize()
         Deinit();
         return false;
     }
+    mMapRenderer.mWorkerThreadPrepare = !gSystem.mStartupParams.mSerialRendering;
 
     if (!mDebugRenderer.Initialize())
     {
@@ -42,6 +45,7 @@ bool RenderingManager::Initialize()
 void RenderingManager::Deinit()
 {
     mActiveRenderViews.clear();
+    mStatistics.Deinit();
     mDebugRenderer.Deinit();
     mMapRenderer.Deinit();
     gSpriteManager.Cleanup();
@@ -51,29 +55,45 @@ void RenderingManager::Deinit()
 
 void RenderingManager::RenderFrame()
 {
+    mStatistics.FrameBegin((int) mActiveRenderViews.size());
+
     gGraphicsDevice.ClearScreen();
     gSpriteManager.RenderFrameBegin();
-    mMapRenderer.RenderFrameBegin();
+    mMapRenderer.RenderFrameBegin(mActiveRenderViews);
 
     Rect viewportRectangle = gGraphicsDevice.mViewportRect;
-    for (RenderView* currRenderview: mActiveRenderViews)
+    for (int iview = 0; iview < (int) mActiveRenderViews.size(); ++iview)
     {
+        RenderView* currRenderview = mActiveRenderViews[iview];
+
+        mStatistics.BeginView(iview);
         currRenderview->DrawFrameBegin();
         mMapRenderer.RenderFrame(currRenderview);
 
         // draw debug info for first human view only
-        if (currRenderview == mActiveRenderViews[0] && gGameCheatsWindow.mEnableDebugDraw)
+        if (iview == 0 && gGameCheatsWindow.mEnableDebugDraw)
         {
+            mStatistics.BeginPass(eRenderPass_Debug);
             mDebugRenderer.RenderFrameBegin(currRenderview);
             mMapRenderer.DebugDraw(currRenderview, mDebugRenderer);
             gTrafficManager.DebugDraw(mDebugRenderer);
             gAiManager.DebugDraw(mDebugRenderer);
+            gBulletsManager.DebugDraw(mDebugRenderer);
             mDebugRenderer.RenderFrameEnd();
+            mStatistics.EndPass(eRenderPass_Debug);
         }
+        mStatistics.EndView(iview);
     }
     gGraphicsDevice.SetViewportRect(viewportRectangle);
 
+    if (gRenderBenchmark.IsRunning())
+    {
+        gRenderBenchmark.CaptureFrame();
+    }
+
+    mStatistics.BeginPass(eRenderPass_Gui);
     gGuiManager.RenderFrame();
+    mStatistics.EndPass(eRenderPass_Gui);
 
     for (RenderView* currRenderview: mActiveRenderViews)
     {
@@ -81,6 +101,8 @@ void RenderingManager::RenderFrame()
     }
     mMapRenderer.RenderFrameEnd();
     gSpriteManager.RenderFrameEnd();
+
+    mStatistics.FrameEnd();
     gGraphicsDevice.Present();
 }
 
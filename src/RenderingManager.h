@@ -2,8 +2,10 @@
 
 #include "GraphicsDefs.h"
 #include "RenderProgram.h"
+#include "SpritesRenderProgram.h"
 #include "MapRenderer.h"
 #include "DebugRenderer.h"
+#include "RenderStatistics.h"
 
 class RenderView;
 
@@ -14,13 +16,16 @@ public:
     RenderProgram mDefaultTexColorProgram;
     RenderProgram mCityMeshProgram;
     RenderProgram mGuiTexColorProgram;
-    RenderProgram mSpritesProgram;
+    SpritesRenderProgram mSpritesProgram;
     RenderProgram mDebugProgram;
 
     MapRenderer mMapRenderer;
+    RenderStatistics mStatistics;
 
     std::vector<RenderView*> mActiveRenderViews;
 
+    bool mEnableSpritesInstancing = true; // falls back to cpu expanded quads if not supported
+
 public:
     RenderingManager();
 
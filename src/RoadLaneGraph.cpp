@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "RoadLaneGraph.h"
+#include "GameMapManager.h"
+
+void RoadLaneGraph::BuildGraph(const GameMapManager& gameMap)
+{
+    Cleanup();
+
+    mColumnFirstSegment.resize(MAP_DIMENSIONS * MAP_DIMENSIONS, NullSegment);
+    mColumnSegmentsCount.resize(MAP_DIMENSIONS * MAP_DIMENSIONS, 0);
+
+    // collect road segments, column by column
+    for (int tiley = 0; tiley < MAP_DIMENSIONS; ++tiley)
+    for (int tilex = 0; tilex < MAP_DIMENSIONS; ++tilex)
+    {
+        int columnIndex = tiley * MAP_DIMENSIONS + tilex;
+
+        bool hasSolidAbove = false;
+        int columnFirstSegment = (int) mSegments.size();
+        int columnSegmentsCount = 0;
+
+        // scan from top to find covered segments, then put in order from bottom to top
+        for (int tilez = (MAP_LAYERS_COUNT - 1); tilez > -1; --tilez)
+        {
+            const MapBlockInfo* mapBlock = gameMap.GetBlockInfo(tilex, tiley, tilez);
+            if (mapBlock->mGroundType == eGroundType_Air)
+                continue;
+
+            bool isCovered = hasSolidAbove;
+            hasSolidAbove = true;
+
+            if ((mapBlock->mGroundType != eGroundType_Road) || mapBlock->mIsRailway)
+                continue;
+
+            unsigned char directionBits = 0;
+            if (mapBlock->mUpDirection) directionBits |= BIT(eMapDirection_N);
+            if (mapBlock->mRightDirection) directionBits |= BIT(eMapDirection_E);
+            if (mapBlock->mDownDirection) directionBits |= BIT(eMapDirection_S);
+            if (mapBlock->mLeftDirection) directionBits |= BIT(eMapDirection_W);
+
+            if (directionBits == 0)
+                continue;
+
+            mSegments.emplace_back();
+            RoadLaneSegment& segment = mSegments.back();
+            segment.mMapX = (unsigned char) tilex;
+            segment.mMapY = (unsigned char) tiley;
+            segment.mMapLayer = (unsigned char) tilez;
+            segment.mDirectionBits = directionBits;
+
+            int directionsCount = 0;
+            for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+            {
+                segment.mLinks[idirection] = NullSegment;
+                if (directionBits & BIT(idirection))
+                {
+                    ++directionsCount;
+                }
+            }
+            segment.mFlags = (directionsCount > 1) ? eRoadLaneFlags_Junction : eRoadLaneFlags_OneWay;
+            if (mapBlock->mTrafficHint == eTrafficHint_TrafficLights)
+            {
+                segment.mFlags = segment.mFlags | eRoadLaneFlags_TrafficLights;
+            }
+            if (isCovered)
+            {
+                segment.mFlags = segment.mFlags | eRoadLaneFlags_Covered;
+            }
+            ++columnSegmentsCount;
+        }
+
+        if (columnSegmentsCount == 0)
+            continue;
+
+        // bottom to top
+        std::reverse(mSegments.begin() + columnFirstSegment, mSegments.end());
+
+        mColumnFirstSegment[columnIndex] = columnFirstSegment;
+        mColumnSegmentsCount[columnIndex] = (unsigned char) columnSegmentsCount;
+    }
+
+    // link adjacent segments
+    for (RoadLaneSegment& currSegment: mSegments)
+    {
+        for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+        {
+            if ((currSegment.mDirectionBits & BIT(idirection)) == 0)
+                continue;
+
+            const glm::ivec3& moveVector = GetVectorFromMapDirection((eMapDirection) idirection);
+            currSegment.mLinks[idirection] = LinkSegment(currSegment.mMapX + moveVector.x, currSegment.mMapY + moveVector.z,
+                currSegment.mMapLayer);
+        }
+    }
+
+    gConsole.LogMessage(eLogMessage_Debug, "Road lanes graph: %d segments", (int) mSegments.size());
+}
+
+void RoadLaneGraph::Cleanup()
+{
+    mSegments.clear();
+    mColumnFirstSegment.clear();
+    mColumnSegmentsCount.clear();
+}
+
+void RoadLaneGraph::Swap(RoadLaneGraph& otherGraph)
+{
+    mSegments.swap(otherGraph.mSegments);
+    mColumnFirstSegment.swap(otherGraph.mColumnFirstSegment);
+    mColumnSegmentsCount.swap(otherGraph.mColumnSegmentsCount);
+}
+
+int RoadLaneGraph::GetSegmentIndex(int mapx, int mapy, int layer) const
+{
+    if ((mapx < 0) || (mapy < 0) || (mapx >= MAP_DIMENSIONS) || (mapy >= MAP_DIMENSIONS) || mColumnFirstSegment.empty())
+        return NullSegment;
+
+    int columnIndex = mapy * MAP_DIMENSIONS + mapx;
+    int firstSegment = mColumnFirstSegment[columnIndex];
+    for (int isegment = 0, Count = mColumnSegmentsCount[columnIndex]; isegment < Count; ++isegment)
+    {
+        if (mSegments[firstSegment + isegment].mMapLayer == layer)
+            return firstSegment + isegment;
+    }
+    return NullSegment;
+}
+
+int RoadLaneGraph::GetTopSegmentIndex(int mapx, int mapy) const
+{
+    if ((mapx < 0) || (mapy < 0) || (mapx >= MAP_DIMENSIONS) || (mapy >= MAP_DIMENSIONS) || mColumnFirstSegment.empty())
+        return NullSegment;
+
+    int columnIndex = mapy * MAP_DIMENSIONS + mapx;
+    int segmentsCount = mColumnSegmentsCount[columnIndex];
+    if (segmentsCount == 0)
+        return NullSegment;
+
+    return mColumnFirstSegment[columnIndex] + segmentsCount - 1;
+}
+
+int RoadLaneGraph::GetSegmentIndexAtPosition(const glm::vec3& position) const
+{
+    glm::vec3 mapPosition = Convert::MetersToMapUnits(position);
+
+    int mapx = (int) mapPosition.x;
+    int mapy = (int) mapPosition.z;
+    int layer = (int) (mapPosition.y + 0.5f);
+
+    // vehicle might be on slope
+    int segmentIndex = GetSegmentIndex(mapx, mapy, layer);
+    if (segmentIndex == NullSegment)
+    {
+        segmentIndex = GetSegmentIndex(mapx, mapy, layer - 1);
+    }
+    return segmentIndex;
+}
+
+bool RoadLaneGraph::ChooseNextDirection(int segmentIndex, eMapDirection currentDirection, cxx::randomizer& randomizer, eMapDirection& outDirection) const
+{
+    debug_assert(segmentIndex > NullSegment && segmentIndex < (int) mSegments.size());
+
+    const RoadLaneSegment& segment = mSegments[segmentIndex];
+
+    // keep going straight
+    if (!segment.IsJunction() && segment.HasDirection(currentDirection) && (segment.mLinks[currentDirection] != NullSegment))
+    {
+        outDirection = currentDirection;
+        return true;
+    }
+
+    eMapDirection candidates[eMapDirection_COUNT];
+    int candidatesCount = 0;
+
+    eMapDirection oppositeDirection = GetMapDirectionOpposite(currentDirection);
+    for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+    {
+        eMapDirection direction = (eMapDirection) idirection;
+        if ((direction == oppositeDirection) || (segment.mLinks[direction] == NullSegment))
+            continue;
+
+        candidates[candidatesCount++] = direction;
+    }
+
+    if (candidatesCount == 0)
+        return false;
+
+    outDirection = candidates[0];
+    if (candidatesCount > 1)
+    {
+        outDirection = candidates[randomizer.generate_int(candidatesCount - 1)];
+    }
+    return true;
+}
+
+bool RoadLaneGraph::ChooseSpawnDirection(int segmentIndex, cxx::randomizer& randomizer, eMapDirection& outDirection) const
+{
+    debug_assert(segmentIndex > NullSegment && segmentIndex < (int) mSegments.size());
+
+    const RoadLaneSegment& segment = mSegments[segmentIndex];
+
+    eMapDirection candidates[eMapDirection_COUNT];
+    int candidatesCount = 0;
+    for (int idirection = 0; idirection < eMapDirection_COUNT; ++idirection)
+    {
+        if (segment.mLinks[idirection] == NullSegment)
+            continue;
+
+        candidates[candidatesCount++] = (eMapDirection) idirection;
+    }
+
+    if (candidatesCount == 0)
+        return false;
+
+    outDirection = candidates[0];
+    if (candidatesCount > 1)
+    {
+        outDirection = candidates[randomizer.generate_int(candidatesCount - 1)];
+    }
+    return true;
+}
+
+glm::vec3 RoadLaneGraph::GetSegmentCenter(int segmentIndex) const
+{
+    debug_assert(segmentIndex > NullSegment && segmentIndex < (int) mSegments.size());
+
+    const RoadLaneSegment& segment = mSegments[segmentIndex];
+    return Convert::MapUnitsToMeters(glm::vec3(segment.mMapX + 0.5f, segment.mMapLayer * 1.0f, segment.mMapY + 0.5f));
+}
+
+int RoadLaneGraph::LinkSegment(int mapx, int mapy, int layer) const
+{
+    // road could go up or down the slope
+    int segmentIndex = GetSegmentIndex(mapx, mapy, layer);
+    if (segmentIndex == NullSegment)
+    {
+        segmentIndex = GetSegmentIndex(mapx, mapy, layer + 1);
+    }
+    if (segmentIndex == NullSegment)
+    {
+        segmentIndex = GetSegmentIndex(mapx, mapy, layer - 1);
+    }
+    return segmentIndex;
+}
\ No newline at end of file
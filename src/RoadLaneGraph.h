@@ -0,0 +1,106 @@
+#pragma once
+
+#include "GameDefs.h"
+#include "GameMapHelpers.h"
+
+class GameMapManager;
+
+// road lane segment flags
+enum eRoadLaneFlags : unsigned char
+{
+    eRoadLaneFlags_None = 0,
+    eRoadLaneFlags_Junction = BIT(0), // more than one direction allowed
+    eRoadLaneFlags_OneWay = BIT(1), // only single direction allowed
+    eRoadLaneFlags_TrafficLights = BIT(2),
+    eRoadLaneFlags_Covered = BIT(3), // there is solid block above, bridge or tunnel
+};
+
+decl_enum_as_flags(eRoadLaneFlags);
+
+// defines single road block along with allowed driving directions
+struct RoadLaneSegment
+{
+public:
+    RoadLaneSegment() = default;
+
+    // test whether driving in specific direction is allowed
+    inline bool HasDirection(eMapDirection direction) const
+    {
+        return (mDirectionBits & BIT(direction)) > 0;
+    }
+    inline bool IsJunction() const { return (mFlags & eRoadLaneFlags_Junction) > 0; }
+    inline bool IsOneWay() const { return (mFlags & eRoadLaneFlags_OneWay) > 0; }
+    inline bool HasTrafficLights() const { return (mFlags & eRoadLaneFlags_TrafficLights) > 0; }
+    inline bool IsCovered() const { return (mFlags & eRoadLaneFlags_Covered) > 0; }
+
+public:
+    unsigned char mMapX = 0;
+    unsigned char mMapY = 0;
+    unsigned char mMapLayer = 0;
+    unsigned char mDirectionBits = 0; // allowed directions, see eMapDirection
+    eRoadLaneFlags mFlags = eRoadLaneFlags_None;
+
+    // adjacent segment index for each direction, or -1
+    int mLinks[eMapDirection_COUNT];
+};
+
+// Road lanes graph for driving ai, built from map blocks directions at level load
+// All segments are stored in single array sorted by map columns, so lookups are constant time
+class RoadLaneGraph final: public cxx::noncopyable
+{
+public:
+    static const int NullSegment = -1;
+
+    // readonly
+    std::vector<RoadLaneSegment> mSegments;
+
+public:
+    // Generate lanes graph for currently loaded map
+    // @param gameMap: Source map data
+    void BuildGraph(const GameMapManager& gameMap);
+    void Cleanup();
+
+    // Exchange graph data with other instance
+    // @param otherGraph: Graph to exchange with
+    void Swap(RoadLaneGraph& otherGraph);
+
+    // Find road segment at specific map block
+    // @returns segment index or NullSegment
+    int GetSegmentIndex(int mapx, int mapy, int layer) const;
+    // Find topmost road segment within map column
+    // @returns segment index or NullSegment
+    int GetTopSegmentIndex(int mapx, int mapy) const;
+    // Find road segment at specific world position, meters
+    // @returns segment index or NullSegment
+    int GetSegmentIndexAtPosition(const glm::vec3& position) const;
+
+    // Get adjacent segment in specific direction
+    // @returns segment index or NullSegment
+    inline int GetNextSegment(int segmentIndex, eMapDirection direction) const
+    {
+        debug_assert(segmentIndex > NullSegment && segmentIndex < (int) mSegments.size());
+        return mSegments[segmentIndex].mLinks[direction];
+    }
+
+    // Choose direction to continue driving from segment
+    // Straight movement is preferred unless segment is junction, u-turns are avoided
+    // @param segmentIndex: Current segment
+    // @param currentDirection: Current driving direction
+    // @param randomizer: Random generator
+    // @param outDirection: Output direction
+    bool ChooseNextDirection(int segmentIndex, eMapDirection currentDirection, cxx::randomizer& randomizer, eMapDirection& outDirection) const;
+
+    // Choose direction for vehicle spawned on segment
+    bool ChooseSpawnDirection(int segmentIndex, cxx::randomizer& randomizer, eMapDirection& outDirection) const;
+
+    // Get world position of segment center, meters
+    glm::vec3 GetSegmentCenter(int segmentIndex) const;
+
+private:
+    int LinkSegment(int mapx, int mapy, int layer) const;
+
+private:
+    // index of first segment for each map column, segments within column are sorted by layer
+    std::vector<int> mColumnFirstSegment; // y, x
+    std::vector<unsigned char> mColumnSegmentsCount; // y, x
+};
\ No newline at end of file
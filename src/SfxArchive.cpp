@@ -91,6 +91,12 @@ bool SfxArchive::IsLoaded() const
     return !mAudioEntries.empty();
 }
 
+void SfxArchive::Swap(SfxArchive& otherArchive)
+{
+    mAudioEntries.swap(otherArchive.mAudioEntries);
+    mRawDataStream.swap(otherArchive.mRawDataStream);
+}
+
 int SfxArchive::GetEntriesCount() const
 {
     return (int) mAudioEntries.size();
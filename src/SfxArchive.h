@@ -25,6 +25,10 @@ public:
     void FreeArchive();
     bool IsLoaded() const;
 
+    // Exchange loaded entries and data stream with other archive
+    // @param otherArchive: Archive
+    void Swap(SfxArchive& otherArchive);
+
     // Reading audio entries
     bool GetEntryInfo(int entryIndex, SfxArchiveEntry& output) const;
     bool GetEntryData(int entryIndex, SfxArchiveEntry& output);
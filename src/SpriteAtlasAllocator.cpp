@@ -0,0 +1,323 @@
+#include "stdafx.h"
+#include "SpriteAtlasAllocator.h"
+
+void SpriteAtlasAllocator::Setup(const Point& pageSize, int spacing)
+{
+    debug_assert(pageSize.x > 0);
+    debug_assert(pageSize.y > 0);
+    debug_assert(spacing >= 0);
+
+    Clear();
+
+    mPageSize = pageSize;
+    mSpacing = spacing;
+}
+
+void SpriteAtlasAllocator::Clear()
+{
+    mPages.clear();
+    mEntries.clear();
+    mFreeHandles.clear();
+    mAllocationsCount = 0;
+    mAllocatedArea = 0;
+}
+
+int SpriteAtlasAllocator::AddPage()
+{
+    mPages.emplace_back();
+    return (int) mPages.size() - 1;
+}
+
+int SpriteAtlasAllocator::Allocate(const Point& size)
+{
+    debug_assert(size.x > 0);
+    debug_assert(size.y > 0);
+
+    int handle = InvalidHandle;
+    if (mFreeHandles.empty())
+    {
+        handle = (int) mEntries.size();
+        mEntries.emplace_back();
+    }
+    else
+    {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+    }
+
+    if (!AllocateEntry(handle, size))
+    {
+        mFreeHandles.push_back(handle);
+        return InvalidHandle;
+    }
+
+    mEntries[handle].mAllocated = true;
+    mAllocatedArea += (long long) (size.x + mSpacing) * (size.y + mSpacing);
+    ++mAllocationsCount;
+    return handle;
+}
+
+void SpriteAtlasAllocator::Free(int handle)
+{
+    debug_assert(handle >= 0 && handle < (int) mEntries.size());
+
+    AtlasEntry& entry = mEntries[handle];
+    debug_assert(entry.mAllocated);
+    if (!entry.mAllocated)
+        return;
+
+    AtlasPage& page = mPages[entry.mPageIndex];
+    AtlasShelf& shelf = page.mShelves[entry.mShelfIndex];
+    FreeInShelf(shelf, entry.mRectangle.x, entry.mRectangle.w + mSpacing);
+
+    debug_assert(shelf.mEntriesCount > 0);
+    if (--shelf.mEntriesCount == 0)
+    {
+        shelf.mFreeSpans.clear();
+        shelf.mFillX = 0;
+    }
+
+    // give unused space at the bottom back to page
+    while (!page.mShelves.empty() && page.mShelves.back().mEntriesCount == 0)
+    {
+        page.mFillY = page.mShelves.back().mPosY;
+        page.mShelves.pop_back();
+    }
+
+    mAllocatedArea -= (long long) (entry.mRectangle.w + mSpacing) * (entry.mRectangle.h + mSpacing);
+    --mAllocationsCount;
+
+    entry.mAllocated = false;
+    mFreeHandles.push_back(handle);
+}
+
+bool SpriteAtlasAllocator::Defragment()
+{
+    std::vector<int> liveHandles;
+    liveHandles.reserve(mAllocationsCount);
+    for (int iEntry = 0, NumEntries = (int) mEntries.size(); iEntry < NumEntries; ++iEntry)
+    {
+        if (mEntries[iEntry].mAllocated)
+        {
+            liveHandles.push_back(iEntry);
+        }
+    }
+
+    // taller rectangles first so shelves are filled tightly
+    std::sort(liveHandles.begin(), liveHandles.end(), [this](int lhs, int rhs)
+        {
+            const Rect& lhsRect = mEntries[lhs].mRectangle;
+            const Rect& rhsRect = mEntries[rhs].mRectangle;
+            if (lhsRect.h != rhsRect.h)
+            {
+                return lhsRect.h > rhsRect.h;
+            }
+            if (lhsRect.w != rhsRect.w)
+            {
+                return lhsRect.w > rhsRect.w;
+            }
+            return lhs < rhs;
+        });
+
+    std::vector<AtlasPage> prevPages;
+    prevPages.swap(mPages);
+    mPages.resize(prevPages.size());
+
+    std::vector<AtlasEntry> prevEntries = mEntries;
+    for (int currHandle: liveHandles)
+    {
+        Point size (prevEntries[currHandle].mRectangle.w, prevEntries[currHandle].mRectangle.h);
+        if (!AllocateEntry(currHandle, size))
+        {
+            mPages.swap(prevPages);
+            mEntries.swap(prevEntries);
+            return false;
+        }
+    }
+    debug_assert(CheckConsistency());
+    return true;
+}
+
+float SpriteAtlasAllocator::GetOccupancy() const
+{
+    if (mPages.empty())
+        return 0.0f;
+
+    long long totalArea = (long long) mPageSize.x * mPageSize.y * mPages.size();
+    return (float) ((double) mAllocatedArea / totalArea);
+}
+
+bool SpriteAtlasAllocator::CheckConsistency() const
+{
+    for (int iEntry = 0, NumEntries = (int) mEntries.size(); iEntry < NumEntries; ++iEntry)
+    {
+        const AtlasEntry& entry = mEntries[iEntry];
+        if (!entry.mAllocated)
+            continue;
+
+        if (entry.mPageIndex < 0 || entry.mPageIndex >= (int) mPages.size())
+            return false;
+
+        const Rect& rect = entry.mRectangle;
+        if (rect.x < 0 || rect.y < 0 || rect.x + rect.w + mSpacing > mPageSize.x || rect.y + rect.h + mSpacing > mPageSize.y)
+            return false;
+
+        for (int iOther = iEntry + 1; iOther < NumEntries; ++iOther)
+        {
+            const AtlasEntry& other = mEntries[iOther];
+            if (!other.mAllocated || other.mPageIndex != entry.mPageIndex)
+                continue;
+
+            const Rect& otherRect = other.mRectangle;
+            if (rect.x < otherRect.x + otherRect.w + mSpacing && otherRect.x < rect.x + rect.w + mSpacing &&
+                rect.y < otherRect.y + otherRect.h + mSpacing && otherRect.y < rect.y + rect.h + mSpacing)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SpriteAtlasAllocator::AllocateEntry(int handle, const Point& size)
+{
+    int slotSizex = size.x + mSpacing;
+    int slotSizey = size.y + mSpacing;
+    if (slotSizex > mPageSize.x || slotSizey > mPageSize.y)
+        return false;
+
+    int shelfHeight = GetShelfHeight(slotSizey);
+
+    AtlasEntry& entry = mEntries[handle];
+    for (int ipage = 0, NumPages = (int) mPages.size(); ipage < NumPages; ++ipage)
+    {
+        AtlasPage& page = mPages[ipage];
+
+        int positionx = 0;
+        // try shelves of same height class, empty shelves could be taken by smaller ones
+        for (int ishelf = 0, NumShelves = (int) page.mShelves.size(); ishelf < NumShelves; ++ishelf)
+        {
+            AtlasShelf& shelf = page.mShelves[ishelf];
+            if (shelf.mSizeY != shelfHeight && (shelf.mEntriesCount > 0 || shelf.mSizeY < shelfHeight))
+                continue;
+
+            if (!AllocateInShelf(shelf, slotSizex, positionx))
+                continue;
+
+            ++shelf.mEntriesCount;
+            entry.mPageIndex = ipage;
+            entry.mShelfIndex = ishelf;
+            entry.mRectangle.Set(positionx, shelf.mPosY, size.x, size.y);
+            return true;
+        }
+
+        // start new shelf
+        if (page.mFillY + shelfHeight > mPageSize.y)
+            continue;
+
+        AtlasShelf& shelf = page.mShelves.emplace_back();
+        shelf.mPosY = page.mFillY;
+        shelf.mSizeY = shelfHeight;
+        page.mFillY += shelfHeight;
+
+        if (!AllocateInShelf(shelf, slotSizex, positionx))
+        {
+            debug_assert(false);
+            continue;
+        }
+
+        ++shelf.mEntriesCount;
+        entry.mPageIndex = ipage;
+        entry.mShelfIndex = (int) page.mShelves.size() - 1;
+        entry.mRectangle.Set(positionx, shelf.mPosY, size.x, size.y);
+        return true;
+    }
+    return false;
+}
+
+bool SpriteAtlasAllocator::AllocateInShelf(AtlasShelf& shelf, int slotSizex, int& positionx) const
+{
+    // best fit among freed spans
+    ShelfSpan* bestSpan = nullptr;
+    for (ShelfSpan& currSpan: shelf.mFreeSpans)
+    {
+        if (currSpan.mSizeX < slotSizex)
+            continue;
+
+        if (bestSpan == nullptr || currSpan.mSizeX < bestSpan->mSizeX)
+        {
+            bestSpan = &currSpan;
+        }
+    }
+
+    if (bestSpan)
+    {
+        positionx = bestSpan->mPosX;
+        bestSpan->mPosX += slotSizex;
+        bestSpan->mSizeX -= slotSizex;
+        if (bestSpan->mSizeX == 0)
+        {
+            shelf.mFreeSpans.erase(shelf.mFreeSpans.begin() + (bestSpan - shelf.mFreeSpans.data()));
+        }
+        return true;
+    }
+
+    if (shelf.mFillX + slotSizex > mPageSize.x)
+        return false;
+
+    positionx = shelf.mFillX;
+    shelf.mFillX += slotSizex;
+    return true;
+}
+
+void SpriteAtlasAllocator::FreeInShelf(AtlasShelf& shelf, int positionx, int slotSizex)
+{
+    auto iposition = std::lower_bound(shelf.mFreeSpans.begin(), shelf.mFreeSpans.end(), positionx,
+        [](const ShelfSpan& lhs, int rhs)
+        {
+            return lhs.mPosX < rhs;
+        });
+
+    int spanIndex = (int) (iposition - shelf.mFreeSpans.begin());
+    shelf.mFreeSpans.insert(iposition, { positionx, slotSizex });
+
+    // merge with neighbours
+    if (spanIndex + 1 < (int) shelf.mFreeSpans.size())
+    {
+        ShelfSpan& currSpan = shelf.mFreeSpans[spanIndex];
+        ShelfSpan& nextSpan = shelf.mFreeSpans[spanIndex + 1];
+        if (currSpan.mPosX + currSpan.mSizeX == nextSpan.mPosX)
+        {
+            currSpan.mSizeX += nextSpan.mSizeX;
+            shelf.mFreeSpans.erase(shelf.mFreeSpans.begin() + spanIndex + 1);
+        }
+    }
+
+    if (spanIndex > 0)
+    {
+        ShelfSpan& prevSpan = shelf.mFreeSpans[spanIndex - 1];
+        ShelfSpan& currSpan = shelf.mFreeSpans[spanIndex];
+        if (prevSpan.mPosX + prevSpan.mSizeX == currSpan.mPosX)
+        {
+            prevSpan.mSizeX += currSpan.mSizeX;
+            shelf.mFreeSpans.erase(shelf.mFreeSpans.begin() + spanIndex);
+        }
+    }
+
+    // give trailing span back to shelf
+    if (!shelf.mFreeSpans.empty())
+    {
+        const ShelfSpan& lastSpan = shelf.mFreeSpans.back();
+        if (lastSpan.mPosX + lastSpan.mSizeX == shelf.mFillX)
+        {
+            shelf.mFillX = lastSpan.mPosX;
+            shelf.mFreeSpans.pop_back();
+        }
+    }
+}
+
+int SpriteAtlasAllocator::GetShelfHeight(int sizey) const
+{
+    int shelfHeight = ((sizey + ShelfHeightGranularity - 1) / ShelfHeightGranularity) * ShelfHeightGranularity;
+    return std::min(shelfHeight, mPageSize.y);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// Dynamic rectangles allocator for sprite atlas pages, does not own any graphics resources
+// Rectangles are packed into horizontal shelves of fixed height classes within equally sized pages,
+// freed shelf space is recycled by subsequent allocations and could be compacted with defragmentation
+class SpriteAtlasAllocator final: public cxx::noncopyable
+{
+public:
+    static const int InvalidHandle = -1;
+    static const int ShelfHeightGranularity = 8;
+
+    // allocated rectangle location
+    struct AtlasEntry
+    {
+    public:
+        int mPageIndex = 0;
+        int mShelfIndex = 0;
+        Rect mRectangle; // within page, not including spacing
+        bool mAllocated = false;
+    };
+
+public:
+    // Reset allocator and specify pages dimensions
+    // @param pageSize: Page dimensions in pixels
+    // @param spacing: Gap between neighbour rectangles
+    void Setup(const Point& pageSize, int spacing);
+
+    // Free all allocations and pages
+    void Clear();
+
+    // Add new empty page, allocations could be placed there afterwards
+    // @returns page index
+    int AddPage();
+
+    // Allocate rectangle in one of existing pages
+    // @param size: Rectangle dimensions
+    // @returns allocation handle or InvalidHandle if there is no space left
+    int Allocate(const Point& size);
+
+    // Release allocated rectangle, handle becomes invalid
+    // @param handle: Allocation handle
+    void Free(int handle);
+
+    // Repack all allocated rectangles to reduce fragmentation, handles remains valid but locations are changed
+    // If allocations cannot be repacked into existing pages then previous state is kept
+    // @returns false on failure
+    bool Defragment();
+
+    // Get location of allocated rectangle
+    // @param handle: Allocation handle
+    inline const AtlasEntry& GetEntry(int handle) const
+    {
+        debug_assert(handle >= 0 && handle < (int) mEntries.size());
+        debug_assert(mEntries[handle].mAllocated);
+        return mEntries[handle];
+    }
+
+    inline int GetPagesCount() const { return (int) mPages.size(); }
+    inline int GetAllocationsCount() const { return mAllocationsCount; }
+    inline const Point& GetPageSize() const { return mPageSize; }
+
+    // Get ratio of allocated pixels including spacing to total pages area, in range [0, 1]
+    float GetOccupancy() const;
+
+    // Make sure that allocations are within pages bounds and does not overlap each other, slow
+    bool CheckConsistency() const;
+
+private:
+    // free horizontal space within shelf
+    struct ShelfSpan
+    {
+    public:
+        int mPosX;
+        int mSizeX;
+    };
+
+    struct AtlasShelf
+    {
+    public:
+        int mPosY = 0;
+        int mSizeY = 0;
+        int mFillX = 0; // space after is unused
+        int mEntriesCount = 0;
+        std::vector<ShelfSpan> mFreeSpans; // sorted by position
+    };
+
+    struct AtlasPage
+    {
+    public:
+        int mFillY = 0; // space after last shelf is unused
+        std::vector<AtlasShelf> mShelves;
+    };
+
+private:
+    bool AllocateEntry(int handle, const Point& size);
+    bool AllocateInShelf(AtlasShelf& shelf, int slotSizex, int& positionx) const;
+    void FreeInShelf(AtlasShelf& shelf, int positionx, int slotSizex);
+    int GetShelfHeight(int sizey) const;
+
+private:
+    Point mPageSize;
+    int mSpacing = 0;
+    int mAllocationsCount = 0;
+    long long mAllocatedArea = 0; // including spacing
+
+    std::vector<AtlasPage> mPages;
+    std::vector<AtlasEntry> mEntries;
+    std::vector<int> mFreeHandles;
+};
@@ -16,6 +16,11 @@ bool SpriteBatch::Initialize()
 void SpriteBatch::Deinit()
 {
     mTrimeshBuffer.Deinit();
+    if (mInstancesBuffer)
+    {
+        gGraphicsDevice.DestroyBuffer(mInstancesBuffer);
+        mInstancesBuffer = nullptr;
+    }
     Clear();
 }
 
@@ -24,6 +29,7 @@ void SpriteBatch::Clear()
     mSpritesList.clear();
     mDrawVertices.clear();
     mDrawIndices.clear();
+    mDrawInstances.clear();
     mBatchesList.clear();
 }
 
@@ -34,11 +40,40 @@ void SpriteBatch::DrawSprite(const Sprite2D& sourceSprite)
 
 void SpriteBatch::Flush()
 {
-    if (!mSpritesList.empty())
+    Prepare(gRenderManager.mEnableSpritesInstancing && gRenderManager.mSpritesProgram.IsInstancingSupported());
+    Submit();
+}
+
+void SpriteBatch::Prepare(bool instancing)
+{
+    mInstancing = instancing;
+    if (mSpritesList.empty())
+        return;
+
+    SortSprites();
+    if (mInstancing)
+    {
+        GenerateSpritesInstances();
+    }
+    else
     {
-        SortSprites();
         GenerateSpritesBatches();
-        RenderSpritesBatches();
+    }
+}
+
+void SpriteBatch::Submit()
+{
+    if (!mSpritesList.empty())
+    {
+        debug_assert(!mBatchesList.empty());
+        if (mInstancing)
+        {
+            RenderSpritesInstances();
+        }
+        else
+        {
+            RenderSpritesBatches();
+        }
     }
     Clear();
 }
@@ -146,13 +181,105 @@ void SpriteBatch::GenerateSpritesBatches()
     }
 }
 
+void SpriteBatch::GenerateSpritesInstances()
+{
+    int numSprites = mSpritesList.size();
+
+    mDrawInstances.resize(numSprites);
+    SpriteInstance3D* instanceData = mDrawInstances.data();
+
+    // initial batch
+    mBatchesList.clear();
+    mBatchesList.emplace_back();
+    DrawSpriteBatch* currentBatch = &mBatchesList.back();
+    currentBatch->mFirstVertex = 0;
+    currentBatch->mVertexCount = 0;
+    currentBatch->mSpriteTexture = mSpritesList[0].mTexture;
+
+    for (int isprite = 0; isprite < numSprites; ++isprite)
+    {
+        const Sprite2D& sprite = mSpritesList[isprite];
+        // start new batch
+        if (sprite.mTexture != currentBatch->mSpriteTexture)
+        {
+            DrawSpriteBatch newBatch;
+            newBatch.mFirstVertex = currentBatch->mVertexCount + currentBatch->mFirstVertex;
+            newBatch.mVertexCount = 0;
+            newBatch.mSpriteTexture = sprite.mTexture;
+            mBatchesList.push_back(newBatch);
+            currentBatch = &mBatchesList.back();
+        }
+
+        ++currentBatch->mVertexCount;
+
+        SpriteInstance3D& instance = instanceData[isprite];
+
+        glm::vec2 origin = sprite.GetOriginPoint();
+        glm::vec2 spriteSize = sprite.GetSpriteSize();
+
+        instance.mPosition.x = sprite.mPosition.x;
+        instance.mPosition.y = sprite.mPosition.y;
+        instance.mPosition.z = sprite.mHeight;
+        instance.mOriginAndSize = glm::vec4(origin, spriteSize);
+        instance.mTexcoords.x = sprite.mTextureRegion.mU0;
+        instance.mTexcoords.y = sprite.mTextureRegion.mV0;
+        instance.mTexcoords.z = sprite.mTextureRegion.mU1;
+        instance.mTexcoords.w = sprite.mTextureRegion.mV1;
+        instance.mClutIndex = sprite.mPaletteIndex;
+
+        if (sprite.mRotateAngle.non_zero())
+        {
+            float angleRadians = sprite.mRotateAngle.to_radians();
+            instance.mRotation.x = cos(angleRadians);
+            instance.mRotation.y = sin(angleRadians);
+        }
+        else
+        {
+            instance.mRotation.x = 1.0f;
+            instance.mRotation.y = 0.0f;
+        }
+    }
+}
+
+void SpriteBatch::RenderSpritesInstances()
+{
+    if (mInstancesBuffer == nullptr)
+    {
+        mInstancesBuffer = gGraphicsDevice.CreateBuffer(eBufferContent_Vertices);
+        debug_assert(mInstancesBuffer);
+        if (mInstancesBuffer == nullptr)
+            return;
+    }
+
+    mInstancesBuffer->Setup(eBufferUsage_Stream, Sizeof_SpriteInstance3D * mDrawInstances.size(), mDrawInstances.data());
+
+    gRenderManager.mSpritesProgram.SetGeometryMode(mDepthAxis == DepthAxis_Y ? 
+        eSpritesGeometryMode_InstancesDepthY : eSpritesGeometryMode_InstancesDepthZ);
+
+    gGraphicsDevice.mFrameCounters.mSpriteBatchBreaks += (int) mBatchesList.size() - 1;
+
+    SpriteInstance3D_Format instanceFormat;
+    for (const DrawSpriteBatch& currBatch: mBatchesList)
+    {
+        // there is no base instance in gl 3.3 so attributes offset is used instead
+        instanceFormat.mBaseOffset = Sizeof_SpriteInstance3D * currBatch.mFirstVertex;
+        gGraphicsDevice.BindVertexBuffer(mInstancesBuffer, instanceFormat);
+        gGraphicsDevice.BindTexture(eTextureUnit_0, currBatch.mSpriteTexture);
+        gGraphicsDevice.RenderPrimitivesInstanced(ePrimitiveType_TriangleStrip, 0, NumVerticesPerSprite, currBatch.mVertexCount);
+    }
+}
+
 void SpriteBatch::RenderSpritesBatches()
 {
+    gRenderManager.mSpritesProgram.SetGeometryMode(eSpritesGeometryMode_Vertices);
+
     SpriteVertex3D_Format vFormat;
     mTrimeshBuffer.SetVertices(Sizeof_SpriteVertex3D * mDrawVertices.size(), mDrawVertices.data());
     mTrimeshBuffer.SetIndices(Sizeof_DrawIndex * mDrawIndices.size(), mDrawIndices.data());
     mTrimeshBuffer.Bind(vFormat);
 
+    gGraphicsDevice.mFrameCounters.mSpriteBatchBreaks += (int) mBatchesList.size() - 1;
+
     for (const DrawSpriteBatch& currBatch: mBatchesList)
     {
         gGraphicsDevice.BindTexture(eTextureUnit_0, currBatch.mSpriteTexture);
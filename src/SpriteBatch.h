@@ -28,6 +28,14 @@ public:
     // sort and then render all sprites in current batch
     void Flush();
 
+    // sort all sprites in current batch and generate draw data without rendering,
+    // does not access gpu so it could be called from worker thread
+    // @param instancing: Generate sprite instances instead of quads, instancing must be supported
+    void Prepare(bool instancing);
+
+    // render draw data generated by Prepare and then discard all batched sprites
+    void Submit();
+
     // discard all batched sprites
     void Clear();
 
@@ -38,10 +46,12 @@ public:
 private:
     void GenerateSpritesBatches();
     void RenderSpritesBatches();
+    void GenerateSpritesInstances();
+    void RenderSpritesInstances();
     void SortSprites();
 
 private:
-    // single batch of drawing sprites
+    // single batch of drawing sprites, in instanced mode vertices are sprite instances
     struct DrawSpriteBatch
     {
         unsigned int mFirstVertex;
@@ -56,10 +66,13 @@ private:
     // draw data buffers
     std::vector<SpriteVertex3D> mDrawVertices;
     std::vector<DrawIndex> mDrawIndices;
+    std::vector<SpriteInstance3D> mDrawInstances;
+    GpuBuffer* mInstancesBuffer = nullptr;
 
     std::vector<DrawSpriteBatch> mBatchesList;
     TrimeshBuffer mTrimeshBuffer;
 
     DepthAxis mDepthAxis = DepthAxis_Y;
     eSpritesSortMode mSortMode = eSpritesSortMode_None;
+    bool mInstancing = false; // draw data is generated for instanced rendering
 };
\ No newline at end of file
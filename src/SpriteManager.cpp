@@ -13,14 +13,20 @@ const int ObjectsTextureSizeX = 2048;
 const int ObjectsTextureSizeY = 1024;
 const int SpritesSpacing = 4;
 
+// first delta sprites atlas page is located in objects texture right after default sprites
+const int DeltaAtlasPageSizeX = ObjectsTextureSizeX;
+const int DeltaAtlasPageSizeY = 1024;
+const int DeltaAtlasMaxPages = 4;
+const float DeltaAtlasDefragmentOccupancy = 0.6f; // compact pages when running out of space but occupancy is below
+
 SpriteManager gSpriteManager;
 
-bool SpriteManager::InitLevelSprites()
+bool SpriteManager::InitLevelSprites(const PixelsArray& blocksPixels, const PixelsArray& spritesheetPixels, const std::vector<TextureRegion>& spritesheetEntries)
 {
     Cleanup();
     debug_assert(gGameMap.mStyleData.IsLoaded());
 
-    if (!InitBlocksTexture())
+    if (!InitBlocksTexture(blocksPixels))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot create blocks texture");
         return false;
@@ -32,12 +38,13 @@ bool SpriteManager::InitLevelSprites()
         return false;
     }
 
-    if (!InitObjectsSpritesheet())
+    if (!InitObjectsSpritesheet(spritesheetPixels, spritesheetEntries))
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot create objects spritesheet");
         return false;
     }
 
+    InitDeltaSpritesAtlas();
     InitPalettesTable();
     InitBlocksAnimations();
     InitExplosionFrames();
@@ -47,9 +54,9 @@ bool SpriteManager::InitLevelSprites()
 void SpriteManager::Cleanup()
 {
     FlushSpritesCache();
-    DestroySpriteTextures();
+    DestroyDeltaSpritesAtlas();
     FreeExplosionFrames();
-    mIndicesTableChanged = false;
+    mDirtyBlocksIndices.clear();
     if (mBlocksTextureArray)
     {
         gGraphicsDevice.DestroyTexture(mBlocksTextureArray);
@@ -85,38 +92,28 @@ void SpriteManager::Cleanup()
     mObjectsSpritesheet.mEntries.clear();
 }
 
-bool SpriteManager::InitObjectsSpritesheet()
+bool SpriteManager::PrepareObjectsSpritesheet(StyleData& styleData, PixelsArray& spritesheetPixels, std::vector<TextureRegion>& spritesheetEntries)
 {
-    StyleData& cityStyle = gGameMap.mStyleData;
+    spritesheetEntries.clear();
 
-    int totalSprites = cityStyle.mSprites.size();
+    int totalSprites = styleData.mSprites.size();
     debug_assert(totalSprites > 0);
     if (totalSprites == 0)
-    {
-        gConsole.LogMessage(eLogMessage_Warning, "Skip building objects atlas");
         return true;
-    }
 
     debug_assert(ObjectsTextureSizeX > 0);
     debug_assert(ObjectsTextureSizeY > 0);
 
-    mObjectsSpritesheet.mSpritesheetTexture = gGraphicsDevice.CreateTexture2D(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY, nullptr);
-    debug_assert(mObjectsSpritesheet.mSpritesheetTexture);
+    spritesheetEntries.resize(totalSprites);
 
-    if (mObjectsSpritesheet.mSpritesheetTexture == nullptr)
-        return false;
-
-    mObjectsSpritesheet.mEntries.resize(totalSprites);
-
-    // allocate temporary bitmap
-    PixelsArray spritesBitmap;
-    if (!spritesBitmap.Create(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY, gMemoryManager.mFrameHeapAllocator))
+    // frame heap is not used as it may be called outside of main thread
+    if (!spritesheetPixels.Create(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY))
     {
         debug_assert(false);
         return false;
     }
 
-    spritesBitmap.FillWithColor(0);
+    spritesheetPixels.FillWithColor(0);
 
     // detect total layers count
     std::vector<stbrp_node> stbrp_nodes(ObjectsTextureSizeX);
@@ -126,14 +123,15 @@ bool SpriteManager::InitObjectsSpritesheet()
     for (int isprite = 0, icurr = 0; isprite < totalSprites; ++isprite)
     {
         stbrp_rects[icurr].id = isprite;
-        stbrp_rects[icurr].w = cityStyle.mSprites[isprite].mWidth + SpritesSpacing;
-        stbrp_rects[icurr].h = cityStyle.mSprites[isprite].mHeight + SpritesSpacing;
+        stbrp_rects[icurr].w = styleData.mSprites[isprite].mWidth + SpritesSpacing;
+        stbrp_rects[icurr].h = styleData.mSprites[isprite].mHeight + SpritesSpacing;
         stbrp_rects[icurr].was_packed = 0;
         ++icurr;
     }
 
+    // space for delta sprites atlas page is reserved in texture
     float tcx = 1.0f / ObjectsTextureSizeX;
-    float tcy = 1.0f / ObjectsTextureSizeY;
+    float tcy = 1.0f / (ObjectsTextureSizeY + DeltaAtlasPageSizeY);
 
     // pack sprites
     bool all_done = false;
@@ -142,21 +140,16 @@ bool SpriteManager::InitObjectsSpritesheet()
 		stbrp_init_target(&context, ObjectsTextureSizeX, ObjectsTextureSizeY, stbrp_nodes.data(), stbrp_nodes.size());
 		all_done = stbrp_pack_rects(&context, stbrp_rects.data(), stbrp_rects.size()) > 0;
 
-        // write sprites to temporary bitmap
-        int numPacked = 0;
+        std::vector<const stbrp_rect*> packedRects;
+        packedRects.reserve(stbrp_rects.size());
         for (const stbrp_rect& curr_rc: stbrp_rects)
         {
             if (curr_rc.was_packed == 0)
                 continue;
 
-            ++numPacked;
-            if (!cityStyle.GetSpriteTexture(curr_rc.id, &spritesBitmap, curr_rc.x, curr_rc.y))
-            {
-                debug_assert(false);
-                return false;
-            }
+            packedRects.push_back(&curr_rc);
 
-            TextureRegion& spritesheetRecord = mObjectsSpritesheet.mEntries[curr_rc.id];
+            TextureRegion& spritesheetRecord = spritesheetEntries[curr_rc.id];
             spritesheetRecord.mRectangle.x = curr_rc.x;
             spritesheetRecord.mRectangle.y = curr_rc.y;
             spritesheetRecord.mRectangle.w = curr_rc.w - SpritesSpacing;
@@ -167,67 +160,121 @@ bool SpriteManager::InitObjectsSpritesheet()
             spritesheetRecord.mV1 = (spritesheetRecord.mRectangle.y + spritesheetRecord.mRectangle.h) * tcy;
         }
 
-        if (numPacked == 0)
+        if (packedRects.empty())
         {
             debug_assert(false);
             return false;
         }
 
-        // upload to texture
-        if (!mObjectsSpritesheet.mSpritesheetTexture->Upload(spritesBitmap.mData))
+        // write sprites to temporary bitmap, sprites does not overlap so they could be written concurrently
+        std::atomic<bool> writeFailed (false);
+        cxx::parallel_for((int) packedRects.size(), 128, [&styleData, &spritesheetPixels, &packedRects, &writeFailed](int firstRect, int lastRect)
+            {
+                for (int irect = firstRect; irect < lastRect; ++irect)
+                {
+                    const stbrp_rect& curr_rc = *packedRects[irect];
+                    if (!styleData.GetSpriteTexture(curr_rc.id, &spritesheetPixels, curr_rc.x, curr_rc.y))
+                    {
+                        writeFailed = true;
+                    }
+                }
+            });
+
+        if (writeFailed)
         {
             debug_assert(false);
+            return false;
         }
     }
     debug_assert(all_done);
     return all_done;
 }
 
-bool SpriteManager::InitBlocksTexture()
+bool SpriteManager::InitObjectsSpritesheet(const PixelsArray& spritesheetPixels, const std::vector<TextureRegion>& spritesheetEntries)
+{
+    if (spritesheetEntries.empty())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Skip building objects atlas");
+        return true;
+    }
+
+    debug_assert(spritesheetPixels.mSizex == ObjectsTextureSizeX);
+    debug_assert(spritesheetPixels.mSizey == ObjectsTextureSizeY);
+
+    // reserve space for delta sprites atlas page
+    mObjectsSpritesheet.mSpritesheetTexture = gGraphicsDevice.CreateTexture2D(eTextureFormat_R8UI, ObjectsTextureSizeX, ObjectsTextureSizeY + DeltaAtlasPageSizeY, nullptr);
+    debug_assert(mObjectsSpritesheet.mSpritesheetTexture);
+
+    if (mObjectsSpritesheet.mSpritesheetTexture == nullptr)
+        return false;
+
+    mObjectsSpritesheet.mEntries = spritesheetEntries;
+
+    // upload to texture
+    if (!mObjectsSpritesheet.mSpritesheetTexture->Upload(0, 0, 0, ObjectsTextureSizeX, ObjectsTextureSizeY, spritesheetPixels.mData))
+    {
+        debug_assert(false);
+    }
+    return true;
+}
+
+bool SpriteManager::PrepareBlocksTexture(StyleData& styleData, PixelsArray& blocksPixels)
 {
-    StyleData& cityStyle = gGameMap.mStyleData;
     // count textures
-    const int totalTextures = cityStyle.GetBlockTexturesCount();
+    const int totalTextures = styleData.GetBlockTexturesCount();
     assert(totalTextures > 0);
     if (totalTextures == 0)
-    {
-        gConsole.LogMessage(eLogMessage_Warning, "Skip building blocks atlas");
         return true;
-    }
 
-    // allocate temporary bitmap
-    PixelsArray blockBitmap;
-    if (!blockBitmap.Create(eTextureFormat_R8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, gMemoryManager.mFrameHeapAllocator))
+    // frame heap is not used as it may be called outside of main thread
+    if (!blocksPixels.Create(eTextureFormat_R8, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS * totalTextures))
     {
         debug_assert(false);
         return false;
     }
 
-    mBlocksTextureArray = gGraphicsDevice.CreateTextureArray2D(eTextureFormat_R8UI, blockBitmap.mSizex, blockBitmap.mSizey, totalTextures, nullptr);
-    debug_assert(mBlocksTextureArray);
-    
-    int currentLayerIndex = 0;
-    for (int iblockType = 0; iblockType < eBlockType_COUNT; ++iblockType)
-    {
-        int numTextures = cityStyle.GetBlockTexturesCount((eBlockType) iblockType);
-        for (int itexture = 0; itexture < numTextures; ++itexture)
+    // layers are written concurrently
+    std::atomic<bool> writeFailed (false);
+    cxx::parallel_for(totalTextures, 64, [&styleData, &blocksPixels, &writeFailed](int firstLayer, int lastLayer)
         {
-            if (!cityStyle.GetBlockTexture((eBlockType) iblockType, itexture, &blockBitmap, 0, 0, 0))
+            for (int ilayer = firstLayer; ilayer < lastLayer; ++ilayer)
             {
-                gConsole.LogMessage(eLogMessage_Warning, "Cannot read block texture: %d %d", iblockType, itexture);
-                return false;
+                // map linear layer index to block type
+                int iblockType = eBlockType_Side;
+                int itexture = ilayer;
+                while (iblockType < eBlockType_Aux && itexture >= styleData.GetBlockTexturesCount((eBlockType) iblockType))
+                {
+                    itexture -= styleData.GetBlockTexturesCount((eBlockType) iblockType);
+                    ++iblockType;
+                }
+
+                if (!styleData.GetBlockTexture((eBlockType) iblockType, itexture, &blocksPixels, 0, ilayer * MAP_BLOCK_TEXTURE_DIMS, 0))
+                {
+                    gConsole.LogMessage(eLogMessage_Warning, "Cannot read block texture: %d %d", iblockType, itexture);
+                    writeFailed = true;
+                }
             }
+        });
+    return !writeFailed;
+}
 
-            // upload bitmap to gpu
-            if (!mBlocksTextureArray->Upload(currentLayerIndex, 1, blockBitmap.mData))
-            {
-                debug_assert(false);
-            }
-            
-            ++currentLayerIndex;
-        }
+bool SpriteManager::InitBlocksTexture(const PixelsArray& blocksPixels)
+{
+    // count textures
+    const int totalTextures = blocksPixels.mSizey / MAP_BLOCK_TEXTURE_DIMS;
+    if (totalTextures == 0)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Skip building blocks atlas");
+        return true;
     }
-    return true;
+
+    debug_assert(blocksPixels.mSizex == MAP_BLOCK_TEXTURE_DIMS);
+    debug_assert(totalTextures == gGameMap.mStyleData.GetBlockTexturesCount());
+
+    // layers are stored contiguously so whole array is uploaded at once
+    mBlocksTextureArray = gGraphicsDevice.CreateTextureArray2D(eTextureFormat_R8UI, MAP_BLOCK_TEXTURE_DIMS, MAP_BLOCK_TEXTURE_DIMS, totalTextures, blocksPixels.mData);
+    debug_assert(mBlocksTextureArray);
+    return mBlocksTextureArray != nullptr;
 }
 
 bool SpriteManager::InitBlocksIndicesTable()
@@ -284,12 +331,22 @@ void SpriteManager::RenderFrameBegin()
 
 void SpriteManager::RenderFrameEnd()
 {
-    if (mIndicesTableChanged)
+    if (!mDirtyBlocksIndices.empty())
     {
-        // upload indices table
-        debug_assert(mBlocksIndicesTable);
-        mIndicesTableChanged = false;
-        mBlocksIndicesTable->Upload(0, mBlocksIndices.size() * sizeof(unsigned short), mBlocksIndices.data());
+        UploadDirtyBlocksIndices();
+    }
+
+    // compact delta sprites when frame is done, cached regions will be requested by objects again on next frame
+    if (mDeltaAtlasDefragmentRequest)
+    {
+        mDeltaAtlasDefragmentRequest = false;
+        if (mDeltaSpritesAtlas.Defragment())
+        {
+            for (SpriteCacheElement& currElement: mSpritesCache)
+            {
+                UploadDeltaSprite(currElement);
+            }
+        }
     }
 }
 
@@ -325,7 +382,48 @@ void SpriteManager::UpdateBlocksAnimations(float deltaTime)
         if (!currAnim.UpdateFrame(deltaTime))
             continue;
         mBlocksIndices[currAnim.mBlockIndex] = currAnim.GetSpriteIndex(); // patch table
-        mIndicesTableChanged = true;
+        mDirtyBlocksIndices.push_back(currAnim.mBlockIndex);
+    }
+}
+
+void SpriteManager::UploadDirtyBlocksIndices()
+{
+    debug_assert(mBlocksIndicesTable);
+
+    std::sort(mDirtyBlocksIndices.begin(), mDirtyBlocksIndices.end());
+    mDirtyBlocksIndices.erase(std::unique(mDirtyBlocksIndices.begin(), mDirtyBlocksIndices.end()), mDirtyBlocksIndices.end());
+
+    // upload changed entries only, close ones are merged into single range to reduce number of calls;
+    // upload call costs much more than copying few extra bytes, with 64 entries gap busy styles make
+    // a quarter to a half less calls while uploaded bytes stay within tenth of whole table
+    const int MaxIndicesGap = mMergeBlocksIndicesUploads ? 64 : 0;
+
+    int rangeFirst = mDirtyBlocksIndices[0];
+    int rangeLast = rangeFirst;
+    for (int currIndex: mDirtyBlocksIndices)
+    {
+        if (currIndex - rangeLast > MaxIndicesGap)
+        {
+            UploadBlocksIndices(rangeFirst, rangeLast);
+            rangeFirst = currIndex;
+        }
+        rangeLast = currIndex;
+    }
+    UploadBlocksIndices(rangeFirst, rangeLast);
+
+    mDirtyBlocksIndices.clear();
+}
+
+void SpriteManager::UploadBlocksIndices(int firstIndex, int lastIndex)
+{
+    debug_assert(firstIndex <= lastIndex);
+    debug_assert(lastIndex < (int) mBlocksIndices.size());
+
+    int dataOffset = firstIndex * sizeof(unsigned short);
+    int dataLength = (lastIndex - firstIndex + 1) * sizeof(unsigned short);
+    if (!mBlocksIndicesTable->Upload(dataOffset, dataLength, &mBlocksIndices[firstIndex]))
+    {
+        debug_assert(false);
     }
 }
 
@@ -486,10 +584,10 @@ void SpriteManager::DumpSpriteDeltas(const std::string& outputLocation, int spri
 
 void SpriteManager::FlushSpritesCache()
 {
-    // move all textures to pool
+    // release atlas space
     for (SpriteCacheElement& currElement: mSpritesCache)
     {
-        mFreeSpriteTextures.push_back(currElement.mTexture);
+        mDeltaSpritesAtlas.Free(currElement.mAtlasHandle);
     }
 
     mSpritesCache.clear();
@@ -501,8 +599,8 @@ void SpriteManager::FlushSpritesCache(GameObjectID objectID)
     {
         if (icurrent->mObjectID == objectID)
         {
-            // move texture to pool
-            mFreeSpriteTextures.push_back(icurrent->mTexture);
+            // release atlas space
+            mDeltaSpritesAtlas.Free(icurrent->mAtlasHandle);
 
             icurrent = mSpritesCache.erase(icurrent);
             continue;
@@ -511,13 +609,91 @@ void SpriteManager::FlushSpritesCache(GameObjectID objectID)
     }
 }
 
-void SpriteManager::DestroySpriteTextures()
+void SpriteManager::InitDeltaSpritesAtlas()
 {
-    for (GpuTexture2D* currTexture: mFreeSpriteTextures)
+    mDeltaSpritesAtlas.Setup(Point(DeltaAtlasPageSizeX, DeltaAtlasPageSizeY), SpritesSpacing);
+    mDeltaSpritesAtlas.AddPage();
+    mDeltaAtlasPages.push_back(mObjectsSpritesheet.mSpritesheetTexture);
+}
+
+void SpriteManager::DestroyDeltaSpritesAtlas()
+{
+    // first page is owned by objects spritesheet
+    for (int ipage = 1, NumPages = (int) mDeltaAtlasPages.size(); ipage < NumPages; ++ipage)
+    {
+        gGraphicsDevice.DestroyTexture(mDeltaAtlasPages[ipage]);
+    }
+    mDeltaAtlasPages.clear();
+    mDeltaSpritesAtlas.Clear();
+    mDeltaAtlasDefragmentRequest = false;
+}
+
+int SpriteManager::AllocateDeltaSprite(const Point& dimensions)
+{
+    int atlasHandle = mDeltaSpritesAtlas.Allocate(dimensions);
+    if (atlasHandle != SpriteAtlasAllocator::InvalidHandle)
+        return atlasHandle;
+
+    // pages are fragmented, sprites could be repacked at the end of frame
+    if (mDeltaSpritesAtlas.GetOccupancy() < DeltaAtlasDefragmentOccupancy)
+    {
+        mDeltaAtlasDefragmentRequest = true;
+    }
+
+    if (mDeltaSpritesAtlas.GetPagesCount() < DeltaAtlasMaxPages)
+    {
+        GpuTexture2D* pageTexture = gGraphicsDevice.CreateTexture2D(eTextureFormat_R8UI, DeltaAtlasPageSizeX, DeltaAtlasPageSizeY, nullptr);
+        if (pageTexture)
+        {
+            mDeltaAtlasPages.push_back(pageTexture);
+            mDeltaSpritesAtlas.AddPage();
+
+            atlasHandle = mDeltaSpritesAtlas.Allocate(dimensions);
+        }
+        debug_assert(pageTexture);
+    }
+    return atlasHandle;
+}
+
+void SpriteManager::UploadDeltaSprite(SpriteCacheElement& cacheElement)
+{
+    const SpriteAtlasAllocator::AtlasEntry& atlasEntry = mDeltaSpritesAtlas.GetEntry(cacheElement.mAtlasHandle);
+
+    GpuTexture2D* pageTexture = mDeltaAtlasPages[atlasEntry.mPageIndex];
+    debug_assert(pageTexture);
+
+    Rect srcRect = atlasEntry.mRectangle;
+    if (atlasEntry.mPageIndex == 0)
+    {
+        srcRect.y += ObjectsTextureSizeY;
+    }
+
+    cacheElement.mTexture = pageTexture;
+    cacheElement.mTextureRegion.SetRegion(srcRect, pageTexture->mSize);
+
+    // keep rows 4 bytes aligned for upload, extra columns are within spacing
+    int alignedSizex = (int) cxx::align_up(srcRect.w, 4);
+    debug_assert(alignedSizex - srcRect.w <= SpritesSpacing);
+
+    PixelsArray pixels;
+    if (!pixels.Create(eTextureFormat_R8UI, alignedSizex, srcRect.h, gMemoryManager.mFrameHeapAllocator))
+    {
+        debug_assert(false);
+        return;
+    }
+
+    pixels.FillWithColor(0);
+
+    // combine soruce image with deltas
+    if (!gGameMap.mStyleData.GetSpriteTexture(cacheElement.mSpriteIndex, cacheElement.mSpriteDeltaBits, &pixels, 0, 0))
+    {
+        debug_assert(false);
+    }
+
+    if (!pageTexture->Upload(0, srcRect.x, srcRect.y, alignedSizex, srcRect.h, pixels.mData))
     {
-        gGraphicsDevice.DestroyTexture(currTexture);
+        debug_assert(false);
     }
-    mFreeSpriteTextures.clear();
 }
 
 void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int remap, SpriteDeltaBits deltaBits, Sprite2D& sourceSprite)
@@ -558,69 +734,34 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
             currElement.mSpriteDeltaBits = deltaBits;
 
             // upload changes
-            PixelsArray pixels;
-            if (!pixels.Create(currElement.mTexture->mFormat, 
-                currElement.mTexture->mSize.x, 
-                currElement.mTexture->mSize.y, gMemoryManager.mFrameHeapAllocator))
-            {
-                debug_assert(false);
-            }
-
-            if (!gGameMap.mStyleData.GetSpriteTexture(spriteIndex, deltaBits, &pixels, 0, 0))
-            {
-                debug_assert(false);
-            }
+            UploadDeltaSprite(currElement);
             sourceSprite.mTextureRegion = currElement.mTextureRegion;
             sourceSprite.mTexture = currElement.mTexture;
-            sourceSprite.mTexture->Upload(pixels.mData);
             return;
         }
     }
     
     // cache miss
-    Point dimensions;
-    dimensions.x = cxx::get_next_pot(spriteStyle.mWidth);
-    dimensions.y = cxx::get_next_pot(spriteStyle.mHeight);
-
-    sourceSprite.mTexture = GetFreeSpriteTexture(dimensions, eTextureFormat_R8UI);
-    if (sourceSprite.mTexture == nullptr)
+    int atlasHandle = AllocateDeltaSprite(Point(spriteStyle.mWidth, spriteStyle.mHeight));
+    if (atlasHandle == SpriteAtlasAllocator::InvalidHandle)
     {
-        debug_assert(false);
-    }
+        gConsole.LogMessage(eLogMessage_Debug, "Delta sprites atlas is out of space");
 
-    PixelsArray pixels;
-    if (!pixels.Create(eTextureFormat_R8UI, dimensions.x, dimensions.y, 
-        gMemoryManager.mFrameHeapAllocator))
-    {
-        debug_assert(false);
-    }
-
-    pixels.FillWithCheckerBoard();
-
-    // combine soruce image with deltas
-    if (!gGameMap.mStyleData.GetSpriteTexture(spriteIndex, deltaBits, &pixels, 0, 0))
-    {
-        debug_assert(false);
+        // draw sprite with no deltas instead
+        GetSpriteTexture(objectID, spriteIndex, remap, sourceSprite);
+        return;
     }
 
-    // upload to texture
-    sourceSprite.mTexture->Upload(pixels.mData);
-
-    Rect srcRect;
-    srcRect.x = 0;
-    srcRect.y = 0;
-    srcRect.w = spriteStyle.mWidth;
-    srcRect.h = spriteStyle.mHeight;
-
-    sourceSprite.mTextureRegion.SetRegion(srcRect, dimensions);
-
     // add to sprites cache
     SpriteCacheElement spriteCacheElement;
     spriteCacheElement.mObjectID = objectID;
     spriteCacheElement.mSpriteIndex = spriteIndex;
     spriteCacheElement.mSpriteDeltaBits = deltaBits;
-    spriteCacheElement.mTexture = sourceSprite.mTexture;
-    spriteCacheElement.mTextureRegion = sourceSprite.mTextureRegion;
+    spriteCacheElement.mAtlasHandle = atlasHandle;
+
+    UploadDeltaSprite(spriteCacheElement);
+    sourceSprite.mTexture = spriteCacheElement.mTexture;
+    sourceSprite.mTextureRegion = spriteCacheElement.mTextureRegion;
 
     mSpritesCache.push_back(spriteCacheElement);
 }
@@ -637,23 +778,6 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
     sourceSprite.mTextureRegion = mObjectsSpritesheet.mEntries[spriteIndex];
 }
 
-GpuTexture2D* SpriteManager::GetFreeSpriteTexture(const Point& dimensions, eTextureFormat format)
-{
-    for (auto icurr = mFreeSpriteTextures.begin(); icurr != mFreeSpriteTextures.end(); )
-    {
-        GpuTexture2D* currTexture = *icurr;
-        if (currTexture->mSize == dimensions && currTexture->mFormat == format)
-        {
-            mFreeSpriteTextures.erase(icurr);
-            return currTexture;
-        }
-        ++icurr;
-    }
-
-    GpuTexture2D* texture = gGraphicsDevice.CreateTexture2D(format, dimensions.x, dimensions.y, nullptr);
-    return texture;
-}
-
 void SpriteManager::InitExplosionFrames()
 {
     StyleData& cityStyle = gGameMap.mStyleData;
@@ -2,6 +2,9 @@
 
 #include "GameDefs.h"
 #include "Sprite2D.h"
+#include "SpriteAtlasAllocator.h"
+
+class StyleData;
 
 // This class implements caching mechanism for graphic resources
 
@@ -12,6 +15,7 @@ class SpriteManager final: public cxx::noncopyable
 public:
     // animating blocks texture indices table
     GpuBufferTexture* mBlocksIndicesTable = nullptr;
+    bool mMergeBlocksIndicesUploads = true; // close changed entries are uploaded as single range
 
     GpuTexture2D* mPalettesTable = nullptr;
     GpuBufferTexture* mPaletteIndicesTable = nullptr; // index of palette in global palettes table
@@ -22,9 +26,27 @@ public:
     // all default objects bitmaps (with no deltas applied) are stored in single 2d texture
     Spritesheet mObjectsSpritesheet;
 
+    // all objects bitmaps with deltas applied are packed into dynamic atlas,
+    // its first page is located within objects spritesheet texture so such sprites does not break batches
+    SpriteAtlasAllocator mDeltaSpritesAtlas; // readonly
+
 public:
+    // Pack default objects bitmaps into single picture, does not access gpu so it could be called from worker thread
+    // @param styleData: Source style data
+    // @param spritesheetPixels: Output picture
+    // @param spritesheetEntries: Output sprites locations within spritesheet texture
+    static bool PrepareObjectsSpritesheet(StyleData& styleData, PixelsArray& spritesheetPixels, std::vector<TextureRegion>& spritesheetEntries);
+
+    // Decode all block textures into single picture with layers placed one after another vertically,
+    // does not access gpu so it could be called from worker thread
+    // @param styleData: Source style data
+    // @param blocksPixels: Output picture
+    static bool PrepareBlocksTexture(StyleData& styleData, PixelsArray& blocksPixels);
+
     // preload sprite textures for current level
-    bool InitLevelSprites();
+    // @param blocksPixels: Prepared block textures
+    // @param spritesheetPixels, spritesheetEntries: Prepared objects spritesheet
+    bool InitLevelSprites(const PixelsArray& blocksPixels, const PixelsArray& spritesheetPixels, const std::vector<TextureRegion>& spritesheetEntries);
 
     // flush all currently cached sprites
     void Cleanup();
@@ -64,17 +86,29 @@ public:
 
 private:
     bool InitBlocksIndicesTable();
-    bool InitBlocksTexture();
-    bool InitObjectsSpritesheet();
+    bool InitBlocksTexture(const PixelsArray& blocksPixels);
+    bool InitObjectsSpritesheet(const PixelsArray& spritesheetPixels, const std::vector<TextureRegion>& spritesheetEntries);
     void InitPalettesTable();
     void InitBlocksAnimations();
 
+    // Upload changed entries of blocks indices table
+    void UploadDirtyBlocksIndices();
+    void UploadBlocksIndices(int firstIndex, int lastIndex);
+
     void InitExplosionFrames();
     void FreeExplosionFrames();
 
-    // find texture with required size and format or create new if nothing found
-    GpuTexture2D* GetFreeSpriteTexture(const Point& dimensions, eTextureFormat format);
-    void DestroySpriteTextures();
+    void InitDeltaSpritesAtlas();
+    void DestroyDeltaSpritesAtlas();
+
+    // Allocate space for delta sprite within atlas, new page is added if there is no space left
+    // @param dimensions: Sprite dimensions
+    // @returns atlas handle or invalid handle on failure
+    int AllocateDeltaSprite(const Point& dimensions);
+
+    // Combine sprite with deltas and write it to atlas page
+    struct SpriteCacheElement;
+    void UploadDeltaSprite(SpriteCacheElement& cacheElement);
 
 private:
     // animation state for blocks sharing specific texture
@@ -86,10 +120,7 @@ private:
 
     std::vector<BlockAnimation> mBlocksAnimations;
     std::vector<unsigned short> mBlocksIndices;
-    bool mIndicesTableChanged;
-
-    // usused sprite textures
-    std::vector<GpuTexture2D*> mFreeSpriteTextures;
+    std::vector<int> mDirtyBlocksIndices; // changed entries of indices table, not uploaded yet
 
     // explosion sprite is huge and it was originally split into four pieces, 
     // so it must be assembled in one piece again before use
@@ -103,10 +134,15 @@ private:
         GameObjectID mObjectID; // object identifier which this sprite belongs to
         int mSpriteIndex;
         SpriteDeltaBits mSpriteDeltaBits; // all deltas applied to this sprite
-        GpuTexture2D* mTexture;
+        GpuTexture2D* mTexture; // atlas page texture
         TextureRegion mTextureRegion;
+        int mAtlasHandle; // delta sprites atlas allocation
     };
     std::vector<SpriteCacheElement> mSpritesCache;
+
+    // delta sprites atlas page textures, first page is objects spritesheet texture
+    std::vector<GpuTexture2D*> mDeltaAtlasPages;
+    bool mDeltaAtlasDefragmentRequest = false;
 };
 
 extern SpriteManager gSpriteManager;
\ No newline at end of file
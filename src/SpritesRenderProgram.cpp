@@ -0,0 +1,40 @@
+#include "stdafx.h"
+#include "SpritesRenderProgram.h"
+#include "GpuProgram.h"
+
+SpritesRenderProgram::SpritesRenderProgram(const char* srcFileName)
+    : RenderProgram(srcFileName)
+{
+}
+
+void SpritesRenderProgram::InitUniformParameters()
+{
+    mGeometryMode = eSpritesGeometryMode_Vertices;
+    if (!mGpuProgram->QueryUniformLocation("sprites_mode", mGeometryModeLocation))
+    {
+        mGeometryModeLocation = GpuVariableNULL;
+        return;
+    }
+    mGpuProgram->SetCustomUniform(mGeometryModeLocation, (int) mGeometryMode);
+}
+
+void SpritesRenderProgram::SetGeometryMode(eSpritesGeometryMode geometryMode)
+{
+    if (mGeometryMode == geometryMode)
+        return;
+
+    if (mGeometryModeLocation == GpuVariableNULL)
+    {
+        debug_assert(geometryMode == eSpritesGeometryMode_Vertices);
+        return;
+    }
+
+    mGeometryMode = geometryMode;
+    mGpuProgram->SetCustomUniform(mGeometryModeLocation, (int) mGeometryMode);
+}
+
+bool SpritesRenderProgram::IsInstancingSupported() const
+{
+    return IsProgramInited() && (mGeometryModeLocation != GpuVariableNULL) && 
+        gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_InstancedArrays];
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "RenderProgram.h"
+
+// how sprites geometry is fetched by render program
+enum eSpritesGeometryMode
+{
+    eSpritesGeometryMode_Vertices, // quads are expanded on cpu
+    eSpritesGeometryMode_InstancesDepthY, // quads are generated from per instance data, height is along y axis
+    eSpritesGeometryMode_InstancesDepthZ, // quads are generated from per instance data, height is along z axis
+};
+
+// defines render program for sprites
+class SpritesRenderProgram: public RenderProgram
+{
+public:
+    // @param srcFileName: File name of shader source, should be static string
+    SpritesRenderProgram(const char* srcFileName);
+
+    // Set sprites geometry source
+    // @param geometryMode: Mode
+    void SetGeometryMode(eSpritesGeometryMode geometryMode);
+
+    // Test whether sprites could be drawn from per instance data
+    bool IsInstancingSupported() const;
+
+protected:
+    void InitUniformParameters() override;
+
+private:
+    GpuVariableLocation mGeometryModeLocation = GpuVariableNULL;
+    eSpritesGeometryMode mGeometryMode = eSpritesGeometryMode_Vertices;
+};
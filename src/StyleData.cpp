@@ -1,6 +1,138 @@
 #include "stdafx.h"
 #include "StyleData.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define STYLE_BLIT_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define STYLE_BLIT_NEON
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+// copy palette colors, first entry is transparent key
+inline void MakeKeyedPalette(const Palette256& palette, Color32* keyedColors)
+{
+    for (int icolor = 0; icolor < CountOf(palette.mColors); ++icolor)
+    {
+        keyedColors[icolor] = palette.mColors[icolor];
+        keyedColors[icolor].mA = (icolor == 0) ? 0x00 : 0xFF;
+    }
+}
+
+// convert row of palette indices to destination format
+// @param srcIndices: Source palette indices
+// @param pixelsCount: Number of pixels in row
+// @param keyedColors: Palette colors, not used for indexed destination
+// @param bpp: Destination bytes per pixel, 1, 3 or 4
+// @param destPixels: Destination row
+inline void BlitPaletteRow(const unsigned char* srcIndices, int pixelsCount, const Color32* keyedColors, int bpp, unsigned char* destPixels)
+{
+    if (bpp == 1) // color index in palette
+    {
+        ::memcpy(destPixels, srcIndices, pixelsCount);
+        return;
+    }
+
+    // palette lookup is a gather which neither sse2 nor neon provide, so colors are fetched one by one
+    // and kernels handle packing and wide stores, remaining pixels go through scalar code
+    int ipixel = 0;
+
+#if defined(STYLE_BLIT_SSE2)
+    if (bpp == 4)
+    {
+        for (; ipixel + 4 <= pixelsCount; ipixel += 4)
+        {
+            const unsigned char* indices = srcIndices + ipixel;
+            __m128i colors = _mm_setr_epi32(keyedColors[indices[0]].mRGBA, keyedColors[indices[1]].mRGBA, 
+                keyedColors[indices[2]].mRGBA, keyedColors[indices[3]].mRGBA);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destPixels + ipixel * 4), colors);
+        }
+    }
+    else
+    {
+        // drop alpha bytes: pack pairs of pixels into 6 bytes within each 64 bit lane, then join lanes
+        const __m128i lowPixelMask = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+        const __m128i highPixelMask = _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0);
+        const __m128i lowLaneMask = _mm_set_epi32(0, 0, 0x0000FFFF, -1);
+        for (; ipixel + 4 <= pixelsCount; ipixel += 4)
+        {
+            const unsigned char* indices = srcIndices + ipixel;
+            __m128i colors = _mm_setr_epi32(keyedColors[indices[0]].mRGBA, keyedColors[indices[1]].mRGBA, 
+                keyedColors[indices[2]].mRGBA, keyedColors[indices[3]].mRGBA);
+            __m128i lanes = _mm_or_si128(_mm_and_si128(colors, lowPixelMask), 
+                _mm_srli_epi64(_mm_and_si128(colors, highPixelMask), 8));
+            __m128i packed = _mm_or_si128(_mm_and_si128(lanes, lowLaneMask), 
+                _mm_slli_si128(_mm_srli_si128(lanes, 8), 6));
+            // 12 bytes are stored, whole register store could run past end of destination
+            unsigned char* dest = destPixels + ipixel * 3;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), packed);
+            int lastBytes = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+            ::memcpy(dest + 8, &lastBytes, sizeof(lastBytes));
+        }
+    }
+#elif defined(STYLE_BLIT_NEON)
+    // fetch 16 colors to temporary storage, load with deinterleave to channels for rgb destination
+    Color32 colors[16];
+    for (; ipixel + 16 <= pixelsCount; ipixel += 16)
+    {
+        for (int icolor = 0; icolor < 16; ++icolor)
+        {
+            colors[icolor] = keyedColors[srcIndices[ipixel + icolor]];
+        }
+        const uint8_t* colorBytes = reinterpret_cast<const uint8_t*>(colors);
+        if (bpp == 4)
+        {
+            vst1q_u8(destPixels + ipixel * 4 + 0, vld1q_u8(colorBytes + 0));
+            vst1q_u8(destPixels + ipixel * 4 + 16, vld1q_u8(colorBytes + 16));
+            vst1q_u8(destPixels + ipixel * 4 + 32, vld1q_u8(colorBytes + 32));
+            vst1q_u8(destPixels + ipixel * 4 + 48, vld1q_u8(colorBytes + 48));
+        }
+        else
+        {
+            uint8x16x4_t channels = vld4q_u8(colorBytes);
+            uint8x16x3_t rgb;
+            rgb.val[0] = channels.val[0];
+            rgb.val[1] = channels.val[1];
+            rgb.val[2] = channels.val[2];
+            vst3q_u8(destPixels + ipixel * 3, rgb);
+        }
+    }
+#endif
+
+    if (bpp == 4)
+    {
+        // write whole 32 bit colors, four pixels per iteration
+        for (; ipixel + 4 <= pixelsCount; ipixel += 4)
+        {
+            const Color32 colors[4] = {
+                keyedColors[srcIndices[ipixel + 0]],
+                keyedColors[srcIndices[ipixel + 1]],
+                keyedColors[srcIndices[ipixel + 2]],
+                keyedColors[srcIndices[ipixel + 3]],
+            };
+            ::memcpy(destPixels + ipixel * 4, colors, sizeof(colors));
+        }
+        for (; ipixel < pixelsCount; ++ipixel)
+        {
+            ::memcpy(destPixels + ipixel * 4, &keyedColors[srcIndices[ipixel]], sizeof(Color32));
+        }
+        return;
+    }
+
+    // rgb color
+    destPixels += ipixel * 3;
+    for (; ipixel < pixelsCount; ++ipixel)
+    {
+        const Color32& color = keyedColors[srcIndices[ipixel]];
+        destPixels[0] = color.mR;
+        destPixels[1] = color.mG;
+        destPixels[2] = color.mB;
+        destPixels += 3;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 // read distance in map units and convert it to meters
@@ -384,32 +516,20 @@ bool StyleData::GetBlockTexture(eBlockType blockType, int blockIndex, PixelsArra
     int bpp = NumBytesPerPixel(bitmap->mFormat);
     debug_assert(bpp == 3 || bpp == 4 || bpp == 1);
 
-    int palindex = GetBlockTexturePaletteIndex(blockType, blockIndex, remap);
+    Color32 keyedColors[256];
+    if (bpp > 1)
+    {
+        int palindex = GetBlockTexturePaletteIndex(blockType, blockIndex, remap);
+        MakeKeyedPalette(mPalettes[palindex], keyedColors);
+    }
 
+    const int destPitch = bitmap->mSizex * bpp;
+    unsigned char* destPixels = bitmap->mData + (destPositionY * bitmap->mSizex + destPositionX) * bpp;
     for (int iy = 0; iy < MAP_BLOCK_TEXTURE_DIMS; ++iy)
     {
-        for (int ix = 0; ix < MAP_BLOCK_TEXTURE_DIMS; ++ix)
-        {
-            int destOffset = (((destPositionY + iy) * bitmap->mSizex) + (ix + destPositionX)) * bpp;
-            unsigned char palentry = srcPixels[ix];
-
-            if (bpp == 1) // color index in palette
-            {
-                bitmap->mData[destOffset + 0] = palentry;
-            }
-            else // rgb(a) color
-            {
-                const Color32& color = mPalettes[palindex].mColors[palentry];
-                bitmap->mData[destOffset + 0] = color.mR;
-                bitmap->mData[destOffset + 1] = color.mG;
-                bitmap->mData[destOffset + 2] = color.mB;
-                if (bpp == 4)
-                {
-                    bitmap->mData[destOffset + 3] = (palentry == 0) ? 0x00 : 0xFF;
-                }
-            }
-        }
+        BlitPaletteRow(srcPixels, MAP_BLOCK_TEXTURE_DIMS, keyedColors, bpp, destPixels);
         srcPixels += 4 * MAP_BLOCK_TEXTURE_DIMS;
+        destPixels += destPitch;
     }
     return true;
 }
@@ -455,35 +575,28 @@ bool StyleData::GetSpriteTexture(int spriteIndex, PixelsArray* bitmap, int destP
     debug_assert(bitmap->mSizex >= destPositionX + sprite.mWidth);
     debug_assert(bitmap->mSizey >= destPositionY + sprite.mHeight);
 
-    for (int iy = 0; iy < sprite.mHeight; ++iy)
-    for (int ix = 0; ix < sprite.mWidth; ++ix)
+    Color32 keyedColors[256];
+    if (bpp > 1)
     {
-        int destOffset = (((destPositionY + iy) * bitmap->mSizex) + (ix + destPositionX)) * bpp;
-        int srcOffset = ((sprite.mPageOffsetY + iy) * GTA_SPRITE_PAGE_DIMS + (ix + sprite.mPageOffsetX));
         int palindex = mPaletteIndices[sprite.mClut + mTileClutsCount];
-        int palentry = srcPixels[srcOffset];
-        if (bpp == 1) // color index in palette
-        {
-            bitmap->mData[destOffset + 0] = palentry;
-        }
-        else
-        {
-            const Color32& color = mPalettes[palindex].mColors[palentry];
-            bitmap->mData[destOffset + 0] = color.mR;
-            bitmap->mData[destOffset + 1] = color.mG;
-            bitmap->mData[destOffset + 2] = color.mB;
-            if (bpp == 4)
-            {
-                bitmap->mData[destOffset + 3] = (palentry == 0) ? 0x00 : 0xFF;
-            }
-        }
+        MakeKeyedPalette(mPalettes[palindex], keyedColors);
+    }
+
+    const int destPitch = bitmap->mSizex * bpp;
+    unsigned char* destPixels = bitmap->mData + (destPositionY * bitmap->mSizex + destPositionX) * bpp;
+    srcPixels += sprite.mPageOffsetY * GTA_SPRITE_PAGE_DIMS + sprite.mPageOffsetX;
+    for (int iy = 0; iy < sprite.mHeight; ++iy)
+    {
+        BlitPaletteRow(srcPixels, sprite.mWidth, keyedColors, bpp, destPixels);
+        srcPixels += GTA_SPRITE_PAGE_DIMS;
+        destPixels += destPitch;
     }
     return true;
 }
 
 bool StyleData::GetSpriteTexture(int spriteIndex, SpriteDeltaBits deltas, PixelsArray* bitmap, int destPositionX, int destPositionY)
 {
-    if (!GetSpriteTexture(spriteIndex, bitmap, destPositionY, destPositionY))
+    if (!GetSpriteTexture(spriteIndex, bitmap, destPositionX, destPositionY))
         return false;
 
     SpriteInfo& sprite = mSprites[spriteIndex];
@@ -507,6 +620,13 @@ void StyleData::ApplySpriteDelta(SpriteInfo& sprite, SpriteInfo::DeltaInfo& spri
     int bpp = NumBytesPerPixel(bitmap->mFormat);
     debug_assert(bpp == 3 || bpp == 4 || bpp == 1);
 
+    Color32 keyedColors[256];
+    if (bpp > 1)
+    {
+        int palindex = mPaletteIndices[sprite.mClut + mTileClutsCount];
+        MakeKeyedPalette(mPalettes[palindex], keyedColors);
+    }
+
     const int HeaderSize = 3;
     unsigned int dstPixelOffset = 0;
 
@@ -525,32 +645,14 @@ void StyleData::ApplySpriteDelta(SpriteInfo& sprite, SpriteInfo::DeltaInfo& spri
         dstPixelOffset += destination_offset;
         int pagex = dstPixelOffset % GTA_SPRITE_PAGE_DIMS;
         int pagey = dstPixelOffset / GTA_SPRITE_PAGE_DIMS;
-        debug_assert(pagex < bitmap->mSizex);
-        debug_assert(pagey < bitmap->mSizey);
-        debug_assert(pagex + source_length <= bitmap->mSizex);
-        
-        int palindex = mPaletteIndices[sprite.mClut + mTileClutsCount];
-        for (int ipixel = 0; ipixel < source_length; ++ipixel)
-        {
-            int curr_pixel_offset = (pagey * bitmap->mSizex * bpp) + pagex * bpp;
-            int palentry = srcData[curr_pos + ipixel];
-            if (bpp == 1) // color index in palette
-            {
-                bitmap->mData[curr_pixel_offset + 0] = palentry;
-            }
-            else
-            {
-                const Color32& color = mPalettes[palindex].mColors[palentry];
-                bitmap->mData[curr_pixel_offset + 0] = color.mR;
-                bitmap->mData[curr_pixel_offset + 1] = color.mG;
-                bitmap->mData[curr_pixel_offset + 2] = color.mB;
-                if (bpp == 4)
-                {
-                    bitmap->mData[curr_pixel_offset + 3] = (palentry == 0) ? 0x00 : 0xFF;
-                }
-            }
-            ++pagex;
-        }
+        debug_assert(positionX + pagex < bitmap->mSizex);
+        debug_assert(positionY + pagey < bitmap->mSizey);
+        debug_assert(positionX + pagex + source_length <= bitmap->mSizex);
+
+        // each chunk is continuous run of pixels within single row
+        unsigned char* destPixels = bitmap->mData + ((positionY + pagey) * bitmap->mSizex + (positionX + pagex)) * bpp;
+        BlitPaletteRow(srcData + curr_pos, source_length, keyedColors, bpp, destPixels);
+
         dstPixelOffset += source_length;
         curr_pos += source_length;
     }
@@ -31,6 +31,8 @@ void SystemConfig::SetToDefaults()
     mShowImguiDemoWindow = false;
     mEnableVSync = false;
     mFullscreen = false;
+    mOffscreen = false;
+    mGraphicsContextApi = eGraphicsContextApi_Native;
     mScreenSizex = DefaultScreenResolutionX;
     mScreenSizey = DefaultScreenResolutionY;
     mPhysicsFramerate = DefaultPhysicsFramerate;
@@ -50,6 +52,13 @@ void SystemConfig::InitFromJsonDocument(const cxx::json_document& sourceDocument
 
         cxx::json_get_attribute(screenConfig, "fullscreen", mFullscreen);
         cxx::json_get_attribute(screenConfig, "vsync", mEnableVSync);
+        cxx::json_get_attribute(screenConfig, "offscreen", mOffscreen);
+
+        std::string contextApi;
+        if (cxx::json_get_attribute(screenConfig, "context_api", contextApi) && !cxx::parse_enum(contextApi.c_str(), mGraphicsContextApi))
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Unknown context api '%s'", contextApi.c_str());
+        }
     }
 
     // memory
@@ -96,6 +105,36 @@ bool SystemStartupParams::ParseStartupParams(int argc, char *argv[])
             iarg += 2;
             continue;
         }
+        if (cxx_stricmp(argv[iarg], "-snapshot") == 0 && (argc > iarg + 1))
+        {
+            mSnapshotFile.assign(argv[iarg + 1]);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-renderbenchmark") == 0 && (argc > iarg + 1))
+        {
+            ::sscanf(argv[iarg + 1], "%d", &mRenderBenchmarkFrames);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-offscreen") == 0)
+        {
+            mOffscreen = true;
+            iarg += 1;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-serialload") == 0)
+        {
+            mSerialMapLoading = true;
+            iarg += 1;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-serialrender") == 0)
+        {
+            mSerialRendering = true;
+            iarg += 1;
+            continue;
+        }
         if (cxx_stricmp(argv[iarg], "-numplayers") == 0 && (argc > iarg + 1))
         {
             ::sscanf(argv[iarg + 1], "%d", &mPlayersCount);
@@ -112,7 +151,12 @@ void SystemStartupParams::ClearParams()
 {
     mDebugMapName.clear();
     mGtaDataLocation.clear();
+    mSnapshotFile.clear();
+    mRenderBenchmarkFrames = 0;
+    mOffscreen = false;
     mPlayersCount = 0;
+    mSerialMapLoading = false;
+    mSerialRendering = false;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -142,6 +186,11 @@ void System::Initialize(int argc, char *argv[])
 
     LoadConfiguration();
 
+    if (mStartupParams.mOffscreen)
+    {
+        mConfig.mOffscreen = true;
+    }
+
     if (!gFiles.SetupGtaDataLocation())
     {
         gConsole.LogMessage(eLogMessage_Error, "Set valid gta gamedata location via sys config param 'gta_gamedata_location'");
@@ -195,14 +244,15 @@ void System::Initialize(int argc, char *argv[])
         Terminate();
     }
 
+    // game time could be restored from snapshot on game start
+    gTimeManager.Initialize();
+
     if (!gCarnageGame.Initialize())
     {
         gConsole.LogMessage(eLogMessage_Error, "Cannot initialize game");
         Terminate();
     }
 
-    gTimeManager.Initialize();
-
     mQuitRequested = false;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GraphicsDefs.h"
+
 // defines system configuration
 class SystemConfig
 {
@@ -17,6 +19,8 @@ public:
     int mScreenSizex, mScreenSizey; // screen dimensions
     bool mFullscreen; // enable full screen mode
     bool mEnableVSync; // enable vertical synchronization
+    bool mOffscreen; // render into hidden window, for benchmarks on headless machines
+    eGraphicsContextApi mGraphicsContextApi; // opengl context backend
 
     // physics
     float mPhysicsFramerate;
@@ -46,7 +50,12 @@ public:
 public:
     std::string mDebugMapName; // startup map name
     std::string mGtaDataLocation; // force gta data location
+    std::string mSnapshotFile; // restore game state from snapshot on start
+    int mRenderBenchmarkFrames = 0; // run render benchmark on start and quit
+    bool mOffscreen = false; // force offscreen rendering
     int mPlayersCount = 0;
+    bool mSerialMapLoading = false; // disable concurrent map loading stages
+    bool mSerialRendering = false; // disable map sprites preparation on worker thread
 };
 
 //////////////////////////////////////////////////////////////////////////
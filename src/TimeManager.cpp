@@ -103,6 +103,13 @@ void TimeManager::SetGameTimeScale(float timeScale)
     mGameTimeScale = std::max(timeScale, 0.0f);
 }
 
+void TimeManager::SetGameTime(float gameTime)
+{
+    debug_assert(gameTime >= 0.0f);
+    mGameTime = std::max(gameTime, 0.0f);
+    mGameFrameDelta = 0.0f;
+}
+
 void TimeManager::SetUiTimeScale(float timeScale)
 {
     debug_assert(timeScale >= 0.0f);
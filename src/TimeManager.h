@@ -33,6 +33,10 @@ public:
     void SetGameTimeScale(float timeScale);
     void SetUiTimeScale(float timeScale);
 
+    // Force current game time, used when game state gets restored from snapshot
+    // @param gameTime: Game time, seconds
+    void SetGameTime(float gameTime);
+
 private:
     double mMaxFrameDelta = 0.0f;
     double mMinFrameDelta = 0.0f;
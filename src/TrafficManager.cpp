@@ -356,32 +356,20 @@ void TrafficManager::GenerateTrafficCars(int carsCount, RenderView& view)
         if (innerRect.PointWithin(pos))
             continue;
 
-        // scan candidate from top
-        for (int iz = (MAP_LAYERS_COUNT - 1); iz > 0; --iz)
-        {
-            const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(pos.x, pos.y, iz);
-
-            if (mapBlock->mGroundType == eGroundType_Air)
-                continue;
-
-            if (mapBlock->mGroundType == eGroundType_Road)
-            {
-                int bits = (int) (mapBlock->mDownDirection) + 
-                    (int) (mapBlock->mUpDirection) +
-                    (int) (mapBlock->mLeftDirection) + 
-                    (int) (mapBlock->mRightDirection);
+        // get topmost road lane
+        int segmentIndex = gGameMap.mRoadLanes.GetTopSegmentIndex(pos.x, pos.y);
+        if (segmentIndex == RoadLaneGraph::NullSegment)
+            continue;
 
-                if ((bits == 0 || bits > 1) || mapBlock->mIsRailway)
-                    continue;
+        const RoadLaneSegment& segment = gGameMap.mRoadLanes.mSegments[segmentIndex];
+        if (segment.IsCovered() || segment.IsJunction())
+            continue;
 
-                CandidatePos candidatePos;
-                candidatePos.mMapX = pos.x;
-                candidatePos.mMapY = pos.y;
-                candidatePos.mMapLayer = iz;
-                mCandidatePosArray.push_back(candidatePos);
-            }
-            break;
-        }
+        CandidatePos candidatePos;
+        candidatePos.mMapX = pos.x;
+        candidatePos.mMapY = pos.y;
+        candidatePos.mMapLayer = segment.mMapLayer;
+        mCandidatePosArray.push_back(candidatePos);
     }
 
     if (mCandidatePosArray.empty())
@@ -439,27 +427,22 @@ void TrafficManager::RemoveOffscreenCars()
 
 Vehicle* TrafficManager::GenerateRandomTrafficCar(int posx, int posy, int posz)
 {
-    const MapBlockInfo* mapBlock = gGameMap.GetBlockInfo(posx, posz, posy);
-  
     glm::vec3 positions(
         Convert::MapUnitsToMeters(posx + 0.5f),
         Convert::MapUnitsToMeters(posy * 1.0f),
         Convert::MapUnitsToMeters(posz + 0.5f)
     );
 
-    float turnAngle = 0.0f;
-    if (mapBlock->mUpDirection)
-    {
-        turnAngle = -90.0f;
-    }
-    else if (mapBlock->mDownDirection)
-    {
-        turnAngle = 90.0f;
-    }
-    else if (mapBlock->mLeftDirection)
-    {
-        turnAngle = 180.0f;
-    }
+    // choose heading along road lane, car is not spawned where it cannot follow lane
+    int segmentIndex = gGameMap.mRoadLanes.GetSegmentIndex(posx, posz, posy);
+    if (segmentIndex == RoadLaneGraph::NullSegment)
+        return nullptr;
+
+    eMapDirection spawnDirection;
+    if (!gGameMap.mRoadLanes.ChooseSpawnDirection(segmentIndex, gCarnageGame.mGameRand, spawnDirection))
+        return nullptr;
+
+    float turnAngle = GetHeadingFromMapDirection(spawnDirection);
 
     // generate car
     cxx::angle_t carHeading(turnAngle, cxx::angle_t::units::degrees);
@@ -11,6 +11,7 @@ class Vehicle final: public GameObject
 {
     friend class GameObjectsManager;
     friend class GameCheatsWindow;
+    friend class GameStateSnapshot;
 
 public:
     // public for convenience, should not be modified directly
@@ -111,4 +111,47 @@ public:
         this->SetAttribute(eVertexAttribute_Texcoord0, eVertexAttributeFormat_2F, offsetof(TVertexType, mTexcoord));
         this->SetAttribute(eVertexAttribute_Color0, eVertexAttributeFormat_1US, offsetof(TVertexType, mClutIndex));
     }
+};
+// defines per instance data of sprite, quad vertices are generated in vertex shader
+struct SpriteInstance3D
+{
+public:
+    SpriteInstance3D() = default;
+
+public:
+    glm::vec3 mPosition; // position on sprite plane and height, 12 bytes
+    glm::vec4 mOriginAndSize; // corner offset from position and size, 16 bytes
+    glm::vec4 mTexcoords; // u0, v0, u1, v1, 16 bytes
+    glm::vec2 mRotation; // cos and sin of rotation angle, 8 bytes
+    unsigned short mClutIndex; // 2 bytes
+};
+
+const unsigned int Sizeof_SpriteInstance3D = sizeof(SpriteInstance3D);
+
+// defines per instance data format of sprite
+struct SpriteInstance3D_Format: public VertexFormat
+{
+public:
+    SpriteInstance3D_Format()
+    {
+        Setup();
+    }
+    // get format definition
+    static const SpriteInstance3D_Format& Get() 
+    { 
+        static const SpriteInstance3D_Format sDefinition; 
+        return sDefinition; 
+    }
+    using TVertexType = SpriteInstance3D;
+    // initialzie definition
+    inline void Setup()
+    {
+        this->mDataStride = Sizeof_SpriteInstance3D;
+        this->mInstanceDivisor = 1;
+        this->SetAttribute(eVertexAttribute_Position0, eVertexAttributeFormat_3F, offsetof(TVertexType, mPosition));
+        this->SetAttribute(eVertexAttribute_Position1, eVertexAttributeFormat_4F, offsetof(TVertexType, mOriginAndSize));
+        this->SetAttribute(eVertexAttribute_Texcoord1, eVertexAttributeFormat_4F, offsetof(TVertexType, mTexcoords));
+        this->SetAttribute(eVertexAttribute_Normal0, eVertexAttributeFormat_2F, offsetof(TVertexType, mRotation));
+        this->SetAttribute(eVertexAttribute_Color0, eVertexAttributeFormat_1US, offsetof(TVertexType, mClutIndex));
+    }
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "GameObjectsManager.h"
 #include "PhysicsManager.h"
 #include "AudioManager.h"
+#include "BulletsManager.h"
 
 void Weapon::Setup(eWeaponID weaponID, int ammunition)
 {
@@ -75,8 +76,15 @@ bool Weapon::Fire(Pedestrian* shooter)
         }
 
         debug_assert(weaponInfo->mProjectileTypeID < eProjectileType_COUNT);
-        Projectile* projectile = gGameObjectsManager.CreateProjectile(projectilePos, shooter->mPhysicsBody->GetRotationAngle(), weaponInfo, shooter);
-        debug_assert(projectile);
+        if (weaponInfo->IsBulletDamage())
+        {
+            gBulletsManager.CreateBullet(projectilePos, shooter->mPhysicsBody->GetRotationAngle(), weaponInfo, shooter);
+        }
+        else
+        {
+            Projectile* projectile = gGameObjectsManager.CreateProjectile(projectilePos, shooter->mPhysicsBody->GetRotationAngle(), weaponInfo, shooter);
+            debug_assert(projectile);
+        }
 
         if (weaponInfo->mShotSound != -1)
         {
@@ -4,6 +4,8 @@
 #include "GraphicsDefs.h"
 #include "GameObject.h"
 #include "PedestrianInfo.h"
+#include "RenderStatistics.h"
+#include "MapLoader.h"
 
 impl_enum_strings(eKeycode)
 {
@@ -144,6 +146,31 @@ impl_enum_strings(eTextureWrapMode)
     {eTextureWrapMode_ClampToEdge, "clamp_to_edge"},
 };
 
+impl_enum_strings(eGraphicsContextApi)
+{
+    {eGraphicsContextApi_Native, "native"},
+    {eGraphicsContextApi_EGL, "egl"},
+    {eGraphicsContextApi_OSMesa, "osmesa"},
+};
+
+impl_enum_strings(eRenderPass)
+{
+    {eRenderPass_CityMesh, "city_mesh"},
+    {eRenderPass_Sprites, "sprites"},
+    {eRenderPass_Debug, "debug"},
+    {eRenderPass_Gui, "gui"},
+};
+
+impl_enum_strings(eMapLoadStage)
+{
+    {eMapLoadStage_MapData, "map_data"},
+    {eMapLoadStage_LevelSounds, "level_sounds"},
+    {eMapLoadStage_CityMesh, "city_mesh"},
+    {eMapLoadStage_Spritesheet, "spritesheet"},
+    {eMapLoadStage_BlocksTexture, "blocks_texture"},
+    {eMapLoadStage_Collision, "collision"},
+};
+
 impl_enum_strings(eTextureFilterMode)
 {
     {eTextureFilterMode_Nearest, "nearest"},
@@ -203,6 +230,7 @@ impl_enum_strings(eVertexAttributeFormat)
 {
     {eVertexAttributeFormat_2F, "2f"},
     {eVertexAttributeFormat_3F, "3f"},
+    {eVertexAttributeFormat_4F, "4f"},
     {eVertexAttributeFormat_4UB, "4ub"},
     {eVertexAttributeFormat_1US, "1us"},
     {eVertexAttributeFormat_2US, "2us"},
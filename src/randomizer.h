@@ -64,6 +64,18 @@ namespace cxx
             return std::uniform_real_distribution<float>(minFloat, maxFloat)(mGeneratorEngine);
         }
 
+        // write or read generator internal state, restored generator continues same sequence of numbers
+        // @param outstream, instream: Text or binary stream
+        inline void save_state(std::ostream& outstream) const
+        {
+            outstream << mGeneratorEngine;
+        }
+
+        inline bool load_state(std::istream& instream)
+        {
+            return !!(instream >> mGeneratorEngine);
+        }
+
         // shuffle container elements
         template<typename TContainer>
         inline void shuffle(TContainer& container)
@@ -43,6 +43,7 @@
 #include <cctype>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <functional>
 
 // opengl
@@ -81,6 +82,7 @@
 #include "json_document.h"
 #include "mem_allocators.h"
 #include "iostream_utils.h"
+#include "worker_pool.h"
 
 #include "game_version.h"
 // app
@@ -87,8 +87,9 @@ const char* va(const char* format_string, ...)
 {
     va_list argptr;
 
-    static int scope_index = 0;
-    static char string_buffers[4][16384]; // in case called by nested functions
+    // buffers are per thread as files are opened by map loader threads
+    static thread_local int scope_index = 0;
+    static thread_local char string_buffers[4][16384]; // in case called by nested functions
 
     char *current_buffer = string_buffers[scope_index];
     scope_index = (scope_index + 1) & 3;
@@ -44,7 +44,7 @@ namespace cxx
         }
     };
 
-    // does a varargs printf into a temp buffer, not thread safe
+    // does a varargs printf into a temp buffer, buffers are per thread
     const char* va(const char *format_string, ...);
 
     // simple tokenizer for strings
@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#include "worker_pool.h"
+
+namespace cxx
+{
+
+worker_pool::worker_pool()
+    : mNextPart(0)
+{
+    int threadsCount = std::max((int) std::thread::hardware_concurrency(), 1);
+    mThreads.reserve(threadsCount - 1);
+    for (int ithread = 1; ithread < threadsCount; ++ithread)
+    {
+        mThreads.emplace_back(&worker_pool::worker_proc, this);
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock (mJobMutex);
+        mQuitRequest = true;
+    }
+    mJobStartCondition.notify_all();
+    for (std::thread& currThread: mThreads)
+    {
+        currThread.join();
+    }
+}
+
+worker_pool& worker_pool::get_instance()
+{
+    static worker_pool instance;
+    return instance;
+}
+
+void worker_pool::run(int partsCount, const process_part_proc& funcProcess)
+{
+    if (partsCount <= 0)
+        return;
+
+    // nested or concurrent jobs are not distributed
+    std::unique_lock<std::mutex> runLock (mRunMutex, std::try_to_lock);
+    if (!runLock.owns_lock() || mThreads.empty() || partsCount == 1)
+    {
+        for (int ipart = 0; ipart < partsCount; ++ipart)
+        {
+            funcProcess(ipart);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (mJobMutex);
+        mJobProcess = &funcProcess;
+        mPartsCount = partsCount;
+        mPartsDone = 0;
+        mNextPart = 0;
+        ++mJobIndex;
+    }
+    mJobStartCondition.notify_all();
+
+    process_parts(funcProcess, partsCount);
+
+    // job must not be released while helper threads refer to it
+    std::unique_lock<std::mutex> lock (mJobMutex);
+    mJobDoneCondition.wait(lock, [this]()
+        {
+            return mPartsDone == mPartsCount && mBusyWorkers == 0;
+        });
+    mJobProcess = nullptr;
+}
+
+void worker_pool::worker_proc()
+{
+    unsigned int lastJobIndex = 0;
+    for (;;)
+    {
+        const process_part_proc* funcProcess = nullptr;
+        int partsCount = 0;
+        {
+            std::unique_lock<std::mutex> lock (mJobMutex);
+            mJobStartCondition.wait(lock, [this, lastJobIndex]()
+                {
+                    return mQuitRequest || mJobIndex != lastJobIndex;
+                });
+
+            if (mQuitRequest)
+                break;
+
+            lastJobIndex = mJobIndex;
+            if (mJobProcess == nullptr) // already completed
+                continue;
+
+            funcProcess = mJobProcess;
+            partsCount = mPartsCount;
+            ++mBusyWorkers;
+        }
+
+        process_parts(*funcProcess, partsCount);
+
+        {
+            std::lock_guard<std::mutex> lock (mJobMutex);
+            --mBusyWorkers;
+        }
+        mJobDoneCondition.notify_one();
+    }
+}
+
+void worker_pool::process_parts(const process_part_proc& funcProcess, int partsCount)
+{
+    int partsDone = 0;
+    for (int ipart = mNextPart++; ipart < partsCount; ipart = mNextPart++)
+    {
+        funcProcess(ipart);
+        ++partsDone;
+    }
+
+    if (partsDone > 0)
+    {
+        std::lock_guard<std::mutex> lock (mJobMutex);
+        mPartsDone += partsDone;
+    }
+    mJobDoneCondition.notify_one();
+}
+
+} // namespace cxx
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+
+namespace cxx
+{
+    // implements fixed set of helper threads which is reused across jobs, 
+    // job is split into parts which are processed by helper threads and calling thread
+
+    class worker_pool final: public noncopyable
+    {
+    public:
+        using process_part_proc = std::function<void (int partIndex)>;
+
+        // Spawn helper threads, one less than hardware threads count
+        worker_pool();
+        ~worker_pool();
+
+        // get shared pool instance, it is created on first use
+        static worker_pool& get_instance();
+
+        // Process all parts of job, blocks until completion
+        // Job is processed serially on calling thread if pool is busy with another job
+        // @param partsCount: Number of parts
+        // @param funcProcess: Function to process single part
+        void run(int partsCount, const process_part_proc& funcProcess);
+
+        // get number of threads which process job parts including calling thread
+        inline int get_threads_count() const
+        {
+            return (int) mThreads.size() + 1;
+        }
+
+    private:
+        void worker_proc();
+        // process parts of current job until there are no unclaimed parts left
+        void process_parts(const process_part_proc& funcProcess, int partsCount);
+
+    private:
+        std::vector<std::thread> mThreads;
+        std::mutex mRunMutex; // held while job is in progress
+        std::mutex mJobMutex;
+        std::condition_variable mJobStartCondition;
+        std::condition_variable mJobDoneCondition;
+        // current job
+        const process_part_proc* mJobProcess = nullptr;
+        unsigned int mJobIndex = 0;
+        int mPartsCount = 0;
+        int mPartsDone = 0;
+        int mBusyWorkers = 0; // helper threads which refer to current job
+        std::atomic<int> mNextPart;
+        bool mQuitRequest = false;
+    };
+
+    // Split range of items into equal parts and process them on current and helper threads, blocks until completion
+    // @param itemsCount: Number of items
+    // @param minItemsPerThread: Do not use extra threads for small ranges
+    // @param funcProcess: Function with signature void(int firstItem, int lastItem), last item is exclusive
+    template<typename TFuncProcess>
+    inline void parallel_for(int itemsCount, int minItemsPerThread, TFuncProcess funcProcess)
+    {
+        if (itemsCount <= 0)
+            return;
+
+        minItemsPerThread = std::max(minItemsPerThread, 1);
+
+        int threadsCount = std::min((int) std::thread::hardware_concurrency(), (itemsCount + minItemsPerThread - 1) / minItemsPerThread);
+        if (threadsCount < 2)
+        {
+            funcProcess(0, itemsCount);
+            return;
+        }
+
+        worker_pool& workerPool = worker_pool::get_instance();
+        threadsCount = std::min(threadsCount, workerPool.get_threads_count());
+
+        int itemsPerThread = (itemsCount + threadsCount - 1) / threadsCount;
+        int partsCount = (itemsCount + itemsPerThread - 1) / itemsPerThread;
+        workerPool.run(partsCount, [&funcProcess, itemsPerThread, itemsCount](int partIndex)
+            {
+                int firstItem = partIndex * itemsPerThread;
+                funcProcess(firstItem, std::min(firstItem + itemsPerThread, itemsCount));
+            });
+    }
+
+} // namespace cxx